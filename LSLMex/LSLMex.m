@@ -163,11 +163,89 @@ classdef LSLMex < handle
             this.cppmethod('stopOutlet',ensureStringIsChar(stream));
         end
         
+        %% generic outlets
+        function id = createNumericOutlet(this,name,type,numChannels,format,nominalRate,sourceID)
+            % format is one of 'float', 'double', 'int8', 'int16',
+            % 'int32' or 'int64'. Optional nominal rate (default
+            % irregular) and source ID (default 'LSL_streamer:<name>')
+            if nargin<5
+                error('LSLMex::createNumericOutlet: provide name, type, number of channels and format arguments.');
+            end
+            if nargin<6
+                nominalRate = [];
+            end
+            if nargin<7
+                sourceID = [];
+            else
+                sourceID = ensureStringIsChar(sourceID);
+            end
+            id = this.cppmethod('createNumericOutlet',ensureStringIsChar(name),ensureStringIsChar(type),uint64(numChannels),ensureStringIsChar(format),nominalRate,sourceID);
+        end
+        function pushNumericChunk(this,id,data,timeStamps)
+            % data is a numChannels x numSamples single, double or
+            % integer matrix, its values are converted to the outlet's
+            % format if needed. Optional int64 timestamps
+            % (us, system clock) for each sample, else samples are
+            % stamped when pushed
+            if nargin<3
+                error('LSLMex::pushNumericChunk: provide id and data arguments.');
+            end
+            if nargin<4
+                timeStamps = [];
+            else
+                timeStamps = int64(timeStamps);
+            end
+            this.cppmethod('pushNumericChunk',uint32(id),data,timeStamps);
+        end
+        function id = createMarkerOutlet(this,name,type,sourceID)
+            % string marker outlet. Optional type (default 'Markers')
+            % and source ID (default 'LSL_streamer:<name>')
+            if nargin<2
+                error('LSLMex::createMarkerOutlet: provide name argument.');
+            end
+            if nargin<3
+                type = [];
+            else
+                type = ensureStringIsChar(type);
+            end
+            if nargin<4
+                sourceID = [];
+            else
+                sourceID = ensureStringIsChar(sourceID);
+            end
+            id = this.cppmethod('createMarkerOutlet',ensureStringIsChar(name),type,sourceID);
+        end
+        function timeStamp = pushMarker(this,id,marker,timeStamp)
+            % sends the marker immediately. Optional int64 timestamp (us,
+            % system clock, same as gaze data), else it is stamped with
+            % the current time. Returns the timestamp the marker was sent
+            % with
+            if nargin<3
+                error('LSLMex::pushMarker: provide id and marker arguments.');
+            end
+            if nargin<4
+                timeStamp = [];
+            else
+                timeStamp = int64(timeStamp);
+            end
+            timeStamp = this.cppmethod('pushMarker',uint32(id),ensureStringIsChar(marker),timeStamp);
+        end
+        function deleteOutlet(this,id)
+            this.cppmethod('deleteOutlet',uint32(id));
+        end
+        
         %% inlets
         function id = createInlet(this,streamSourceID,initialBufferSize,doStartListening)
             % optional buffer size input, and optional input to request
             % immediately starting listening on the inlet (so you do not
             % have to call startListening(id) yourself)
+            % Streams that are not LSL_streamer streams can be used if they
+            % have a numeric channel format. For these, consume and peek
+            % calls return a struct with fields remote_system_time_stamp,
+            % local_system_time_stamp and data, a channels x samples matrix
+            % of the stream's channel format. Single channel string streams
+            % (markers) are also accepted, for these the struct has a value
+            % field holding a cell array of the marker strings instead
             if nargin<2
                 error('LSLMex::createInlet: must provide an LSL stream source identifier string.');
             end
@@ -272,6 +350,64 @@ classdef LSLMex < handle
                 data = this.cppmethod('peekTimeRange',id);
             end
         end
+        function bundle = consumeTimeRangeMulti(this,ids,startT,endT,toWatermark)
+            % consume a time range of multiple inlets at once, as a
+            % consistent snapshot. Optional inputs startT and endT
+            % (default: whole buffer) and toWatermark (default: true),
+            % which cuts off the range at the latest time up to which all
+            % inlets have received samples. Returns a struct with fields
+            % timeEnd (end of the range that was taken) and data, a cell
+            % array with for each inlet what consumeTimeRange would return
+            if nargin<2
+                error('LSLMex::consumeTimeRangeMulti: must provide inlet ids.');
+            end
+            if nargin<3, startT = []; else, startT = int64(startT); end
+            if nargin<4, endT = []; else, endT = int64(endT); end
+            if nargin<5, toWatermark = []; end
+            bundle = this.cppmethod('consumeTimeRangeMulti',uint32(ids),startT,endT,toWatermark);
+        end
+        function bundle = peekTimeRangeMulti(this,ids,startT,endT,toWatermark)
+            % as consumeTimeRangeMulti, but samples are left in the buffers
+            if nargin<2
+                error('LSLMex::peekTimeRangeMulti: must provide inlet ids.');
+            end
+            if nargin<3, startT = []; else, startT = int64(startT); end
+            if nargin<4, endT = []; else, endT = int64(endT); end
+            if nargin<5, toWatermark = []; end
+            bundle = this.cppmethod('peekTimeRangeMulti',uint32(ids),startT,endT,toWatermark);
+        end
+        function data = peekGazeWithSignals(this,gazeId,extSignalId,timeSyncId,startT,endT)
+            % gaze samples (left in the buffer) with, for each, the value
+            % and timestamp of the most recent external signal at or before
+            % it, and optionally the round trip time (us) of the most recent
+            % time synchronization. -1 timestamp/round trip: there was none.
+            % optional time sync inlet id and start and end time inputs.
+            % Default: no time sync, whole buffer
+            if nargin<3
+                error('LSLMex::peekGazeWithSignals: must provide gaze and external signal inlet ids.');
+            end
+            if nargin<4 || isempty(timeSyncId), timeSyncId = []; else, timeSyncId = uint32(timeSyncId); end
+            if nargin<5, startT = []; else, startT = int64(startT); end
+            if nargin<6, endT = []; else, endT = int64(endT); end
+            data = this.cppmethod('peekGazeWithSignals',uint32(gazeId),uint32(extSignalId),timeSyncId,startT,endT);
+        end
+        function resampled = resample(this,ids,rate,startT,endT)
+            % resample gaze and numeric inlets onto a common grid of rate
+            % (Hz) points from startT to endT (inclusive, local clock).
+            % Grid points before the first or after the last sample of
+            % all inlets are left out. Samples are left in the buffers. Output has the grid
+            % (timeStamps) and per inlet a struct with values (channels x
+            % grid points, NaN outside the inlet's samples) and, for gaze,
+            % the validity/availability flags of the nearest sample. Gaze
+            % channels, per eye (left, then right): gaze point on display
+            % area (x,y), gaze point in user coordinates (x,y,z), pupil
+            % diameter, gaze origin in user coordinates (x,y,z), gaze
+            % origin in track box coordinates (x,y,z), eye openness
+            if nargin<5
+                error('LSLMex::resample: must provide inlet ids, rate, and start and end time.');
+            end
+            resampled = this.cppmethod('resample',uint32(ids),double(rate),int64(startT),int64(endT));
+        end
 
         function clear(this,id)
             if nargin<2
@@ -83,13 +83,18 @@ namespace mxTypes
     mxArray* ToMatlab(lsl::channel_format_t                                 data_);
     mxArray* ToMatlab(Titta::Stream                                         data_);
 
-    mxArray* ToMatlab(std::vector<LSL_streamer::gaze           >            data_);
+    mxArray* ToMatlab(const std::vector<LSL_streamer::gaze>&                data_);
     mxArray* FieldToMatlab(const std::vector<LSL_streamer::gaze>&           data_, bool rowVector_, TobiiTypes::eyeData Titta::gaze::* field_);
-    mxArray* ToMatlab(std::vector<LSL_streamer::eyeImage       >            data_);
-    mxArray* ToMatlab(std::vector<LSL_streamer::extSignal      >            data_);
-    mxArray* ToMatlab(std::vector<LSL_streamer::timeSync       >            data_);
-    mxArray* ToMatlab(std::vector<LSL_streamer::positioning    >            data_);
+    mxArray* ToMatlab(const std::vector<LSL_streamer::eyeImage>&            data_);
+    mxArray* ToMatlab(const std::vector<LSL_streamer::extSignal>&           data_);
+    mxArray* ToMatlab(const std::vector<LSL_streamer::timeSync>&            data_);
+    mxArray* ToMatlab(const std::vector<LSL_streamer::positioning>&         data_);
     mxArray* FieldToMatlab(const std::vector<LSL_streamer::positioning>&    data_, bool rowVector_, TobiiResearchEyeUserPositionGuide TobiiResearchUserPositionGuide::* field_);
+    mxArray* ToMatlab(const LSL_streamer::NumericSamples&                   data_);
+    mxArray* ToMatlab(const std::vector<LSL_streamer::marker>&              data_);
+    mxArray* ToMatlab(const LSL_streamer::SampleBundle&                     data_);
+    mxArray* ToMatlab(const LSL_streamer::GazeWithSignals&                  data_);
+    mxArray* ToMatlab(const LSL_streamer::ResampledBundle&                  data_);
 }
 #include "cpp_mex_helpers/mex_type_utils.h"
 
@@ -127,6 +132,13 @@ namespace {
         IsStreaming,
         StopOutlet,
 
+        // generic outlets
+        CreateNumericOutlet,
+        PushNumericChunk,
+        CreateMarkerOutlet,
+        PushMarker,
+        DeleteOutlet,
+
         // inlets
         CreateListener,
         GetInletInfo,
@@ -137,6 +149,10 @@ namespace {
         ConsumeTimeRange,
         PeekN,
         PeekTimeRange,
+        ConsumeTimeRangeMulti,
+        PeekTimeRangeMulti,
+        PeekGazeWithSignals,
+        Resample,
         Clear,
         ClearTimeRange,
         StopListening,
@@ -171,6 +187,13 @@ namespace {
         { "isStreaming",                    Action::IsStreaming },
         { "stopOutlet",                     Action::StopOutlet },
 
+        // generic outlets
+        { "createNumericOutlet",            Action::CreateNumericOutlet },
+        { "pushNumericChunk",               Action::PushNumericChunk },
+        { "createMarkerOutlet",             Action::CreateMarkerOutlet },
+        { "pushMarker",                     Action::PushMarker },
+        { "deleteOutlet",                   Action::DeleteOutlet },
+
         // inlets
         { "createListener",                 Action::CreateListener },
         { "getInletInfo",                   Action::GetInletInfo },
@@ -181,6 +204,10 @@ namespace {
         { "consumeTimeRange",               Action::ConsumeTimeRange },
         { "peekN",                          Action::PeekN },
         { "peekTimeRange",                  Action::PeekTimeRange },
+        { "consumeTimeRangeMulti",          Action::ConsumeTimeRangeMulti },
+        { "peekTimeRangeMulti",             Action::PeekTimeRangeMulti },
+        { "peekGazeWithSignals",            Action::PeekGazeWithSignals },
+        { "resample",                       Action::Resample },
         { "clear",                          Action::Clear },
         { "clearTimeRange",                 Action::ClearTimeRange },
         { "stopListening",                  Action::StopListening },
@@ -214,6 +241,33 @@ namespace {
         return it;
     }
 
+    // convert consumed samples, then hand their storage back to the inlet for reuse
+    template <typename DataType>
+    mxArray* consumedToMatlab(ClassType& instance_, const uint32_t id_, std::vector<DataType>&& data_)
+    {
+        auto out = mxTypes::ToMatlab(data_);
+        instance_.returnBuffer(id_, std::move(data_));
+        return out;
+    }
+
+    // inverse of mxTypes::ToMatlab(lsl::channel_format_t), for numeric formats
+    lsl::channel_format_t stringToChannelFormat(const std::string& format_)
+    {
+        if (format_ == "float" || format_ == "single")
+            return lsl::cf_float32;
+        if (format_ == "double")
+            return lsl::cf_double64;
+        if (format_ == "int8")
+            return lsl::cf_int8;
+        if (format_ == "int16")
+            return lsl::cf_int16;
+        if (format_ == "int32")
+            return lsl::cf_int32;
+        if (format_ == "int64")
+            return lsl::cf_int64;
+        throw "Channel format '" + format_ + "' not understood, should be 'float', 'double', 'int8', 'int16', 'int32' or 'int64'.";
+    }
+
     bool registeredAtExit = false;
     void atExitCleanUp()
     {
@@ -465,6 +519,161 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         }
 
 
+        // generic outlets
+        case Action::CreateNumericOutlet:
+        {
+            if (nrhs < 3 || !mxIsChar(prhs[2]))
+                throw "createNumericOutlet: First input must be a stream name string.";
+            if (nrhs < 4 || !mxIsChar(prhs[3]))
+                throw "createNumericOutlet: Second input must be a stream type string.";
+            if (nrhs < 5 || !mxIsUint64(prhs[4]) || mxIsComplex(prhs[4]) || !mxIsScalar(prhs[4]))
+                throw "createNumericOutlet: Third input must be a uint64 scalar (number of channels).";
+            if (nrhs < 6 || !mxIsChar(prhs[5]))
+                throw "createNumericOutlet: Fourth input must be a channel format string ('float', 'double', 'int8', 'int16', 'int32' or 'int64').";
+            auto numChannels = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs[4])));
+
+            // get optional input arguments
+            std::optional<double> nominalRate;
+            if (nrhs > 6 && !mxIsEmpty(prhs[6]))
+            {
+                if (!mxIsDouble(prhs[6]) || mxIsComplex(prhs[6]) || !mxIsScalar(prhs[6]))
+                    throw "createNumericOutlet: Expected fifth argument to be a double scalar.";
+                nominalRate = *static_cast<double*>(mxGetData(prhs[6]));
+            }
+            std::optional<std::string> sourceID;
+            if (nrhs > 7 && !mxIsEmpty(prhs[7]))
+            {
+                if (!mxIsChar(prhs[7]))
+                    throw "createNumericOutlet: Expected sixth argument to be a string.";
+                char* bufferCstr = mxArrayToString(prhs[7]);
+                sourceID = bufferCstr;
+                mxFree(bufferCstr);
+            }
+
+            char* nameCstr   = mxArrayToString(prhs[2]);
+            char* typeCstr   = mxArrayToString(prhs[3]);
+            char* formatCstr = mxArrayToString(prhs[5]);
+            std::string name(nameCstr), type(typeCstr), format(formatCstr);
+            mxFree(nameCstr);
+            mxFree(typeCstr);
+            mxFree(formatCstr);
+            plhs[0] = mxTypes::ToMatlab(instance->createNumericOutlet(std::move(name), std::move(type), numChannels, stringToChannelFormat(format), nominalRate, std::move(sourceID)));
+            return;
+        }
+        case Action::PushNumericChunk:
+        {
+            if (nrhs < 3 || !mxIsUint32(prhs[2]))
+                throw "pushNumericChunk: First input must be a uint32.";
+            if (nrhs < 4 || !mxIsNumeric(prhs[3]) || mxIsComplex(prhs[3]))
+                throw "pushNumericChunk: Second input must be a real numeric matrix (numChannels x numSamples).";
+            auto id = *static_cast<uint32_t*>(mxGetData(prhs[2]));
+
+            // get optional input arguments
+            std::span<const int64_t> timeStamps;
+            if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+            {
+                if (!mxIsInt64(prhs[4]) || mxIsComplex(prhs[4]))
+                    throw "pushNumericChunk: Expected third argument to be an int64 vector.";
+                timeStamps = {static_cast<const int64_t*>(mxGetData(prhs[4])), mxGetNumberOfElements(prhs[4])};
+            }
+
+            // check shape: one column per sample, one row per channel. NB: the library would accept
+            // any matrix with the right number of elements, e.g. a transposed one, and push garbage
+            if (const auto nCh = instance->getOutletNumChannels(id); !mxIsEmpty(prhs[3]) && (mxGetNumberOfDimensions(prhs[3]) != 2 || mxGetM(prhs[3]) != nCh))
+                throw std::string("pushNumericChunk: Second input must be a numChannels x numSamples matrix, the outlet has " + std::to_string(nCh) + " channels, the matrix has " + std::to_string(mxGetM(prhs[3])) + " rows.");
+            if (!timeStamps.empty() && timeStamps.size() != mxGetN(prhs[3]))
+                throw std::string("pushNumericChunk: Third input must have one timestamp per sample (" + std::to_string(mxGetN(prhs[3])) + "), has " + std::to_string(timeStamps.size()) + ".");
+
+            // the matrix is column-major, so its samples are laid out as LSL wants them and can be pushed as is
+            const auto nElem = mxGetNumberOfElements(prhs[3]);
+            switch (mxGetClassID(prhs[3]))
+            {
+            case mxSINGLE_CLASS:
+                instance->pushNumericChunk(id, std::span<const float>(static_cast<const float*>(mxGetData(prhs[3])), nElem), timeStamps);
+                break;
+            case mxDOUBLE_CLASS:
+                instance->pushNumericChunk(id, std::span<const double>(static_cast<const double*>(mxGetData(prhs[3])), nElem), timeStamps);
+                break;
+            case mxINT8_CLASS:
+                instance->pushNumericChunk(id, std::span<const int8_t>(static_cast<const int8_t*>(mxGetData(prhs[3])), nElem), timeStamps);
+                break;
+            case mxINT16_CLASS:
+                instance->pushNumericChunk(id, std::span<const int16_t>(static_cast<const int16_t*>(mxGetData(prhs[3])), nElem), timeStamps);
+                break;
+            case mxINT32_CLASS:
+                instance->pushNumericChunk(id, std::span<const int32_t>(static_cast<const int32_t*>(mxGetData(prhs[3])), nElem), timeStamps);
+                break;
+            case mxINT64_CLASS:
+                instance->pushNumericChunk(id, std::span<const int64_t>(static_cast<const int64_t*>(mxGetData(prhs[3])), nElem), timeStamps);
+                break;
+            default:
+                throw "pushNumericChunk: Second input must be of class single, double, int8, int16, int32 or int64.";
+            }
+            return;
+        }
+        case Action::CreateMarkerOutlet:
+        {
+            if (nrhs < 3 || !mxIsChar(prhs[2]))
+                throw "createMarkerOutlet: First input must be a stream name string.";
+
+            // get optional input arguments
+            std::optional<std::string> type;
+            if (nrhs > 3 && !mxIsEmpty(prhs[3]))
+            {
+                if (!mxIsChar(prhs[3]))
+                    throw "createMarkerOutlet: Expected second argument to be a string.";
+                char* bufferCstr = mxArrayToString(prhs[3]);
+                type = bufferCstr;
+                mxFree(bufferCstr);
+            }
+            std::optional<std::string> sourceID;
+            if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+            {
+                if (!mxIsChar(prhs[4]))
+                    throw "createMarkerOutlet: Expected third argument to be a string.";
+                char* bufferCstr = mxArrayToString(prhs[4]);
+                sourceID = bufferCstr;
+                mxFree(bufferCstr);
+            }
+
+            char* nameCstr = mxArrayToString(prhs[2]);
+            std::string name(nameCstr);
+            mxFree(nameCstr);
+            plhs[0] = mxTypes::ToMatlab(instance->createMarkerOutlet(std::move(name), std::move(type), std::move(sourceID)));
+            return;
+        }
+        case Action::PushMarker:
+        {
+            if (nrhs < 3 || !mxIsUint32(prhs[2]))
+                throw "pushMarker: First input must be a uint32.";
+            if (nrhs < 4 || !mxIsChar(prhs[3]))
+                throw "pushMarker: Second input must be a marker string.";
+            auto id = *static_cast<uint32_t*>(mxGetData(prhs[2]));
+
+            // get optional input arguments
+            std::optional<int64_t> timeStamp;
+            if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+            {
+                if (!mxIsInt64(prhs[4]) || mxIsComplex(prhs[4]) || !mxIsScalar(prhs[4]))
+                    throw "pushMarker: Expected third argument to be an int64 scalar.";
+                timeStamp = *static_cast<int64_t*>(mxGetData(prhs[4]));
+            }
+
+            char* markerCstr = mxArrayToString(prhs[3]);
+            const std::string marker(markerCstr);
+            mxFree(markerCstr);
+            plhs[0] = mxTypes::ToMatlab(instance->pushMarker(id, marker, timeStamp));
+            return;
+        }
+        case Action::DeleteOutlet:
+        {
+            if (nrhs < 3 || !mxIsUint32(prhs[2]))
+                throw "deleteOutlet: First input must be a uint32.";
+            instance->deleteOutlet(*static_cast<uint32_t*>(mxGetData(prhs[2])));
+            return;
+        }
+
+
         // inlets
         case Action::CreateListener:
         {
@@ -504,7 +713,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         {
             if (nrhs < 3 || !mxIsUint32(prhs[2]))
                 throw "getInletType: First input must be a uint32.";
-            plhs[0] = mxTypes::ToMatlab(instance->getInletType(*static_cast<uint32_t*>(mxGetData(prhs[2]))));
+            auto id = *static_cast<uint32_t*>(mxGetData(prhs[2]));
+            const auto type = instance->getInletType(id);
+            // generic inlets have no stream type of their own
+            if (type == Titta::Stream::Unknown)
+                plhs[0] = mxTypes::ToMatlab(std::string(instance->isMarkerInlet(id) ? "marker" : "numeric"));
+            else
+                plhs[0] = mxTypes::ToMatlab(type);
             return;
         }
         case Action::StartListening:
@@ -554,19 +769,25 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             switch (instance->getInletType(id))
             {
             case Titta::Stream::Gaze:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeN<LSL_streamer::gaze>(id, nSamp, side));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeN<LSL_streamer::gaze>(id, nSamp, side));
                 return;
             case Titta::Stream::EyeImage:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeN<LSL_streamer::eyeImage>(id, nSamp, side));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeN<LSL_streamer::eyeImage>(id, nSamp, side));
                 return;
             case Titta::Stream::ExtSignal:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeN<LSL_streamer::extSignal>(id, nSamp, side));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeN<LSL_streamer::extSignal>(id, nSamp, side));
                 return;
             case Titta::Stream::TimeSync:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeN<LSL_streamer::timeSync>(id, nSamp, side));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeN<LSL_streamer::timeSync>(id, nSamp, side));
                 return;
             case Titta::Stream::Positioning:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeN<LSL_streamer::positioning>(id, nSamp, side));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeN<LSL_streamer::positioning>(id, nSamp, side));
+                return;
+            case Titta::Stream::Unknown:    // generic numeric or marker inlet
+                if (instance->isMarkerInlet(id))
+                    plhs[0] = consumedToMatlab(*instance, id, instance->consumeN<LSL_streamer::marker>(id, nSamp, side));
+                else
+                    plhs[0] = mxTypes::ToMatlab(instance->consumeNumericN(id, nSamp, side));
                 return;
             }
         }
@@ -596,19 +817,25 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             {
             case Titta::Stream::Gaze:
             case Titta::Stream::EyeOpenness:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeTimeRange<LSL_streamer::gaze>(id, timeStart, timeEnd));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeTimeRange<LSL_streamer::gaze>(id, timeStart, timeEnd));
                 return;
             case Titta::Stream::EyeImage:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeTimeRange<LSL_streamer::eyeImage>(id, timeStart, timeEnd));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeTimeRange<LSL_streamer::eyeImage>(id, timeStart, timeEnd));
                 return;
             case Titta::Stream::ExtSignal:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeTimeRange<LSL_streamer::extSignal>(id, timeStart, timeEnd));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeTimeRange<LSL_streamer::extSignal>(id, timeStart, timeEnd));
                 return;
             case Titta::Stream::TimeSync:
-                plhs[0] = mxTypes::ToMatlab(instance->consumeTimeRange<LSL_streamer::timeSync>(id, timeStart, timeEnd));
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeTimeRange<LSL_streamer::timeSync>(id, timeStart, timeEnd));
                 return;
             case Titta::Stream::Positioning:
-                throw "consumeTimeRange: not supported for positioning stream.";
+                plhs[0] = consumedToMatlab(*instance, id, instance->consumeTimeRange<LSL_streamer::positioning>(id, timeStart, timeEnd));
+                return;
+            case Titta::Stream::Unknown:    // generic numeric or marker inlet
+                if (instance->isMarkerInlet(id))
+                    plhs[0] = consumedToMatlab(*instance, id, instance->consumeTimeRange<LSL_streamer::marker>(id, timeStart, timeEnd));
+                else
+                    plhs[0] = mxTypes::ToMatlab(instance->consumeNumericTimeRange(id, timeStart, timeEnd));
                 return;
             }
         }
@@ -660,6 +887,12 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             case Titta::Stream::Positioning:
                 plhs[0] = mxTypes::ToMatlab(instance->peekN<LSL_streamer::positioning>(id, nSamp, side));
                 return;
+            case Titta::Stream::Unknown:    // generic numeric or marker inlet
+                if (instance->isMarkerInlet(id))
+                    plhs[0] = mxTypes::ToMatlab(instance->peekN<LSL_streamer::marker>(id, nSamp, side));
+                else
+                    plhs[0] = mxTypes::ToMatlab(instance->peekNumericN(id, nSamp, side));
+                return;
             }
         }
         case Action::PeekTimeRange:
@@ -700,10 +933,106 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
                 plhs[0] = mxTypes::ToMatlab(instance->peekTimeRange<LSL_streamer::timeSync>(id, timeStart, timeEnd));
                 return;
             case Titta::Stream::Positioning:
-                throw "peekTimeRange: not supported for positioning stream.";
+                plhs[0] = mxTypes::ToMatlab(instance->peekTimeRange<LSL_streamer::positioning>(id, timeStart, timeEnd));
+                return;
+            case Titta::Stream::Unknown:    // generic numeric or marker inlet
+                if (instance->isMarkerInlet(id))
+                    plhs[0] = mxTypes::ToMatlab(instance->peekTimeRange<LSL_streamer::marker>(id, timeStart, timeEnd));
+                else
+                    plhs[0] = mxTypes::ToMatlab(instance->peekNumericTimeRange(id, timeStart, timeEnd));
                 return;
             }
         }
+        case Action::ConsumeTimeRangeMulti:
+        case Action::PeekTimeRangeMulti:
+        {
+            const auto consume  = action == Action::ConsumeTimeRangeMulti;
+            const auto name     = consume ? std::string("consumeTimeRangeMulti") : std::string("peekTimeRangeMulti");
+            if (nrhs < 3 || !mxIsUint32(prhs[2]) || mxIsEmpty(prhs[2]))
+                throw name + ": First input must be a uint32 array of inlet ids.";
+            const std::span<const uint32_t> ids(static_cast<const uint32_t*>(mxGetData(prhs[2])), mxGetNumberOfElements(prhs[2]));
+
+            // get optional input arguments
+            std::optional<int64_t> timeStart;
+            if (nrhs > 3 && !mxIsEmpty(prhs[3]))
+            {
+                if (!mxIsInt64(prhs[3]) || mxIsComplex(prhs[3]) || !mxIsScalar(prhs[3]))
+                    throw name + ": Expected second argument to be a int64 scalar.";
+                timeStart = *static_cast<int64_t*>(mxGetData(prhs[3]));
+            }
+            std::optional<int64_t> timeEnd;
+            if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+            {
+                if (!mxIsInt64(prhs[4]) || mxIsComplex(prhs[4]) || !mxIsScalar(prhs[4]))
+                    throw name + ": Expected third argument to be a int64 scalar.";
+                timeEnd = *static_cast<int64_t*>(mxGetData(prhs[4]));
+            }
+            std::optional<bool> toWatermark;
+            if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+            {
+                if (!(mxIsDouble(prhs[5]) && !mxIsComplex(prhs[5]) && mxIsScalar(prhs[5])) && !mxIsLogicalScalar(prhs[5]))
+                    throw name + ": Expected fourth argument to be a logical scalar.";
+                toWatermark = mxIsLogicalScalarTrue(prhs[5]);
+            }
+
+            plhs[0] = mxTypes::ToMatlab(consume ?
+                instance->consumeTimeRangeMulti(ids, timeStart, timeEnd, std::nullopt, toWatermark) :
+                instance->peekTimeRangeMulti   (ids, timeStart, timeEnd, std::nullopt, toWatermark));
+            return;
+        }
+        case Action::PeekGazeWithSignals:
+        {
+            if (nrhs < 3 || !mxIsUint32(prhs[2]) || !mxIsScalar(prhs[2]))
+                throw "peekGazeWithSignals: First input must be a uint32 gaze inlet id.";
+            const auto gazeId = *static_cast<uint32_t*>(mxGetData(prhs[2]));
+            if (nrhs < 4 || !mxIsUint32(prhs[3]) || !mxIsScalar(prhs[3]))
+                throw "peekGazeWithSignals: Second input must be a uint32 external signal inlet id.";
+            const auto extSignalId = *static_cast<uint32_t*>(mxGetData(prhs[3]));
+
+            // get optional input arguments
+            std::optional<uint32_t> timeSyncId;
+            if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+            {
+                if (!mxIsUint32(prhs[4]) || !mxIsScalar(prhs[4]))
+                    throw "peekGazeWithSignals: Expected third argument to be a uint32 time sync inlet id.";
+                timeSyncId = *static_cast<uint32_t*>(mxGetData(prhs[4]));
+            }
+            std::optional<int64_t> timeStart;
+            if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+            {
+                if (!mxIsInt64(prhs[5]) || mxIsComplex(prhs[5]) || !mxIsScalar(prhs[5]))
+                    throw "peekGazeWithSignals: Expected fourth argument to be a int64 scalar.";
+                timeStart = *static_cast<int64_t*>(mxGetData(prhs[5]));
+            }
+            std::optional<int64_t> timeEnd;
+            if (nrhs > 6 && !mxIsEmpty(prhs[6]))
+            {
+                if (!mxIsInt64(prhs[6]) || mxIsComplex(prhs[6]) || !mxIsScalar(prhs[6]))
+                    throw "peekGazeWithSignals: Expected fifth argument to be a int64 scalar.";
+                timeEnd = *static_cast<int64_t*>(mxGetData(prhs[6]));
+            }
+
+            plhs[0] = mxTypes::ToMatlab(instance->peekGazeWithSignals(gazeId, extSignalId, timeSyncId, timeStart, timeEnd));
+            return;
+        }
+        case Action::Resample:
+        {
+            if (nrhs < 3 || !mxIsUint32(prhs[2]) || mxIsEmpty(prhs[2]))
+                throw "resample: First input must be a uint32 array of inlet ids.";
+            const std::span<const uint32_t> ids(static_cast<const uint32_t*>(mxGetData(prhs[2])), mxGetNumberOfElements(prhs[2]));
+            if (nrhs < 4 || !mxIsDouble(prhs[3]) || mxIsComplex(prhs[3]) || !mxIsScalar(prhs[3]))
+                throw "resample: Second input must be a double scalar rate (Hz).";
+            const auto rate = *static_cast<double*>(mxGetData(prhs[3]));
+            if (nrhs < 5 || !mxIsInt64(prhs[4]) || mxIsComplex(prhs[4]) || !mxIsScalar(prhs[4]))
+                throw "resample: Third input must be a int64 scalar start time.";
+            const auto timeStart = *static_cast<int64_t*>(mxGetData(prhs[4]));
+            if (nrhs < 6 || !mxIsInt64(prhs[5]) || mxIsComplex(prhs[5]) || !mxIsScalar(prhs[5]))
+                throw "resample: Fourth input must be a int64 scalar end time.";
+            const auto timeEnd = *static_cast<int64_t*>(mxGetData(prhs[5]));
+
+            plhs[0] = mxTypes::ToMatlab(instance->resample(ids, rate, timeStart, timeEnd));
+            return;
+        }
         case Action::Clear:
         {
             if (nrhs < 3 || !mxIsUint32(prhs[2]))
@@ -835,6 +1164,34 @@ namespace
         return out;
     }
 
+    template <typename T>
+    constexpr mxClassID numericClassID()
+    {
+        if      constexpr (std::is_same_v<T, float>)
+            return mxSINGLE_CLASS;
+        else if constexpr (std::is_same_v<T, double>)
+            return mxDOUBLE_CLASS;
+        else if constexpr (std::is_same_v<T, int8_t>)
+            return mxINT8_CLASS;
+        else if constexpr (std::is_same_v<T, int16_t>)
+            return mxINT16_CLASS;
+        else if constexpr (std::is_same_v<T, int32_t>)
+            return mxINT32_CLASS;
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return mxUINT32_CLASS;
+        else
+            return mxINT64_CLASS;
+    }
+    // rows x cols matrix holding data_, which is column-major so it is copied in one go
+    template <typename T>
+    mxArray* columnMajorToMatlab(const std::vector<T>& data_, const size_t rows_, const size_t cols_)
+    {
+        mxArray* out = mxCreateUninitNumericMatrix(rows_, cols_, numericClassID<T>(), mxREAL);
+        if (!data_.empty())
+            std::memcpy(mxGetData(out), data_.data(), data_.size() * sizeof(T));
+        return out;
+    }
+
     std::string TobiiResearchCalibrationEyeValidityToString(TobiiResearchCalibrationEyeValidity data_)
     {
         switch (data_)
@@ -946,7 +1303,7 @@ namespace mxTypes
         return ToMatlab(Titta::streamToString(data_));
     }
 
-    mxArray* ToMatlab(std::vector<LSL_streamer::gaze> data_)
+    mxArray* ToMatlab(const std::vector<LSL_streamer::gaze>& data_)
     {
         const char* fieldNames[] = {"remote_system_time_stamp","local_system_time_stamp","deviceTimeStamp","systemTimeStamp","left","right"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
@@ -1019,7 +1376,7 @@ namespace mxTypes
         return out;
     }
 
-    mxArray* ToMatlab(std::vector<LSL_streamer::eyeImage> data_)
+    mxArray* ToMatlab(const std::vector<LSL_streamer::eyeImage>& data_)
     {
         // check if all gif, then don't output unneeded fields
         bool allGif = allEquals(data_, &LSL_streamer::eyeImage::eyeImageData, &Titta::eyeImage::is_gif, true);
@@ -1061,7 +1418,7 @@ namespace mxTypes
         return out;
     }
 
-    mxArray* ToMatlab(std::vector<LSL_streamer::extSignal> data_)
+    mxArray* ToMatlab(const std::vector<LSL_streamer::extSignal>& data_)
     {
         const char* fieldNames[] = {"remote_system_time_stamp","local_system_time_stamp","deviceTimeStamp","systemTimeStamp","value","changeType"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
@@ -1082,7 +1439,7 @@ namespace mxTypes
         return out;
     }
 
-    mxArray* ToMatlab(std::vector<LSL_streamer::timeSync> data_)
+    mxArray* ToMatlab(const std::vector<LSL_streamer::timeSync>& data_)
     {
         const char* fieldNames[] = {"remote_system_time_stamp","local_system_time_stamp","systemRequestTimeStamp","deviceTimeStamp","systemResponseTimeStamp"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
@@ -1114,7 +1471,7 @@ namespace mxTypes
         return out;
     }
 
-    mxArray* ToMatlab(std::vector<LSL_streamer::positioning> data_)
+    mxArray* ToMatlab(const std::vector<LSL_streamer::positioning>& data_)
     {
         const char* fieldNames[] = {"remote_system_time_stamp","local_system_time_stamp","left","right"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
@@ -1130,6 +1487,93 @@ namespace mxTypes
 
         return out;
     }
+
+    mxArray* ToMatlab(const LSL_streamer::NumericSamples& data_)
+    {
+        const char* fieldNames[] = {"remote_system_time_stamp","local_system_time_stamp","data"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // 1. remote system timestamps
+        mxSetFieldByNumber(out, 0, 0, columnMajorToMatlab(data_.remoteTimeStamps, 1, data_.size()));
+        // 2. local system timestamps
+        mxSetFieldByNumber(out, 0, 1, columnMajorToMatlab(data_.localTimeStamps, 1, data_.size()));
+        // 3. channel values, numChannels x numSamples matrix of the stream's channel format
+        mxSetFieldByNumber(out, 0, 2, std::visit([&](const auto& values_) { return columnMajorToMatlab(values_, data_.numChannels, data_.size()); }, data_.values));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(const std::vector<LSL_streamer::marker>& data_)
+    {
+        const char* fieldNames[] = {"remote_system_time_stamp","local_system_time_stamp","value"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // 1. remote system timestamps
+        mxSetFieldByNumber(out, 0, 0, FieldToMatlab(data_, true, &LSL_streamer::marker::remote_system_time_stamp));
+        // 2. local system timestamps
+        mxSetFieldByNumber(out, 0, 1, FieldToMatlab(data_, true, &LSL_streamer::marker::local_system_time_stamp));
+        // 3. marker strings, as cell array
+        mxArray* values = mxCreateCellMatrix(1, data_.size());
+        for (size_t i = 0; i < data_.size(); i++)
+            mxSetCell(values, i, mxCreateString(data_[i].value.c_str()));
+        mxSetFieldByNumber(out, 0, 2, values);
+
+        return out;
+    }
+
+    mxArray* ToMatlab(const LSL_streamer::SampleBundle& data_)
+    {
+        const char* fieldNames[] = {"timeEnd","data"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // 1. end of the time range that was taken
+        mxSetFieldByNumber(out, 0, 0, ToMatlab(data_.timeEnd));
+        // 2. samples per inlet, as cell array
+        mxArray* samples = mxCreateCellMatrix(1, data_.samples.size());
+        for (size_t i = 0; i < data_.samples.size(); i++)
+            mxSetCell(samples, i, std::visit([](const auto& samples_) { return ToMatlab(samples_); }, data_.samples[i]));
+        mxSetFieldByNumber(out, 0, 1, samples);
+
+        return out;
+    }
+
+    mxArray* ToMatlab(const LSL_streamer::GazeWithSignals& data_)
+    {
+        // gaze struct, with the joined signals as extra fields
+        mxArray* out = ToMatlab(data_.samples);
+        const auto addField = [out](const char* name_, mxArray* value_)
+        {
+            mxSetFieldByNumber(out, 0, mxAddField(out, name_), value_);
+        };
+        addField("extSignalValue",      columnMajorToMatlab(data_.extSignalValue, 1, data_.extSignalValue.size()));
+        addField("extSignalTimeStamp",  columnMajorToMatlab(data_.extSignalTimeStamp, 1, data_.extSignalTimeStamp.size()));
+        addField("timeSyncRoundTrip",   columnMajorToMatlab(data_.timeSyncRoundTrip, 1, data_.timeSyncRoundTrip.size()));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(const LSL_streamer::ResampledBundle& data_)
+    {
+        const char* fieldNames[] = {"timeStamps","data"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // 1. the time grid
+        mxSetFieldByNumber(out, 0, 0, columnMajorToMatlab(data_.timeStamps, 1, data_.timeStamps.size()));
+        // 2. per inlet, as cell array: values (numChannels x grid points) and flags (gaze only)
+        const char* streamFieldNames[] = {"values","flags"};
+        mxArray* streams = mxCreateCellMatrix(1, data_.streams.size());
+        for (size_t i = 0; i < data_.streams.size(); i++)
+        {
+            const auto& stream = data_.streams[i];
+            mxArray* temp = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(streamFieldNames)), streamFieldNames);
+            mxSetFieldByNumber(temp, 0, 0, columnMajorToMatlab(stream.values, stream.numChannels, data_.timeStamps.size()));
+            mxSetFieldByNumber(temp, 0, 1, columnMajorToMatlab(stream.flags, 1, stream.flags.size()));
+            mxSetCell(streams, i, temp);
+        }
+        mxSetFieldByNumber(out, 0, 1, streams);
+
+        return out;
+    }
 }
 
 
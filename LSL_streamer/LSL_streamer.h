@@ -1,17 +1,26 @@
 #pragma once
 #include <vector>
+#include <array>
 #include <deque>
 #include <map>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <atomic>
 #include <variant>
 #include <memory>
 #include <thread>
+#include <span>
+#include <ranges>
+#include <utility>
+#include <mutex>
+#include <filesystem>
 #include <tobii_research.h>
 #include <tobii_research_streams.h>
+#ifdef _MSC_VER
 #pragma comment(lib, "tobii_research.lib")
-#ifndef BUILD_FROM_SCRIPT
+#endif
+#if defined(_MSC_VER) && !defined(BUILD_FROM_SCRIPT)
 #   ifdef _DEBUG
 #       pragma comment(lib, "LSL_streamer_d.lib")
 #   else
@@ -22,41 +31,321 @@
 #include "Titta/types.h"
 #include "Titta/Titta.h"
 #include "LSL_streamer/types.h"
+#include "LSL_streamer/pusher_pool.h"
+#include "LSL_streamer/inlet_registry.h"
 
 #include "lsl_cpp.h"
 
+template <typename DataType> class SampleTier;
 
 class LSL_streamer
 {
+public:
+    // what to do when storing a new sample would exceed an inlet's or the global memory budget
+    enum class MemoryPolicy
+    {
+        DropOldest,     // remove the oldest samples from the inlet receiving the sample (in batches of 1/16th of its buffer)
+        SpillToDisk,    // move the oldest samples (in batches of a quarter of the buffer) to files in the spill
+                        // directory. Time range and N-sample consume, peek and clear calls transparently cover
+                        // both tiers, as do cursors. Views only see samples in RAM. If writing fails, samples are
+                        // dropped as with DropOldest
+        Compress,       // compress the oldest samples (in batches of a quarter of the buffer) into blocks kept in
+                        // RAM. As with SpillToDisk, consume, peek and clear calls and cursors cover both the
+                        // compressed and the uncompressed samples. Compressed samples count towards the budget,
+                        // when they fill it the oldest compressed samples are dropped
+        StopIngest      // discard incoming samples until there is room again
+        // NB: eye image, numeric and marker inlets cannot spill or compress their samples.
+        // setMemoryBudget() refuses SpillToDisk and Compress for them, under a global
+        // budget with one of these policies they drop samples as with DropOldest
+    };
+    // memory use of an inlet's (or, summed, all inlets') sample buffer. Counts
+    // sizeof() of the stored samples, heap memory owned by samples (eye image
+    // data, marker strings) and, for numeric inlets, their channel values
+    struct MemoryStats
+    {
+        size_t      bytesUsed       = 0;        // samples stored in RAM (buffer and compressed samples)
+        size_t      bytesCapacity   = 0;        // allocated for the buffer, including spare buffers
+        size_t      highWaterMark   = 0;        // maximum of bytesUsed since inlet creation
+        size_t      bytesSpilled    = 0;        // samples stored on disk (SpillToDisk policy)
+        size_t      bytesCompressed = 0;        // compressed samples (Compress policy), included in bytesUsed
+        uint64_t    samplesDropped  = 0;        // samples removed or discarded because of a memory budget
+        bool        ingestStopped   = false;    // true when last incoming sample was discarded (StopIngest policy)
+    };
+
+    // memory use of all inlets together, and its budget. For internal use.
+    // Shared by the inlets, as they may outlive the LSL_streamer (BufferView, InletHandle)
+    struct MemoryAccount
+    {
+        std::atomic<size_t>         bytesUsed       = 0;
+        std::atomic<size_t>         highWaterMark   = 0;
+        std::atomic<size_t>         budget          = 0;    // 0: no budget
+        std::atomic<MemoryPolicy>   policy          = MemoryPolicy::DropOldest;
+        std::mutex                  spillDirectoryMutex;
+        std::filesystem::path       spillDirectory;         // empty: system temp directory
+    };
+
+    // public because the public AllInlets type names it, for internal use only
     template <class DataType>
     class Inlet
     {
     public:
-        Inlet(const lsl::stream_info& streamInfo_) :
-            _lsl_inlet(streamInfo_)
+        // samples are stored as is, except for gaze (LSLTypes::storage)
+        using stored_t = LSLTypes::storage_t<DataType>;
+
+        Inlet(const lsl::stream_info& streamInfo_, std::shared_ptr<MemoryAccount> memoryAccount_) :
+            _lsl_inlet(streamInfo_),
+            _irregularRate(streamInfo_.nominal_srate() == lsl::IRREGULAR_RATE),
+            _memoryAccount(std::move(memoryAccount_))
         {}
+        ~Inlet()
+        {
+            // remove samples from global accounting
+            _memoryAccount->bytesUsed -= _bytesUsed;
+        }
 
         lsl::stream_inlet               _lsl_inlet;
-        std::vector<DataType>           _buffer;
+        const bool                      _irregularRate;     // stream has no nominal sampling rate (e.g. external signals, markers)
+        std::vector<stored_t>           _buffer;
         mutex_type                      _mutex;
         std::unique_ptr<std::thread>    _recorder;
-        std::atomic<bool>               _recorder_should_stop;
+        std::atomic<bool>               _recorder_should_stop = false;
+        std::mutex                      _recorderMutex;     // serializes starting and stopping the recorder thread
+        bool                            _deleted = false;   // inlet was deleted, recorder cannot be started anymore (guarded by _recorderMutex)
+        // named read cursors: position (index into [_olderTier | _buffer]) of the next sample each cursor will read
+        std::map<std::string, size_t>   _cursors;
+        // per clock, sorted runs of timestamps in _buffer (src/time_index.h)
+        std::array<std::vector<LSLTypes::TimeRun>, LSLTypes::TimeClock::numClocks> _timeRuns;
+        size_t                          _numTimeIndexed = 0;
+        // per clock, newest timestamp received, for watermarks. Unlike the buffer's contents,
+        // not affected by consuming or clearing samples
+        std::array<int64_t, LSLTypes::TimeClock::numClocks> _newestReceived{};
+        bool                            _hasReceived    = false;
+        // capacity reserved for _buffer, and spare buffers with that capacity that are
+        // swapped in when the whole buffer is consumed. While the pool is not full, the
+        // recorder thread allocates spare buffers, outside of the lock
+        size_t                          _bufferCapacity = 0;
+        std::vector<std::vector<stored_t>> _bufferPool;
+        std::atomic<bool>               _spareBufferWanted = true;
+        // memory accounting and budget
+        std::shared_ptr<MemoryAccount>  _memoryAccount;
+        size_t                          _memoryBudget   = 0;    // 0: no budget
+        MemoryPolicy                    _memoryPolicy   = MemoryPolicy::DropOldest;
+        size_t                          _bytesUsed      = 0;
+        size_t                          _payloadBytes   = 0;    // heap memory owned by the samples in _buffer (eye images, markers)
+        size_t                          _highWaterMark  = 0;
+        uint64_t                        _samplesDropped = 0;
+        bool                            _ingestStopped  = false;
+        // holds samples older than those in _buffer: on disk (SpillToDisk policy) or compressed in
+        // RAM (Compress policy), created by whichever policy first needs it
+        std::shared_ptr<SampleTier<stored_t>> _olderTier;
+        // numeric inlets only: channel values of the samples in _buffer, _numChannels per sample
+        size_t                          _numChannels    = 0;
+        LSLTypes::numericValues         _values;
     };
 
-public:
     // short names for very long Tobii data types
     using gaze          = LSLTypes::gaze;       // getInletType() -> Titta::Stream::Gaze
     using eyeImage      = LSLTypes::eyeImage;   // getInletType() -> Titta::Stream::EyeImage
     using extSignal     = LSLTypes::extSignal;  // getInletType() -> Titta::Stream::ExtSignal
     using timeSync      = LSLTypes::timeSync;   // getInletType() -> Titta::Stream::TimeSync
     using positioning   = LSLTypes::positioning;// getInletType() -> Titta::Stream::Positioning
+    using numeric       = LSLTypes::numeric;    // getInletType() -> Titta::Stream::Unknown (generic numeric inlet)
+    using marker        = LSLTypes::marker;     // getInletType() -> Titta::Stream::Unknown, isMarkerInlet() -> true
+    using TimeClock     = LSLTypes::TimeClock;
     using AllInlets = std::variant<
                         Inlet<gaze>,
                         Inlet<eyeImage>,
                         Inlet<extSignal>,
                         Inlet<timeSync>,
-                        Inlet<positioning>
+                        Inlet<positioning>,
+                        Inlet<numeric>,
+                        Inlet<marker>
+                    >;
+
+    // samples of a generic numeric inlet. values holds a numChannels x size()
+    // matrix in column-major order (all channels of the first sample, then of
+    // the second, etc.), of the type matching the stream's channel format
+    struct NumericSamples
+    {
+        size_t                  numChannels = 0;
+        std::vector<int64_t>    remoteTimeStamps;
+        std::vector<int64_t>    localTimeStamps;
+        LSLTypes::numericValues values;
+
+        size_t size()  const { return remoteTimeStamps.size(); }
+        bool   empty() const { return remoteTimeStamps.empty(); }
+    };
+    // samples of any inlet type, as returned by the consume and peek functions for that type
+    using AllSamples = std::variant<
+                        std::vector<gaze>,
+                        std::vector<eyeImage>,
+                        std::vector<extSignal>,
+                        std::vector<timeSync>,
+                        std::vector<positioning>,
+                        NumericSamples,
+                        std::vector<marker>
                     >;
+    // samples of multiple inlets taken at the same instant, see consumeTimeRangeMulti()
+    struct SampleBundle
+    {
+        int64_t                 timeEnd = 0;    // end of the time range that was taken (the watermark, if it was earlier than the requested end)
+        std::vector<AllSamples> samples;        // per inlet, in the order the ids were given
+    };
+    // gaze samples with, for each, the most recent external signal and time synchronization at or
+    // before it, see peekGazeWithSignals(). A timestamp or round trip of -1 means there was none
+    struct GazeWithSignals
+    {
+        std::vector<gaze>       samples;
+        std::vector<uint32_t>   extSignalValue;         // 0 if there was no external signal
+        std::vector<int64_t>    extSignalTimeStamp;     // on the clock of the query
+        std::vector<int64_t>    timeSyncRoundTrip;      // us (system response - request time), empty if no time sync inlet was given
+    };
+    // an inlet's samples resampled onto a regular time grid, see resample(). Values are
+    // column-major: the numChannels values of a grid point are contiguous and followed by those
+    // of the next grid point. Gaze channels are those of LSLTypes::packedGaze::values, in that order
+    struct ResampledStream
+    {
+        size_t                  numChannels = 0;
+        std::vector<double>     values;                 // NaN outside the inlet's samples
+        std::vector<uint32_t>   flags;                  // gaze only: LSLTypes::packedGaze::flags of the nearest sample, 0 outside the inlet's samples
+    };
+    struct ResampledBundle
+    {
+        std::vector<int64_t>            timeStamps;     // the grid, local clock
+        std::vector<ResampledStream>    streams;        // per inlet, in the order the ids were given
+    };
+
+    // read-only view of (part of) an inlet's buffer, without copying. Holds
+    // the inlet's read lock until it is destroyed or release() is called, so
+    // keep it short-lived: while it is held, the inlet's recorder thread cannot
+    // store new samples (they queue up in LSL), and consume and clear calls
+    // block. Do not call consume or clear on the same inlet from the thread
+    // holding the view, that deadlocks.
+    // Gaze samples are stored packed (LSLTypes::packedGaze): span() gives the
+    // packed samples, iterating or indexing the view expands them on access
+    // (returning gaze by value). For other types elements are references into
+    // the buffer. The view keeps the inlet alive, also if it is deleted meanwhile
+    template <typename DataType>
+    class BufferView
+    {
+    public:
+        using stored_t  = LSLTypes::storage_t<DataType>;
+        using samples_t = std::ranges::transform_view<std::span<const stored_t>, LSLTypes::unpack_fn<DataType>>;
+
+        BufferView() = default;
+        BufferView(std::shared_ptr<const void> owner_, read_lock&& lock_, std::span<const stored_t> data_) :
+            _owner(std::move(owner_)),
+            _lock(std::move(lock_)),
+            _samples(data_, {})
+        {}
+        BufferView(BufferView&& other_) noexcept :
+            _owner(std::move(other_._owner)),
+            _lock(std::move(other_._lock)),
+            _samples(std::exchange(other_._samples, {}))
+        {}
+        BufferView& operator=(BufferView&& other_) noexcept
+        {
+            // NB: release our lock before letting go of the inlet it belongs to
+            _lock = std::move(other_._lock);
+            _samples = std::exchange(other_._samples, {});
+            _owner = std::move(other_._owner);
+            return *this;
+        }
+
+        std::span<const stored_t> span() const { return _samples.base(); }
+        auto   begin()                   const { return _samples.begin(); }
+        auto   end()                     const { return _samples.end(); }
+        size_t size()                    const { return _samples.size(); }
+        bool   empty()                   const { return _samples.empty(); }
+        decltype(auto) operator[](size_t i_) const { return _samples[i_]; }
+        decltype(auto) front()           const { return _samples.front(); }
+        decltype(auto) back()            const { return _samples.back(); }
+
+        // give up access to the buffer before the view is destroyed
+        void release()
+        {
+            _samples = {};
+            if (_lock.owns_lock())
+                _lock.unlock();
+            _owner.reset();
+        }
+
+    private:
+        std::shared_ptr<const void> _owner;     // NB: declared first, so it's destroyed after the lock is released
+        read_lock                   _lock;
+        samples_t                   _samples;
+    };
+
+    // handle to an inlet of known type, for consume and peek calls in hot
+    // loops: the inlet is looked up and its type checked once, when the handle
+    // is made (getInletHandle()), instead of on every call. Functions behave as
+    // the LSL_streamer functions of the same name. The handle keeps the inlet
+    // alive, also when it is deleted meanwhile (it then no longer receives
+    // samples). Copies refer to the same inlet
+    template <typename DataType>
+    class InletHandle
+    {
+    public:
+        InletHandle() = default;
+
+        uint32_t getID() const { return _id; }
+        explicit operator bool() const { return _inlet != nullptr; }
+
+        std::vector<DataType> consumeN(std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt) const
+        {
+            return LSL_streamer::consumeN(_inlet, NSamp_, side_);
+        }
+        std::vector<DataType> consumeTimeRange(std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt) const
+        {
+            return LSL_streamer::consumeTimeRange(_inlet, timeStart_, timeEnd_, clock_);
+        }
+        std::vector<DataType> peekN(std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt) const
+        {
+            return LSL_streamer::peekN(_inlet, NSamp_, side_);
+        }
+        std::vector<DataType> peekTimeRange(std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt) const
+        {
+            return LSL_streamer::peekTimeRange(_inlet, timeStart_, timeEnd_, clock_);
+        }
+        BufferView<DataType> peekNView(std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt) const
+        {
+            return LSL_streamer::peekNView(_inlet, NSamp_, side_);
+        }
+        BufferView<DataType> peekTimeRangeView(std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt) const
+        {
+            return LSL_streamer::peekTimeRangeView(_inlet, timeStart_, timeEnd_, clock_);
+        }
+
+    private:
+        friend class LSL_streamer;
+        InletHandle(const uint32_t id_, std::shared_ptr<Inlet<DataType>> inlet_) :
+            _id(id_),
+            _inlet(std::move(inlet_))
+        {}
+
+        uint32_t                            _id = 0;
+        std::shared_ptr<Inlet<DataType>>    _inlet;
+    };
+
+    // statistics about an outlet
+    struct OutletStats
+    {
+        uint64_t    samplesPushed   = 0;        // number of samples pushed into the outlet
+        uint64_t    samplesPending  = 0;        // number of samples posted to the pusher pool but not yet pushed
+        int64_t     lastTimeStamp   = 0;        // system timestamp of last pushed sample (us)
+        bool        hasConsumers    = false;
+    };
+
+    // points in the pipeline at which samples can be observed
+    enum class ProbePoint
+    {
+        Callback,   // entry of Tobii SDK callback (positioning: the time it is stamped with)
+        Pushed,     // sample was pushed into outlet
+        Pulled      // sample was pulled from LSL by an inlet's recorder thread
+    };
+    // probe function, called with the probe point, the sample's stream and its
+    // timestamp (us, the timestamp it is sent over LSL with)
+    using probe_fun_t = void(*)(ProbePoint, Titta::Stream, int64_t);
 
 public:
     LSL_streamer() {}
@@ -81,19 +370,69 @@ public:
     bool isStreaming(Titta::Stream stream_) const;
     void stopOutlet(std::string    stream_, bool snake_case_on_stream_not_found = false);
     void stopOutlet(Titta::Stream  stream_);
+    // use a (shared) pool of threads for pushing samples into the outlets, instead of
+    // pushing on the Tobii SDK's callback thread. Can only be set while no outlets are running
+    void setPusherPool(std::shared_ptr<PusherPool> pool_);
+    OutletStats getOutletStats(std::string   stream_, bool snake_case_on_stream_not_found = false) const;
+    OutletStats getOutletStats(Titta::Stream stream_) const;
+    std::string getSerialNumber() const;
+    // install function that gets called for each sample passing a probe point,
+    // e.g. for latency benchmarks. Must be cheap and thread-safe. nullptr (the
+    // default) disables the probes
+    static void setProbe(probe_fun_t probe_);
+
+    //// generic outlets
+    // Outlets for data other than the eye tracker's (e.g. signals computed by
+    // experiment code). They are identified by the id returned on creation and
+    // do not need a connection to an eye tracker. Can be used from multiple threads
+
+    // open an outlet for numeric data. nominalRate_ defaults to irregular rate, sourceID_ to "LSL_streamer:<name_>"
+    [[nodiscard]] uint32_t createNumericOutlet(std::string name_, std::string type_, size_t numChannels_, lsl::channel_format_t format_, std::optional<double> nominalRate_ = std::nullopt, std::optional<std::string> sourceID_ = std::nullopt);
+    // push a chunk of samples in one call, without copying the values. data_ holds the values in LSL's
+    // multiplexed layout: sample after sample, the channels of a sample adjacent (a numChannels x numSamples
+    // MATLAB matrix). timeStamps_ (system time = LSL local clock, us) holds one timestamp per sample, if
+    // empty the samples are stamped with the current time. LSL converts the values if T does not match
+    // the outlet's channel format
+    template <typename T>
+    void pushNumericChunk(uint32_t id_, std::span<const T> data_, std::span<const int64_t> timeStamps_ = {});
+    // open an outlet for string markers (e.g. experiment events): one cf_string channel, irregular rate.
+    // type_ defaults to "Markers", sourceID_ to "LSL_streamer:<name_>"
+    [[nodiscard]] uint32_t createMarkerOutlet(std::string name_, std::optional<std::string> type_ = std::nullopt, std::optional<std::string> sourceID_ = std::nullopt);
+    // send a marker right away (not batched with later samples). It is timestamped with timeStamp_ if
+    // provided, else with the current system time (us), which is the LSL clock (see CheckClocks()) and
+    // thus the time base of the gaze and other samples. Returns the timestamp the marker was sent with
+    int64_t pushMarker(uint32_t id_, const std::string& marker_, std::optional<int64_t> timeStamp_ = std::nullopt);
+    // number of channels of the outlet (1 for marker outlets)
+    size_t getOutletNumChannels(uint32_t id_) const;
+    void deleteOutlet(uint32_t id_);
 
 
     //// inlets
+    // All inlet functions can be called from multiple threads, also while other
+    // threads create or delete inlets. An inlet that is deleted while a call on
+    // it is in progress (or a view of it is held) lives until that call is done
+
     // query what streams are available (optionally filter by type, empty string means no filter)
     static std::vector<lsl::stream_info> getRemoteStreams(std::string stream_ = "", bool snake_case_on_stream_not_found = false);
     static std::vector<lsl::stream_info> getRemoteStreams(std::optional<Titta::Stream> stream_ = {});
-    // subscribe to stream, allocate buffer resources
+    // subscribe to stream, allocate buffer resources. Streams that are not LSL_streamer streams are
+    // accepted if their channel format is numeric, they get a generic numeric inlet (see consumeNumericN()),
+    // or if they have a single string channel, they get a marker inlet (consumeN<marker>() etc)
     [[nodiscard]] uint32_t createListener(lsl::stream_info streamInfo_, std::optional<size_t> initialBufferSize_ = std::nullopt, std::optional<bool> doStartListening_ = std::nullopt);
     [[nodiscard]] uint32_t createListener(std::string streamSourceID_, std::optional<size_t> initialBufferSize_ = std::nullopt, std::optional<bool> doStartListening_ = std::nullopt);
 
+    // typed handle to the inlet, see InletHandle. Errors if the inlet is not of type DataType
+    template <typename DataType>
+    InletHandle<DataType> getInletHandle(uint32_t id_) const;
+
     // info about inlet (desc is set now)
     lsl::stream_info getInletInfo(uint32_t id_) const;
     Titta::Stream    getInletType(uint32_t id_) const;
+    // generic numeric and marker inlets both have type Titta::Stream::Unknown, this tells them apart
+    bool             isMarkerInlet(uint32_t id_) const;
+    // offset (s) to add to the inlet's remote timestamps to map them to local LSL time
+    // (lsl::stream_inlet::time_correction()). Blocks until the first estimate is available, or timeout_ (s)
+    double           getInletTimeCorrection(uint32_t id_, std::optional<double> timeout_ = std::nullopt) const;
 
     // actually start pulling samples from it
     void startListening(uint32_t id_);
@@ -102,21 +441,104 @@ public:
     // consume samples (by default all)
     template <typename DataType>    // e.g. LSL_streamer::gaze
     std::vector<DataType> consumeN(uint32_t id_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt);
-    // consume samples within given timestamps (inclusive, by default whole buffer)
+    // consume samples within given timestamps (inclusive, by default whole buffer). Timestamps are on
+    // the given clock, by default local time. Samples are returned from the first with a timestamp
+    // at or after timeStart_ up to the last with a timestamp at or before timeEnd_, which is correct
+    // also when timestamps on a clock do not always increase (e.g. local time when the time
+    // correction steps back). Positioning samples are timestamped with the system time at which the
+    // Tobii SDK delivered them, time ranges on the device clock are not available for them, nor for markers
     template <typename DataType>
-    std::vector<DataType> consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<bool> timeIsLocalTime_ = std::nullopt);
+    std::vector<DataType> consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
 
     // peek samples (by default only last one, can specify how many to peek, and from which side of buffer)
     template <typename DataType>
     std::vector<DataType> peekN(uint32_t id_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt);
     // peek samples within given timestamps (inclusive, by default whole buffer)
     template <typename DataType>
-    std::vector<DataType> peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<bool> timeIsLocalTime_ = std::nullopt);
+    std::vector<DataType> peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
+
+    // as consumeN, consumeTimeRange, peekN and peekTimeRange, for generic numeric inlets. The samples'
+    // channel values are copied out in one block per call. Numeric samples have no device timestamp.
+    // Cursors, views and InletHandles are not available for numeric inlets
+    NumericSamples consumeNumericN(uint32_t id_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt);
+    NumericSamples consumeNumericTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
+    NumericSamples peekNumericN(uint32_t id_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt);
+    NumericSamples peekNumericTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
+
+    // consume or peek a time range of multiple inlets in one call. All inlets are locked together, so
+    // the samples are a consistent snapshot: no inlet receives samples while the others are read.
+    // If toWatermark_ is set (default), the range is cut off at the common watermark, the newest
+    // timestamp up to which all inlets have received samples (the oldest of the newest timestamps the
+    // inlets have received, whether or not those samples are still in the buffer; inlets that have
+    // not received any samples yet are not considered), so that every stream is complete up to the
+    // same time point and later calls continue where this one stopped. Streams with an irregular
+    // sampling rate (e.g. external signals, markers) are not considered either: they may not send
+    // anything for a long time, and would hold the watermark back to their last sample. Their
+    // samples up to the watermark are taken as they are. Unset toWatermark_ to just take a snapshot
+    // of the requested range. Each inlet may only be given once
+    SampleBundle consumeTimeRangeMulti(std::span<const uint32_t> ids_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt, std::optional<bool> toWatermark_ = std::nullopt);
+    SampleBundle peekTimeRangeMulti(std::span<const uint32_t> ids_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt, std::optional<bool> toWatermark_ = std::nullopt);
+
+    // gaze samples within given timestamps (inclusive, by default whole buffer), each joined with the
+    // most recent external signal at or before it (as-of join) and, if a time sync inlet is given, the
+    // round trip time of the most recent time synchronization. Computed in a single pass over the
+    // inlets' buffers, which are locked together. Samples are not removed (as peekTimeRange). The join
+    // takes timestamps to increase, if they step back it follows the order in which samples arrived
+    GazeWithSignals peekGazeWithSignals(uint32_t gazeId_, uint32_t extSignalId_, std::optional<uint32_t> timeSyncId_ = std::nullopt, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
+    // resample gaze and numeric inlets onto a common grid of rate_ (Hz) points from timeStart_ up
+    // to timeEnd_ (inclusive), using local timestamps. Positions and other continuous values are
+    // interpolated linearly, gaze validity and availability flags and integer numeric channels are
+    // taken from the nearest sample. Samples are not removed. Inlets are resampled in parallel,
+    // each is only locked while its samples in the range are copied. The grid only holds the
+    // points that fall within the time extent of the inlets' samples (all inlets together), so it
+    // is empty if the inlets have no samples in the range. At most 100 million points are made
+    ResampledBundle resample(std::span<const uint32_t> ids_, double rate_, int64_t timeStart_, int64_t timeEnd_);
+
+    // memory budgets (bytes, 0 to remove the budget). Incoming samples are
+    // checked against both the inlet's and the global budget (all inlets of
+    // this LSL_streamer together). When over the global budget, the inlet
+    // receiving the sample gives way, according to the global policy
+    void setMemoryBudget(uint32_t id_, size_t bytes_, std::optional<MemoryPolicy> policy_ = std::nullopt);
+    void setGlobalMemoryBudget(size_t bytes_, std::optional<MemoryPolicy> policy_ = std::nullopt);
+    // directory in which SpillToDisk inlets create their segment files (default: system temp directory)
+    void setSpillDirectory(std::filesystem::path directory_);
+    MemoryStats getMemoryStats(uint32_t id_) const;
+    MemoryStats getGlobalMemoryStats() const;
+
+    // hand the storage of consumed samples back to the inlet once done with them.
+    // When a consume call takes the whole buffer, the inlet swaps in a spare
+    // buffer so that the recorder thread does not have to grow the buffer from
+    // scratch. Spare buffers are returned ones, or else are allocated by the
+    // recorder thread with the initial capacity, outside of the inlet's lock
+    // Not needed for gaze: its samples are stored packed and expanded into a new vector
+    // when consumed, so the buffer keeps its storage (returned buffers are freed)
+    template <typename DataType>
+    void returnBuffer(uint32_t id_, std::vector<DataType>&& buffer_);
+
+    // named read cursors, for multiple consumers that each need to see all samples.
+    // Each cursor has its own read position, reading through a cursor copies
+    // samples out and only advances that cursor. While an inlet has cursors,
+    // samples are removed from it once all cursors have read them (in batches,
+    // so up to about as many samples as are unread may be kept). Unread samples
+    // that a memory budget moves to disk or compresses are read from there, a
+    // cursor only misses samples that are dropped or cleared before it read them
+    void addCursor(uint32_t id_, std::string cursor_, std::optional<bool> fromStart_ = std::nullopt);  // fromStart_: start at the oldest sample in the buffer (default) or only read samples that arrive from now on
+    void removeCursor(uint32_t id_, const std::string& cursor_);
+    std::vector<std::string> getCursors(uint32_t id_) const;
+    // read samples from cursor (by default all unread samples) and advance it
+    template <typename DataType>
+    std::vector<DataType> consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_ = std::nullopt);
+
+    // as peekN and peekTimeRange, but return a view into the buffer instead of a copy
+    template <typename DataType>
+    BufferView<DataType> peekNView(uint32_t id_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<Titta::BufferSide> side_ = std::nullopt);
+    template <typename DataType>
+    BufferView<DataType> peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
 
     // clear all buffer contents
     void clear(uint32_t id_);
     // clear contents buffer within given timestamps (inclusive, by default whole buffer)
-    void clearTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<bool> timeIsLocalTime_ = std::nullopt);
+    void clearTimeRange(uint32_t id_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<TimeClock> clock_ = std::nullopt);
 
     // stop, optionally deletes the buffer. Can be continued with startListening()
     void stopListening(uint32_t id_, std::optional<bool> clearBuffer_ = std::nullopt);
@@ -136,14 +558,28 @@ private:
     friend void LSLExtSignalCallback  (TobiiResearchExternalSignalData*          ext_signal_, void* user_data);
     friend void LSLTimeSyncCallback   (TobiiResearchTimeSynchronizationData* time_sync_data_, void* user_data);
     friend void LSLPositioningCallback(TobiiResearchUserPositionGuide*        position_data_, void* user_data);
+    friend class PusherPool;
     // gaze + eye openness receiver
     void receiveSample(const TobiiResearchGazeData* gaze_data_, const TobiiResearchEyeOpennessData* openness_data_);
+    // hand sample to pusher pool, or push directly if there is no pool
+    template <typename SampleType>
+    void dispatchSample(SampleType&& sample_);
     // data pushers
     void pushSample(const Titta::gaze& sample_);
     void pushSample(Titta::eyeImage&& sample_);
     void pushSample(const Titta::extSignal& sample_);
     void pushSample(const Titta::timeSync& sample_);
-    void pushSample(const Titta::positioning& sample_);
+    void pushSample(const LSLTypes::stampedPositioning& sample_);
+    void countPushed(Titta::Stream stream_, int64_t timeStamp_);
+    // generic outlets
+    struct GenericOutlet
+    {
+        lsl::stream_outlet      outlet;
+        size_t                  numChannels;
+        lsl::channel_format_t   format;
+    };
+    std::shared_ptr<GenericOutlet> getGenericOutlet(uint32_t id_) const;
+    static void probe(ProbePoint point_, Titta::Stream stream_, int64_t timeStamp_);
     // callback registration and deregistration
     bool start(Titta::Stream stream_, std::optional<bool> asGif_ = std::nullopt);
     bool stop(Titta::Stream stream_);
@@ -154,15 +590,34 @@ private:
     // helper
     template <typename DataType>
     friend void checkInletType(AllInlets& inlet_, uint32_t id_);
-    AllInlets& getAllInletsVariant(uint32_t id_) const;
-    static std::unique_ptr<std::thread>& getWorkerThread(AllInlets& inlet_);
-    static bool getWorkerThreadStopFlag(LSL_streamer::AllInlets& inlet_);
+    // lookups hand out a reference to the inlet, keep it for as long as the inlet is used
+    std::shared_ptr<AllInlets> getAllInletsVariant(uint32_t id_) const;
+    static MemoryStats getMemoryStats(AllInlets& inlet_);
+    // final_: inlet is being deleted, its recorder cannot be started again
+    static void stopRecorder(AllInlets& inlet_, bool final_ = false);
     static void setWorkerThreadStopFlag(LSL_streamer::AllInlets& inlet_);
     template <typename DataType>
-    Inlet<DataType>& getInlet(uint32_t id_) const;
+    std::shared_ptr<Inlet<DataType>> getInlet(uint32_t id_) const;
     // worker function
     template <typename DataType>
-    void recorderThreadFunc(uint32_t id_);
+    void recorderThreadFunc(Inlet<DataType>& inlet_);
+    void numericRecorderThreadFunc(Inlet<numeric>& inlet_);
+    void markerRecorderThreadFunc(Inlet<marker>& inlet_);
+    // implementation of the consume and peek functions, for id-based calls and InletHandle
+    template <typename DataType>
+    static std::vector<DataType> consumeN(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+    template <typename DataType>
+    static std::vector<DataType> consumeTimeRange(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+    template <typename DataType>
+    static std::vector<DataType> peekN(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+    template <typename DataType>
+    static std::vector<DataType> peekTimeRange(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+    template <typename DataType>
+    static BufferView<DataType> peekNView(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+    template <typename DataType>
+    static BufferView<DataType> peekTimeRangeView(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+    // implementation of consumeTimeRangeMulti and peekTimeRangeMulti
+    SampleBundle getTimeRangeMulti(std::span<const uint32_t> ids_, int64_t timeStart_, int64_t timeEnd_, TimeClock clock_, bool toWatermark_, bool consume_, std::string_view function_);
 
 
 private:
@@ -186,7 +641,28 @@ private:
     bool                            _streamingTimeSync      = false;
     bool                            _streamingPositioning   = false;
 
+    // pushing to outlets
+    std::shared_ptr<PusherPool>     _pusherPool;
+    size_t                          _pusherLane             = 0;
+    struct OutletCounters
+    {
+        std::atomic<uint64_t>       posted                  = 0;
+        std::atomic<uint64_t>       pushed                  = 0;
+        std::atomic<int64_t>        lastTimeStamp           = 0;
+
+        void reset() { posted = 0; pushed = 0; lastTimeStamp = 0; }
+    };
+    // one per stream, so that nothing is inserted or removed while pusher threads update them
+    std::array<OutletCounters,
+               static_cast<size_t>(Titta::Stream::Last)>
+                                    _outStats;
+    static inline std::atomic<probe_fun_t>
+                                    _probe                  = nullptr;
+    // generic outlets, by id
+    InletRegistry<GenericOutlet>    _genericOutlets;        // NB: safe to use from multiple threads
+
 
     // incoming
-    std::map<uint32_t, std::unique_ptr<AllInlets>>  _inStreams;
+    std::shared_ptr<MemoryAccount>  _inletMemory    = std::make_shared<MemoryAccount>();
+    InletRegistry<AllInlets>        _inStreams;     // NB: safe to use from multiple threads
 };
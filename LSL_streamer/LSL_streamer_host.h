@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
+#include <optional>
+#include <memory>
+#include <mutex>
+
+#include "LSL_streamer/LSL_streamer.h"
+
+
+// Host for streaming from multiple eye trackers from a single process. Every
+// eye tracker gets its own LSL_streamer instance (outlets thus remain
+// distinguishable by the serial number in their source_id), while all
+// instances share a single pool of pusher threads and a single stream
+// discovery service.
+class LSL_streamer_host
+{
+public:
+    LSL_streamer_host(std::optional<size_t> numPusherThreads_ = std::nullopt);
+    ~LSL_streamer_host();
+    LSL_streamer_host(const LSL_streamer_host&) = delete;
+    LSL_streamer_host& operator=(const LSL_streamer_host&) = delete;
+
+
+    //// eye trackers
+    // connect to eye tracker at given address. Returns its serial number
+    std::string connect(std::string address_);
+    void disconnect(const std::string& address_);
+    bool isConnected(const std::string& address_) const;
+    std::vector<std::string> getConnectedEyeTrackers() const;
+    // direct access to the instance handling an eye tracker. It stays alive for as
+    // long as the returned pointer is held, also if the eye tracker is disconnected
+    std::shared_ptr<LSL_streamer> getStreamer(const std::string& address_);
+
+
+    //// outlets
+    bool startOutlet(const std::string& address_, Titta::Stream stream_, std::optional<bool> asGif_ = std::nullopt);
+    bool startOutlet(const std::string& address_, std::string   stream_, std::optional<bool> asGif_ = std::nullopt, bool snake_case_on_stream_not_found = false);
+    // start the given stream on all connected eye trackers, returns true if all succeeded
+    bool startOutlets(Titta::Stream stream_, std::optional<bool> asGif_ = std::nullopt);
+    void stopOutlet(const std::string& address_, Titta::Stream stream_);
+    void stopOutlets(Titta::Stream stream_);
+
+
+    //// statistics
+    std::map<Titta::Stream, LSL_streamer::OutletStats>                          getStreamStats(const std::string& address_) const;
+    std::map<std::string, std::map<Titta::Stream, LSL_streamer::OutletStats>>   getAllStreamStats() const;
+
+
+    //// discovery
+    // streams currently visible on the network, as found by the shared discovery service
+    // (optionally filter by type, no argument means no filter)
+    std::vector<lsl::stream_info> getRemoteStreams(std::optional<Titta::Stream> stream_ = {});
+
+
+private:
+    LSL_streamer& getStreamerLocked(const std::string& address_) const;
+
+private:
+    std::shared_ptr<PusherPool>                             _pusherPool;
+    lsl::continuous_resolver                                _resolver;
+
+    std::map<std::string, std::shared_ptr<LSL_streamer>>    _streamers;     // key: eye tracker address
+    std::set<std::string>                                   _connecting;    // addresses being connected to, reserved so they are not connected to twice
+    mutable std::mutex                                      _streamersMutex;
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <array>
+#include <map>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+#include <mutex>
+#include <cstdint>
+
+// Registry of an LSL_streamer's inlets (and generic outlets), by id, that can
+// be used from multiple threads. Ids are spread over shards that each have
+// their own lock, which is only held while an entry is looked up, added or
+// removed, so threads working with different inlets hardly contend and never
+// wait for each other's consume or peek calls. Entries are reference counted:
+// a lookup hands out a shared_ptr, so an inlet that is removed while another
+// thread is using it stays alive until that thread is done with it.
+template <typename T, size_t NumShards = 16>
+class InletRegistry
+{
+public:
+    using ptr_type = std::shared_ptr<T>;
+
+    // nullptr if not found
+    ptr_type find(const uint32_t id_) const
+    {
+        const auto& shard = getShard(id_);
+        std::shared_lock l(shard.mutex);
+        const auto it = shard.entries.find(id_);
+        return it == shard.entries.end() ? nullptr : it->second;
+    }
+    bool contains(const uint32_t id_) const
+    {
+        return find(id_) != nullptr;
+    }
+
+    // returns false if an entry with that id already exists
+    bool insert(const uint32_t id_, ptr_type entry_)
+    {
+        auto& shard = getShard(id_);
+        std::unique_lock l(shard.mutex);
+        return shard.entries.try_emplace(id_, std::move(entry_)).second;
+    }
+    // returns the removed entry (nullptr if not found), so that the caller
+    // controls where its last reference is dropped
+    ptr_type remove(const uint32_t id_)
+    {
+        auto& shard = getShard(id_);
+        std::unique_lock l(shard.mutex);
+        const auto it = shard.entries.find(id_);
+        if (it == shard.entries.end())
+            return nullptr;
+        auto out = std::move(it->second);
+        shard.entries.erase(it);
+        return out;
+    }
+    // remove all entries and return them
+    std::vector<ptr_type> removeAll()
+    {
+        std::vector<ptr_type> out;
+        for (auto& shard : _shards)
+        {
+            std::unique_lock l(shard.mutex);
+            for (auto& entry : shard.entries)
+                out.push_back(std::move(entry.second));
+            shard.entries.clear();
+        }
+        return out;
+    }
+
+    // snapshot of all entries. NB: entries may be added or removed by other
+    // threads as soon as this returns
+    std::vector<ptr_type> getAll() const
+    {
+        std::vector<ptr_type> out;
+        for (const auto& shard : _shards)
+        {
+            std::shared_lock l(shard.mutex);
+            for (const auto& entry : shard.entries)
+                out.push_back(entry.second);
+        }
+        return out;
+    }
+
+private:
+    // NB: aligned so that shards' locks are not on the same cache line
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex       mutex;
+        std::map<uint32_t, ptr_type>    entries;
+    };
+    Shard&       getShard(const uint32_t id_)       { return _shards[id_ % NumShards]; }
+    const Shard& getShard(const uint32_t id_) const { return _shards[id_ % NumShards]; }
+
+private:
+    std::array<Shard, NumShards>    _shards;
+};
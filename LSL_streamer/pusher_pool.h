@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <variant>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+
+#include "Titta/Titta.h"
+#include "LSL_streamer/types.h"
+
+class LSL_streamer;
+
+// Pool of threads that push samples into LSL outlets on behalf of one or more
+// LSL_streamer instances, so that the Tobii SDK callback threads only have to
+// hand off the sample. Each LSL_streamer gets assigned a lane, all samples posted
+// to a lane are pushed in order by the lane's thread.
+class PusherPool
+{
+public:
+    using sample_type = std::variant<
+                            Titta::gaze,
+                            Titta::eyeImage,
+                            Titta::extSignal,
+                            Titta::timeSync,
+                            LSLTypes::stampedPositioning
+                        >;
+
+public:
+    PusherPool(size_t numThreads_ = 0);     // 0: pick based on hardware concurrency
+    ~PusherPool();
+    PusherPool(const PusherPool&) = delete;
+    PusherPool& operator=(const PusherPool&) = delete;
+
+    // get lane to post to. Lanes are handed out round-robin
+    size_t  getLane();
+    size_t  getNumLanes() const { return _lanes.size(); }
+    size_t  getQueueSize(size_t lane_) const;
+
+    void    post(size_t lane_, LSL_streamer* streamer_, sample_type&& sample_);
+    // block until all samples posted to the lane before this call have been pushed
+    void    flush(size_t lane_);
+
+private:
+    struct Item
+    {
+        LSL_streamer*                               streamer;
+        std::variant<sample_type, std::promise<void>> payload;   // promise is used as flush marker
+    };
+    struct Lane
+    {
+        mutable std::mutex                          mutex;
+        std::condition_variable                     cv;
+        std::deque<Item>                            queue;
+        bool                                        shouldStop = false;
+        std::thread                                 thread;
+    };
+
+    void workerThreadFunc(Lane& lane_);
+
+private:
+    std::vector<std::unique_ptr<Lane>>  _lanes;
+    std::atomic<size_t>                 _nextLane = 0;
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <memory>
+#include <optional>
+#include <filesystem>
+#include <fstream>
+#include <cstdint>
+
+#include "Titta/types.h"
+#include "Titta/Titta.h"
+#include "LSL_streamer/types.h"
+
+class MappedFile;
+
+// Native recording format for LSL_streamer samples (LSL_streamer::gaze,
+// ::eyeImage, ::extSignal, ::timeSync and ::positioning, one type per file).
+// Samples are stored in blocks, within a block each field (column) is
+// compressed separately (see src/column_codec.h). An index at the end of the
+// file holds, per block, its location and the range of remote and local
+// timestamps it covers, so that a reader can find the blocks overlapping a time
+// range with a binary search and only decode those. Files are read through a
+// memory mapping, so only the touched blocks are paged in.
+namespace Recording
+{
+    // Writes samples to a new recording. Samples must be appended in the order
+    // they were received (as they are stored in an inlet's buffer). The file is
+    // only complete (readable) once close() has been called, the destructor
+    // does so but cannot report failure to write the file, close() does
+    template <typename DataType>    // e.g. LSL_streamer::gaze
+    class Writer
+    {
+    public:
+        Writer(const std::filesystem::path& file_, std::optional<size_t> blockSize_ = std::nullopt);     // blockSize_: samples per block
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void    append(std::span<const DataType> samples_);
+        // write the remaining samples and the index
+        void    close();
+
+        size_t  size() const { return _numSamples + _pending.size(); }
+
+    private:
+        struct BlockInfo
+        {
+            uint64_t    offset;
+            uint32_t    size;
+            uint32_t    numSamples;
+            int64_t     remoteMin, remoteMax;
+            int64_t     localMin, localMax;
+        };
+
+        void    writeBlock();
+
+    private:
+        std::ofstream           _file;
+        size_t                  _blockSize;
+        std::vector<DataType>   _pending;
+        std::vector<BlockInfo>  _blocks;
+        uint64_t                _offset     = 0;
+        uint64_t                _numSamples = 0;
+        bool                    _isOpen     = false;
+    };
+
+    // Reads a recording. Const member functions are safe to call concurrently
+    template <typename DataType>
+    class Reader
+    {
+    public:
+        explicit Reader(const std::filesystem::path& file_);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        size_t  size() const;
+        size_t  getNumBlocks() const;
+
+        // samples within given timestamps (inclusive, by default whole file)
+        std::vector<DataType> readTimeRange(std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<bool> timeIsLocalTime_ = std::nullopt) const;
+        // decode the given block
+        std::vector<DataType> readBlock(size_t block_) const;
+
+    private:
+        std::unique_ptr<MappedFile> _file;
+        const void*                 _index      = nullptr;  // points into the mapping
+        size_t                      _numBlocks  = 0;
+        size_t                      _numSamples = 0;
+    };
+
+    // convenience: open file_, read the samples within given timestamps
+    template <typename DataType>
+    std::vector<DataType> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<bool> timeIsLocalTime_ = std::nullopt);
+}
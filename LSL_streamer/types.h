@@ -1,8 +1,47 @@
 #pragma once
+#include <array>
+#include <vector>
+#include <string>
+#include <variant>
+#include <cstdint>
+#include <type_traits>
+
 #include "Titta/types.h"
 
 namespace LSLTypes
 {
+    // clock a time range refers to: the sending machine's LSL clock (remote),
+    // that time mapped to the local LSL clock with the inlet's time correction
+    // (local), or the eye tracker's clock (device, not available for
+    // positioning, numeric and marker data). Converts from the
+    // timeIsLocalTime flag that time range functions used to take: true is
+    // Local, false is Remote
+    class TimeClock
+    {
+    public:
+        enum Value : uint8_t { Remote, Local, Device };
+        static constexpr size_t numClocks = 3;
+
+        constexpr TimeClock(const Value value_) : _value(value_) {}
+        constexpr TimeClock(const bool timeIsLocalTime_) : _value(timeIsLocalTime_ ? Local : Remote) {}
+        constexpr operator Value() const { return _value; }
+
+    private:
+        Value _value;
+    };
+
+    // sorted run of timestamps in an inlet's buffer (src/time_index.h): index of
+    // its first sample, the largest timestamp of all runs up to and including it
+    // and the smallest of all runs from it on
+    struct TimeRun
+    {
+        size_t  start   = 0;
+        int64_t maxUpTo = 0;
+        int64_t minFrom = 0;
+
+        bool operator==(const TimeRun&) const = default;
+    };
+
     // NB: almost the same as TobiiTypes::gazeData, but has remote and local time
     struct gaze
     {
@@ -35,7 +74,202 @@ namespace LSLTypes
     struct positioning
     {
         Titta::positioning positioningData;
-        int64_t remote_system_time_stamp;   // positioning doesn't have a timestamp, so this is timestamp at which sample was sent
+        int64_t remote_system_time_stamp;   // positioning doesn't have a timestamp, so this is the system time at which the Tobii SDK delivered the sample
         int64_t local_system_time_stamp;
     };
+    // positioning sample as handed to the outlet, stamped with the system
+    // time (us) of the Tobii SDK callback that delivered it
+    struct stampedPositioning
+    {
+        Titta::positioning positioningData;
+        int64_t system_time_stamp;
+    };
+
+    // sample of a generic numeric inlet (a stream that is not an LSL_streamer
+    // stream, with any number of channels of any numeric format). Only the
+    // timestamps are stored per sample, the inlet keeps the channel values
+    // alongside them as numericValues
+    struct numeric
+    {
+        int64_t remote_system_time_stamp;
+        int64_t local_system_time_stamp;
+    };
+    // channel values of numeric samples, column-major: the channels of a
+    // sample are contiguous and followed by those of the next sample. This is
+    // both how LSL delivers chunks (pull_chunk_multiplexed) and how MATLAB
+    // stores a channels x samples matrix. The alternative held follows the
+    // stream's channel format
+    using numericValues = std::variant<
+                            std::vector<float>,
+                            std::vector<double>,
+                            std::vector<int8_t>,
+                            std::vector<int16_t>,
+                            std::vector<int32_t>,
+                            std::vector<int64_t>
+                        >;
+
+    // sample of a marker inlet (a single channel string stream, such as
+    // experiment event markers). Timestamps are those the marker was sent
+    // with, e.g. by LSL_streamer::pushMarker()
+    struct marker
+    {
+        std::string value;
+        int64_t remote_system_time_stamp;
+        int64_t local_system_time_stamp;
+    };
+
+    // Compact form in which inlets store gaze samples: all validity and
+    // availability flags in one bitmask and all positions, pupil diameters and
+    // eye openness values contiguously, making a sample about a third smaller
+    // than gaze. Samples are expanded to gaze when they leave the inlet.
+    // gazeData.system_time_stamp is not stored, in inlets it equals
+    // remote_system_time_stamp
+    struct packedGaze
+    {
+        // values per eye, in this order
+        static constexpr size_t gazePointOnDisplayArea  = 0;    // x, y
+        static constexpr size_t gazePointInUserCoords   = 2;    // x, y, z
+        static constexpr size_t pupilDiameter           = 5;
+        static constexpr size_t gazeOriginInUserCoords  = 6;    // x, y, z
+        static constexpr size_t gazeOriginInTrackBox    = 9;    // x, y, z
+        static constexpr size_t eyeOpennessDiameter     = 12;
+        static constexpr size_t numValuesPerEye         = 13;
+        // flag bits per eye: validity and availability of gaze point, pupil,
+        // gaze origin and eye openness. Right eye flags are shifted by rightEyeShift
+        enum flags_t : uint32_t
+        {
+            GazePointValid          = 1 << 0,
+            GazePointAvailable      = 1 << 1,
+            PupilValid              = 1 << 2,
+            PupilAvailable          = 1 << 3,
+            GazeOriginValid         = 1 << 4,
+            GazeOriginAvailable     = 1 << 5,
+            EyeOpennessValid        = 1 << 6,
+            EyeOpennessAvailable    = 1 << 7,
+        };
+        static constexpr int rightEyeShift = 8;
+
+        int64_t device_time_stamp;
+        int64_t remote_system_time_stamp;
+        int64_t local_system_time_stamp;
+        std::array<float, 2 * numValuesPerEye> values;  // left eye, then right eye
+        uint32_t flags;
+    };
+
+    template <typename DataType>
+    constexpr bool hasDeviceTimeStamp_v = !std::is_same_v<DataType, positioning> && !std::is_same_v<DataType, numeric> && !std::is_same_v<DataType, marker>;
+    // timestamp of a sample (stored or expanded) on the given clock.
+    // NB: returns 0 for the device clock if the sample has no device timestamp
+    template <typename DataType>
+    int64_t getTimeStamp(const DataType& sample_, const TimeClock clock_)
+    {
+        switch (clock_)
+        {
+        case TimeClock::Remote:
+            return sample_.remote_system_time_stamp;
+        case TimeClock::Local:
+            return sample_.local_system_time_stamp;
+        default:
+            if      constexpr (std::is_same_v<DataType, gaze>)
+                return sample_.gazeData.device_time_stamp;
+            else if constexpr (std::is_same_v<DataType, packedGaze>)
+                return sample_.device_time_stamp;
+            else if constexpr (std::is_same_v<DataType, eyeImage>)
+                return sample_.eyeImageData.device_time_stamp;
+            else if constexpr (std::is_same_v<DataType, extSignal>)
+                return sample_.extSignalData.device_time_stamp;
+            else if constexpr (std::is_same_v<DataType, timeSync>)
+                return sample_.timeSyncData.device_time_stamp;
+            else
+                return 0;
+        }
+    }
+
+    // type in which samples of DataType are stored in inlet buffers: the
+    // sample itself, except for gaze
+    template <typename DataType>
+    struct storage
+    {
+        using type = DataType;
+        static const DataType& unpack(const DataType& sample_) { return sample_; }
+    };
+    template <>
+    struct storage<gaze>
+    {
+        using type = packedGaze;
+        static packedGaze pack(const gaze& sample_)
+        {
+            const auto& g = sample_.gazeData;
+            packedGaze out{ g.device_time_stamp, sample_.remote_system_time_stamp, sample_.local_system_time_stamp, {}, 0 };
+            const auto packEye = [&out](const auto& eye_, float* v_, const int shift_)
+            {
+                v_[packedGaze::gazePointOnDisplayArea  ] = eye_.gaze_point.position_on_display_area.x;
+                v_[packedGaze::gazePointOnDisplayArea+1] = eye_.gaze_point.position_on_display_area.y;
+                v_[packedGaze::gazePointInUserCoords   ] = eye_.gaze_point.position_in_user_coordinates.x;
+                v_[packedGaze::gazePointInUserCoords +1] = eye_.gaze_point.position_in_user_coordinates.y;
+                v_[packedGaze::gazePointInUserCoords +2] = eye_.gaze_point.position_in_user_coordinates.z;
+                v_[packedGaze::pupilDiameter           ] = eye_.pupil.diameter;
+                v_[packedGaze::gazeOriginInUserCoords  ] = eye_.gaze_origin.position_in_user_coordinates.x;
+                v_[packedGaze::gazeOriginInUserCoords+1] = eye_.gaze_origin.position_in_user_coordinates.y;
+                v_[packedGaze::gazeOriginInUserCoords+2] = eye_.gaze_origin.position_in_user_coordinates.z;
+                v_[packedGaze::gazeOriginInTrackBox    ] = eye_.gaze_origin.position_in_track_box_coordinates.x;
+                v_[packedGaze::gazeOriginInTrackBox  +1] = eye_.gaze_origin.position_in_track_box_coordinates.y;
+                v_[packedGaze::gazeOriginInTrackBox  +2] = eye_.gaze_origin.position_in_track_box_coordinates.z;
+                v_[packedGaze::eyeOpennessDiameter     ] = eye_.eye_openness.diameter;
+                uint32_t f = 0;
+                if (eye_.gaze_point.validity   == TOBII_RESEARCH_VALIDITY_VALID) f |= packedGaze::GazePointValid;
+                if (eye_.gaze_point.available)                                   f |= packedGaze::GazePointAvailable;
+                if (eye_.pupil.validity        == TOBII_RESEARCH_VALIDITY_VALID) f |= packedGaze::PupilValid;
+                if (eye_.pupil.available)                                        f |= packedGaze::PupilAvailable;
+                if (eye_.gaze_origin.validity  == TOBII_RESEARCH_VALIDITY_VALID) f |= packedGaze::GazeOriginValid;
+                if (eye_.gaze_origin.available)                                  f |= packedGaze::GazeOriginAvailable;
+                if (eye_.eye_openness.validity == TOBII_RESEARCH_VALIDITY_VALID) f |= packedGaze::EyeOpennessValid;
+                if (eye_.eye_openness.available)                                 f |= packedGaze::EyeOpennessAvailable;
+                out.flags |= f << shift_;
+            };
+            packEye(g.left_eye , out.values.data()                             , 0);
+            packEye(g.right_eye, out.values.data() + packedGaze::numValuesPerEye, packedGaze::rightEyeShift);
+            return out;
+        }
+        static gaze unpack(const packedGaze& sample_)
+        {
+            gaze out{};
+            const auto unpackEye = [&sample_](auto& eye_, const float* v_, const int shift_)
+            {
+                const auto f        = sample_.flags >> shift_;
+                const auto validity = [f](const uint32_t bit_) { return f & bit_ ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID; };
+                eye_.gaze_point.position_on_display_area        = { v_[packedGaze::gazePointOnDisplayArea], v_[packedGaze::gazePointOnDisplayArea+1] };
+                eye_.gaze_point.position_in_user_coordinates    = { v_[packedGaze::gazePointInUserCoords ], v_[packedGaze::gazePointInUserCoords +1], v_[packedGaze::gazePointInUserCoords +2] };
+                eye_.gaze_point.validity                        = validity(packedGaze::GazePointValid);
+                eye_.gaze_point.available                       = f & packedGaze::GazePointAvailable;
+                eye_.pupil.diameter                             = v_[packedGaze::pupilDiameter];
+                eye_.pupil.validity                             = validity(packedGaze::PupilValid);
+                eye_.pupil.available                            = f & packedGaze::PupilAvailable;
+                eye_.gaze_origin.position_in_user_coordinates   = { v_[packedGaze::gazeOriginInUserCoords], v_[packedGaze::gazeOriginInUserCoords+1], v_[packedGaze::gazeOriginInUserCoords+2] };
+                eye_.gaze_origin.position_in_track_box_coordinates = { v_[packedGaze::gazeOriginInTrackBox], v_[packedGaze::gazeOriginInTrackBox+1], v_[packedGaze::gazeOriginInTrackBox+2] };
+                eye_.gaze_origin.validity                       = validity(packedGaze::GazeOriginValid);
+                eye_.gaze_origin.available                      = f & packedGaze::GazeOriginAvailable;
+                eye_.eye_openness.diameter                      = v_[packedGaze::eyeOpennessDiameter];
+                eye_.eye_openness.validity                      = validity(packedGaze::EyeOpennessValid);
+                eye_.eye_openness.available                     = f & packedGaze::EyeOpennessAvailable;
+            };
+            unpackEye(out.gazeData.left_eye , sample_.values.data()                             , 0);
+            unpackEye(out.gazeData.right_eye, sample_.values.data() + packedGaze::numValuesPerEye, packedGaze::rightEyeShift);
+            out.gazeData.device_time_stamp  = sample_.device_time_stamp;
+            out.gazeData.system_time_stamp  = sample_.remote_system_time_stamp;
+            out.remote_system_time_stamp    = sample_.remote_system_time_stamp;
+            out.local_system_time_stamp     = sample_.local_system_time_stamp;
+            return out;
+        }
+    };
+    template <typename DataType>
+    using storage_t = typename storage<DataType>::type;
+    template <typename DataType>
+    constexpr bool isPacked_v = !std::is_same_v<storage_t<DataType>, DataType>;
+    // function object expanding a stored sample (by value for packed types, else by reference)
+    template <typename DataType>
+    struct unpack_fn
+    {
+        decltype(auto) operator()(const storage_t<DataType>& sample_) const { return storage<DataType>::unpack(sample_); }
+    };
 }
@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <optional>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#include "Titta/Titta.h"
+
+class LSL_streamer;
+
+// Records inlets of an LSL_streamer to an XDF file (https://github.com/sccn/xdf/wiki/Specifications).
+// For each inlet, its stream header (the inlet's stream info), its samples in
+// the channel layout of the stream and periodic clock offsets (the inlet's time
+// correction) are written, and a stream footer once recording of the inlet stops.
+// Samples are read through a named cursor on the inlet, so recording does not
+// consume the inlet's buffer and other readers of the inlet are unaffected.
+// A collector thread turns new samples into XDF chunks and queues them, a
+// writer thread writes queued chunks to file, so that a slow disk does not hold
+// up collection (chunks back up in the queue instead, see getStats()).
+// !NB: remove an inlet from the recorder (or stop the recorder) before deleting the inlet!
+// An inlet that can no longer be read (e.g. because it was deleted anyway) has
+// its stream finished and stops being recorded, see Stats::streamsDropped.
+// If writing to file fails, further chunks are discarded, see Stats::writeFailed.
+class XdfRecorder
+{
+public:
+    struct Stats
+    {
+        uint64_t    samplesWritten  = 0;
+        uint64_t    bytesWritten    = 0;
+        double      throughput      = 0.;   // bytes/s, average since recording started
+        double      recentThroughput= 0.;   // bytes/s, over the last about one second of writing
+        size_t      backlogChunks   = 0;    // chunks queued but not yet written
+        size_t      backlogBytes    = 0;
+        size_t      streamsDropped  = 0;    // streams that stopped being recorded because their inlet could not be read
+        bool        writeFailed     = false;// writing to file failed, chunks queued since are discarded
+    };
+
+public:
+    XdfRecorder(LSL_streamer& streamer_, const std::filesystem::path& file_, const std::vector<uint32_t>& inletIds_ = {});
+    ~XdfRecorder();
+    XdfRecorder(const XdfRecorder&) = delete;
+    XdfRecorder& operator=(const XdfRecorder&) = delete;
+
+    // start recording an inlet. fromStart_: also record the samples already in
+    // the inlet's buffer (default) or only samples that arrive from now on
+    void addInlet(uint32_t id_, std::optional<bool> fromStart_ = std::nullopt);
+    // record the inlet's remaining samples, write its footer and stop recording it
+    void removeInlet(uint32_t id_);
+    std::vector<uint32_t> getInlets() const;
+
+    // record remaining samples of all inlets, write footers, flush and close the
+    // file. Called by the destructor, recording cannot be restarted
+    void stop();
+    bool isRecording() const { return _isRecording; }
+
+    Stats getStats() const;
+
+private:
+    struct Stream
+    {
+        uint32_t        inletId;
+        uint32_t        xdfId;
+        Titta::Stream   type;
+        std::string     cursor;
+        uint64_t        sampleCount     = 0;
+        double          firstTimeStamp  = 0.;
+        double          lastTimeStamp   = 0.;
+        std::chrono::steady_clock::time_point lastClockOffset = {};
+        bool            failed          = false;    // inlet could not be read
+    };
+    struct Chunk
+    {
+        std::string     data;
+        size_t          numSamples;
+    };
+
+    // !NB: appropriate locking (_streamsMutex) is responsibility of caller!
+    // if the inlet cannot be read, the stream is marked as failed
+    void collect(Stream& stream_, bool force_clock_offset_);
+    template <typename DataType>
+    void collectSamples(Stream& stream_);
+    void finishStream(Stream& stream_);
+
+    void enqueue(std::string&& data_, size_t numSamples_ = 0);
+
+    void collectorThreadFunc();
+    void writerThreadFunc();
+
+private:
+    LSL_streamer&               _streamer;
+    std::ofstream               _file;
+    std::unique_ptr<char[]>     _fileBuffer;
+
+    mutable std::mutex          _streamsMutex;
+    std::vector<Stream>         _streams;
+    uint32_t                    _nextXdfId = 1;
+
+    std::mutex                  _queueMutex;
+    std::condition_variable     _queueCv;
+    std::deque<Chunk>           _queue;
+
+    std::mutex                  _collectorMutex;
+    std::condition_variable     _collectorCv;
+    bool                        _stopCollector = false;
+    bool                        _stopWriter    = false;
+    std::thread                 _collector;
+    std::thread                 _writer;
+    std::atomic<bool>           _isRecording   = true;
+
+    std::chrono::steady_clock::time_point _startTime;
+    std::atomic<uint64_t>       _samplesWritten = 0;
+    std::atomic<uint64_t>       _bytesWritten   = 0;
+    std::atomic<double>         _recentThroughput = 0.;
+    std::atomic<size_t>         _backlogChunks  = 0;
+    std::atomic<size_t>         _backlogBytes   = 0;
+    std::atomic<size_t>         _streamsDropped = 0;
+    std::atomic<bool>           _writeFailed    = false;
+};
@@ -0,0 +1,342 @@
+// Microbenchmarks for the inlet buffer operations that back every consume,
+// peek and clear call (src/buffer_ops.h). Each operation is run on buffers of
+// various sizes, with the same locking as LSL_streamer uses, optionally while a
+// writer thread is appending samples to the buffer like an inlet's recorder
+// thread does. Operations that modify the buffer get a freshly filled buffer
+// for each repetition. Neither refilling nor destruction of the returned
+// samples is included in the timing.
+// The compress and decompress operations measure the compressed tier of the
+// Compress memory policy (src/compressed_store.h), decompress ops run on a store
+// built once from the same samples. The compression ratio is printed to stderr,
+// decode throughput is n_affected over the time per call. NB: the synthetic
+// samples only have varying timestamps, so compress better than real data.
+//
+// usage: bufferOps [--types gaze,extSignal] [--sizes 1000,10000,100000,1000000,10000000]
+//                  [--writer none,2400] [--min-time <s>] [--max-bytes <n>]
+//                  [--format csv|json] [--output <file>]
+// --writer lists the configurations to run: "none" for no concurrent writer,
+// or the rate (Hz) at which the writer appends samples (0: as fast as possible)
+// --types gazePacked runs on gaze samples in the packed form in which inlets
+// store them (LSLTypes::packedGaze), gaze on the expanded form
+#include "LSL_streamer/LSL_streamer.h"
+#include "src/buffer_ops.h"
+#include "src/compressed_store.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <format>
+
+
+void DoExitWithMsg(std::string errMsg_);
+void RelayMsg(std::string msg_);
+
+namespace
+{
+    struct Options
+    {
+        std::vector<std::string>    types       = {"gaze", "extSignal"};
+        std::vector<size_t>         sizes       = {1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+        std::vector<std::string>    writers     = {"none", "2400"};
+        double                      minTime     = .25;          // s per case
+        size_t                      maxBytes    = size_t{1} << 30;  // skip buffers larger than this
+        std::string                 format      = "csv";
+        std::string                 output;
+    };
+
+    struct Result
+    {
+        std::string type;
+        size_t      bufferSize;
+        std::string writer;
+        std::string op;
+        size_t      nAffected;      // number of samples returned or removed
+        size_t      reps;
+        double      min, median, mean;  // ns per call
+    };
+
+    int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::vector<std::string> split(const std::string& str_)
+    {
+        std::vector<std::string> out;
+        std::stringstream ss(str_);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                out.push_back(item);
+        return out;
+    }
+
+    constexpr int64_t samplePeriod = 417;   // us, 2400 Hz
+
+    template <typename DataType>
+    DataType makeSample(const int64_t i_)
+    {
+        DataType s{};
+        s.remote_system_time_stamp  = i_ * samplePeriod;
+        s.local_system_time_stamp   = i_ * samplePeriod + 1'000;
+        return s;
+    }
+
+    // buffer plus lock, as in an inlet
+    template <typename DataType>
+    struct Buffer
+    {
+        mutex_type              mutex;
+        std::vector<DataType>   buf;
+    };
+
+    // appends samples to the buffer, as an inlet's recorder thread does
+    template <typename DataType>
+    class Writer
+    {
+    public:
+        Writer(Buffer<DataType>& buffer_, const double rate_, const int64_t firstIdx_) :
+            _thread([this, &buffer_, rate_, firstIdx_]
+            {
+                const auto period = rate_ > 0. ? static_cast<int64_t>(1e9 / rate_) : 0;
+                auto next = nowNs();
+                for (int64_t i = firstIdx_; !_shouldStop; i++)
+                {
+                    {
+                        write_lock l(buffer_.mutex);
+                        buffer_.buf.push_back(makeSample<DataType>(i));
+                    }
+                    if (period)
+                    {
+                        next += period;
+                        std::this_thread::sleep_for(std::chrono::nanoseconds(next - nowNs()));
+                    }
+                }
+            })
+        {}
+        ~Writer()
+        {
+            _shouldStop = true;
+            _thread.join();
+        }
+
+    private:
+        std::atomic<bool>   _shouldStop = false;
+        std::thread         _thread;
+    };
+
+    // run op until minTime has elapsed (at least 5 times), refilling the buffer before each call
+    template <typename DataType>
+    Result runOp(Buffer<DataType>& buffer_, const std::vector<DataType>& reference_, const std::function<size_t(Buffer<DataType>&, std::vector<DataType>&)>& op_, const bool refill_, const Options& opt_)
+    {
+        std::vector<double> times;
+        size_t nAffected = 0;
+        const auto tEnd = nowNs() + static_cast<int64_t>(opt_.minTime * 1e9);
+        while (nowNs() < tEnd || times.size() < 5)
+        {
+            if (refill_ || times.empty())
+            {
+                write_lock l(buffer_.mutex);
+                buffer_.buf = reference_;
+            }
+            // returned samples are destroyed outside of the timed region
+            std::vector<DataType> result;
+            const auto t0 = nowNs();
+            nAffected = op_(buffer_, result);
+            times.push_back(static_cast<double>(nowNs() - t0));
+        }
+
+        Result r{};
+        r.nAffected = nAffected;
+        r.reps      = times.size();
+        std::ranges::sort(times);
+        r.min       = times.front();
+        r.median    = times[times.size() / 2];
+        double sum  = 0.;
+        for (const auto t : times)
+            sum += t;
+        r.mean      = sum / static_cast<double>(times.size());
+        return r;
+    }
+
+    // scans over views store their result here, so that they are not optimized out
+    volatile int64_t viewSink = 0;
+
+    template <typename DataType>
+    std::vector<Result> runType(const std::string& typeName_, const Options& opt_)
+    {
+        using namespace BufferOps;
+        std::vector<Result> out;
+        for (const auto size : opt_.sizes)
+        {
+            if (size * sizeof(DataType) > opt_.maxBytes)
+            {
+                std::cerr << std::format("skipping {} buffer of {} samples: exceeds --max-bytes", typeName_, size) << std::endl;
+                continue;
+            }
+
+            std::vector<DataType> reference;
+            reference.reserve(size);
+            for (size_t i = 0; i < size; i++)
+                reference.push_back(makeSample<DataType>(static_cast<int64_t>(i)));
+            // time range covering the middle 10% of the buffer
+            const auto midStart = reference[size * 45 / 100].remote_system_time_stamp;
+            const auto midEnd   = reference[size * 55 / 100].remote_system_time_stamp;
+            const auto n10      = std::max<size_t>(size / 10, 1);
+
+            std::shared_ptr<CompressedStore<DataType>> compressed;
+            if constexpr (hasOlderTier_v<DataType>)
+            {
+                compressed = std::make_shared<CompressedStore<DataType>>();
+                compressed->append(reference);
+                std::cerr << std::format("{}, {} samples: compression ratio {:.2f}", typeName_, size, static_cast<double>(size * sizeof(DataType)) / static_cast<double>(std::max<size_t>(compressed->bytes(), 1))) << std::endl;
+            }
+
+            using op_t = std::function<size_t(Buffer<DataType>&, std::vector<DataType>&)>;
+            const std::vector<std::tuple<std::string, op_t, bool>> ops = {
+                {"consumeN(1,start)",           [](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e] = getIteratorsFromSampleAndSide(b_.buf, 1, Titta::BufferSide::Start); r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"consumeN(1,end)",             [](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e] = getIteratorsFromSampleAndSide(b_.buf, 1, Titta::BufferSide::End);   r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"consumeN(10%,start)",         [n10](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e] = getIteratorsFromSampleAndSide(b_.buf, n10, Titta::BufferSide::Start); r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"consumeN(10%,end)",           [n10](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e] = getIteratorsFromSampleAndSide(b_.buf, n10, Titta::BufferSide::End);   r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"consumeN(all)",               [](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e] = getIteratorsFromSampleAndSide(b_.buf, static_cast<size_t>(-1), Titta::BufferSide::Start); r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"consumeTimeRange(mid10%)",    [=](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e, w] = getIteratorsFromTimeRange(b_.buf, midStart, midEnd, false); r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"consumeTimeRange(all)",       [](auto& b_, auto& r_) { write_lock l(b_.mutex); auto [s, e, w] = getIteratorsFromTimeRange(b_.buf, 0, std::numeric_limits<int64_t>::max(), false); r_ = consumeFromVec(b_.buf, s, e); return r_.size(); }, true},
+                {"peekN(1,end)",                [](auto& b_, auto& r_) { read_lock l(b_.mutex); auto [s, e] = getIteratorsFromSampleAndSide(b_.buf, 1, Titta::BufferSide::End); r_ = peekFromVec(b_.buf, s, e); return r_.size(); }, false},
+                {"peekTimeRange(mid10%)",       [=](auto& b_, auto& r_) { read_lock l(b_.mutex); auto [s, e, w] = getIteratorsFromTimeRange(b_.buf, midStart, midEnd, false); r_ = peekFromVec(b_.buf, s, e); return r_.size(); }, false},
+                {"peekTimeRange(mid10%,local)", [=](auto& b_, auto& r_) { read_lock l(b_.mutex); auto [s, e, w] = getIteratorsFromTimeRange(b_.buf, midStart + 1'000, midEnd + 1'000, true); r_ = peekFromVec(b_.buf, s, e); return r_.size(); }, false},
+                {"peekTimeRangeView(mid10%)",   [=](auto& b_, auto&) { read_lock l(b_.mutex); auto [s, e, w] = getIteratorsFromTimeRange(b_.buf, midStart, midEnd, false); const auto v = viewFromVec(s, e); int64_t sum = 0; for (const auto& x : v) sum += x.local_system_time_stamp; viewSink = sum; return v.size(); }, false},
+                {"clearTimeRange(mid10%)",      [=](auto& b_, auto&) { write_lock l(b_.mutex); const auto n = b_.buf.size(); clearFromVec(b_.buf, midStart, midEnd, false); return n - b_.buf.size(); }, true},
+                {"clearTimeRange(all)",         [](auto& b_, auto&) { write_lock l(b_.mutex); const auto n = b_.buf.size(); clearFromVec(b_.buf, 0, std::numeric_limits<int64_t>::max(), false); return n - b_.buf.size(); }, true},
+            };
+            const std::vector<std::tuple<std::string, op_t, bool>> compressOps = {
+                {"compress(all)",               [](auto& b_, auto&) { read_lock l(b_.mutex); CompressedStore<DataType> c; c.append(b_.buf); return c.size(); }, false},
+                {"decompress(all)",             [=](auto&, auto& r_) { r_ = compressed->read(0, compressed->size()); return r_.size(); }, false},
+                {"decompress(mid10%)",          [=](auto&, auto& r_) { r_ = compressed->read(compressed->firstAtOrAfter(midStart, LSLTypes::TimeClock::Remote), compressed->pastLastAtOrBefore(midEnd, LSLTypes::TimeClock::Remote)); return r_.size(); }, false},
+            };
+
+            for (const auto& writer : opt_.writers)
+            {
+                auto allOps = ops;
+                if (compressed)
+                    allOps.insert(allOps.end(), compressOps.begin(), compressOps.end());
+                for (const auto& [name, op, refill] : allOps)
+                {
+                    std::cerr << std::format("{}, {} samples, writer {}: {}", typeName_, size, writer, name) << std::endl;
+                    Buffer<DataType> buffer;
+                    std::unique_ptr<Writer<DataType>> w;
+                    if (writer != "none")
+                        w = std::make_unique<Writer<DataType>>(buffer, std::stod(writer), static_cast<int64_t>(size));
+
+                    auto r = runOp(buffer, reference, op, refill, opt_);
+                    w.reset();
+                    r.type       = typeName_;
+                    r.bufferSize = size;
+                    r.writer     = writer;
+                    r.op         = name;
+                    out.push_back(std::move(r));
+                }
+            }
+        }
+        return out;
+    }
+
+    void writeResults(const std::vector<Result>& results_, const Options& opt_)
+    {
+        std::ofstream file;
+        if (!opt_.output.empty())
+            file.open(opt_.output);
+        std::ostream& os = opt_.output.empty() ? std::cout : file;
+
+        if (opt_.format == "json")
+        {
+            os << "{\n";
+            os << std::format("  \"min_time_s\": {},\n", opt_.minTime);
+            os << "  \"results\": [\n";
+            for (size_t i = 0; i < results_.size(); i++)
+            {
+                const auto& r = results_[i];
+                os << std::format("    {{\"type\": \"{}\", \"buffer_size\": {}, \"writer\": \"{}\", \"op\": \"{}\", \"n_affected\": {}, \"reps\": {}, \"min_ns\": {:.0f}, \"median_ns\": {:.0f}, \"mean_ns\": {:.0f}}}{}\n",
+                    r.type, r.bufferSize, r.writer, r.op, r.nAffected, r.reps, r.min, r.median, r.mean, i + 1 < results_.size() ? "," : "");
+            }
+            os << "  ]\n}\n";
+        }
+        else
+        {
+            os << "type,buffer_size,writer,op,n_affected,reps,min_ns,median_ns,mean_ns\n";
+            for (const auto& r : results_)
+                os << std::format("{},{},{},\"{}\",{},{},{:.0f},{:.0f},{:.0f}\n",
+                    r.type, r.bufferSize, r.writer, r.op, r.nAffected, r.reps, r.min, r.median, r.mean);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        Options opt;
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string arg = argv[i], val = argv[i + 1];
+            if      (arg == "--types")      opt.types = split(val);
+            else if (arg == "--writer")     opt.writers = split(val);
+            else if (arg == "--min-time")   opt.minTime = std::stod(val);
+            else if (arg == "--max-bytes")  opt.maxBytes = std::stoull(val);
+            else if (arg == "--format")     opt.format = val;
+            else if (arg == "--output")     opt.output = val;
+            else if (arg == "--sizes")
+            {
+                opt.sizes.clear();
+                for (const auto& s : split(val))
+                    opt.sizes.push_back(std::stoull(s));
+            }
+            else
+                DoExitWithMsg(std::format("unknown argument {}", arg));
+        }
+
+        std::vector<Result> results;
+        for (const auto& type : opt.types)
+        {
+            std::vector<Result> res;
+            if      (type == "gaze")        res = runType<LSL_streamer::gaze>(type, opt);
+            else if (type == "gazePacked")  res = runType<LSLTypes::packedGaze>(type, opt);
+            else if (type == "extSignal")   res = runType<LSL_streamer::extSignal>(type, opt);
+            else if (type == "timeSync")    res = runType<LSL_streamer::timeSync>(type, opt);
+            else if (type == "positioning") res = runType<LSL_streamer::positioning>(type, opt);
+            else
+                DoExitWithMsg(std::format("type {} is not supported by this benchmark", type));
+            results.insert(results.end(), res.begin(), res.end());
+        }
+
+        writeResults(results, opt);
+    }
+    catch (const std::string& e)
+    {
+        std::cerr << "Error: " << e << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Error: Some exception occurred" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw errMsg_;
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
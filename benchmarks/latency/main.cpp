@@ -0,0 +1,523 @@
+// End-to-end latency benchmark: runs an outlet and an inlet in one process,
+// connected over localhost LSL, and timestamps each sample at Tobii SDK
+// callback entry, after it has been pushed into the outlet, when the inlet's
+// recorder thread has pulled it and when it was returned to the consumer by
+// consumeN() or peekN() (peek of the latest sample). Latencies of each stage
+// relative to callback entry (and for the callback itself, relative to the
+// sample's system timestamp) are reported as percentiles, per stream, sampling
+// rate and consumer. The "call" stage is the duration of the consumer's
+// consumeN() or peekN() calls themselves. The consumeNHandle and
+// peekLatestHandle consumers make the same calls through an
+// LSL_streamer::InletHandle, which skips the inlet lookup and type check, e.g.
+// to compare per-call overhead of 1-sample peeks at 1 kHz:
+//   latency --streams gaze --rates 1000 --consumers peekLatest,peekLatestHandle
+//
+// Rates can only be varied when built against the Tobii SDK mock
+// (LSL_STREAMER_TOBII_MOCK defined), with real hardware the eye tracker's
+// current frequency is used.
+//
+// The markers stream measures a marker outlet (LSL_streamer::pushMarker())
+// instead, with markers pushed at the requested rates by a separate thread.
+// Its stages are relative to the start of the pushMarker() call, the "emit"
+// stage is the duration of that call (target: well below 100 us). No eye
+// tracker is needed when only markers are measured:
+//   latency --streams markers --rates 10,100,1000 --consumers consumeN
+//
+// usage: latency [--address <eye tracker address>] [--streams gaze,extSignal,timeSync,markers]
+//                [--rates 60,120,250,600,1200,2400] [--consumers consumeN,peekLatest,consumeNHandle,peekLatestHandle]
+//                [--duration <s>] [--poll-interval <us>] [--pusher-threads <n>]
+//                [--format csv|json] [--output <file>]
+#include "LSL_streamer/LSL_streamer.h"
+#ifdef LSL_STREAMER_TOBII_MOCK
+#   include "tobii_research_mock/tobii_research_mock.h"
+#endif
+
+#include <Titta/Titta.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <format>
+
+
+void DoExitWithMsg(std::string errMsg_);
+void RelayMsg(std::string msg_);
+
+namespace
+{
+    struct Options
+    {
+        std::string                 address;
+        std::vector<std::string>    streams         = {"gaze", "extSignal", "timeSync"};
+        std::vector<float>          rates           = {60.f, 120.f, 250.f, 600.f, 1200.f, 2400.f};
+        std::vector<std::string>    consumers       = {"consumeN", "peekLatest"};
+        double                      duration        = 5.;       // s
+        int64_t                     pollInterval    = 100;      // us
+        size_t                      pusherThreads   = 0;        // 0: push on callback thread
+        std::string                 format          = "csv";
+        std::string                 output;
+    };
+
+    struct Result
+    {
+        std::string stream;
+        std::string channelFormat;
+        int32_t     numChannels;
+        float       rate;
+        std::string consumer;
+        std::string stage;
+        size_t      n;
+        double      p50, p99, p999, max, mean;     // us
+    };
+
+    int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::vector<std::string> split(const std::string& str_)
+    {
+        std::vector<std::string> out;
+        std::stringstream ss(str_);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                out.push_back(item);
+        return out;
+    }
+
+    // recording of probe events. Slots are claimed lock-free, as probes fire
+    // on the SDK's callback thread, pusher threads and the recorder thread
+    constexpr size_t numProbePoints = 3;
+    struct Event
+    {
+        int64_t key;    // sample timestamp (us)
+        int64_t t;      // time event happened (ns)
+    };
+    struct Recorder
+    {
+        std::atomic<Titta::Stream>  stream = Titta::Stream::Unknown;
+        std::vector<Event>          events[numProbePoints];
+        std::atomic<size_t>         nEvents[numProbePoints];
+
+        void reset(const Titta::Stream stream_, const size_t capacity_)
+        {
+            stream = Titta::Stream::Unknown;
+            for (size_t p = 0; p < numProbePoints; p++)
+            {
+                events[p].assign(capacity_, {});
+                nEvents[p] = 0;
+            }
+            stream = stream_;
+        }
+        size_t size(const size_t point_) const
+        {
+            return std::min(nEvents[point_].load(), events[point_].size());
+        }
+    } recorder;
+
+    void probe(const LSL_streamer::ProbePoint point_, const Titta::Stream stream_, const int64_t timeStamp_)
+    {
+        if (stream_ != recorder.stream.load(std::memory_order_relaxed))
+            return;
+        const auto p = static_cast<size_t>(point_);
+        if (const auto idx = recorder.nEvents[p].fetch_add(1, std::memory_order_relaxed); idx < recorder.events[p].size())
+            recorder.events[p][idx] = {timeStamp_, nowNs()};
+    }
+
+    std::string channelFormatToString(const lsl::channel_format_t format_)
+    {
+        switch (format_)
+        {
+            case lsl::cf_float32:   return "float32";
+            case lsl::cf_double64:  return "double64";
+            case lsl::cf_string:    return "string";
+            case lsl::cf_int32:     return "int32";
+            case lsl::cf_int16:     return "int16";
+            case lsl::cf_int8:      return "int8";
+            case lsl::cf_int64:     return "int64";
+            default:                return "undefined";
+        }
+    }
+
+    Result summarize(std::vector<double> lat_, std::string stage_)
+    {
+        Result r{};
+        r.stage = std::move(stage_);
+        r.n     = lat_.size();
+        if (lat_.empty())
+            return r;
+        std::ranges::sort(lat_);
+        const auto pct = [&lat_](const double p_)
+        {
+            // nearest-rank percentile
+            const auto rank = static_cast<size_t>(std::ceil(p_ / 100. * static_cast<double>(lat_.size())));
+            return lat_[std::clamp<size_t>(rank, 1, lat_.size()) - 1];
+        };
+        r.p50   = pct(50.);
+        r.p99   = pct(99.);
+        r.p999  = pct(99.9);
+        r.max   = lat_.back();
+        double sum = 0.;
+        for (const auto l : lat_)
+            sum += l;
+        r.mean  = sum / static_cast<double>(lat_.size());
+        return r;
+    }
+
+    // latency (us) of events relative to the reference time (ns) of the sample they concern
+    std::vector<double> latencySince(const std::unordered_map<int64_t, int64_t>& refT_, const Event* begin_, const Event* end_)
+    {
+        std::vector<double> out;
+        for (auto e = begin_; e != end_; ++e)
+        {
+            // timestamps went through a conversion to seconds (double) and back,
+            // allow for rounding differences
+            for (const auto key : {e->key, e->key + 1, e->key - 1})
+            {
+                if (const auto it = refT_.find(key); it != refT_.end())
+                {
+                    out.push_back(static_cast<double>(e->t - it->second) / 1000.);
+                    break;
+                }
+            }
+        }
+        return out;
+    }
+    std::vector<double> probeLatencySince(const std::unordered_map<int64_t, int64_t>& refT_, const LSL_streamer::ProbePoint point_)
+    {
+        const auto p = static_cast<size_t>(point_);
+        return latencySince(refT_, recorder.events[p].data(), recorder.events[p].data() + recorder.size(p));
+    }
+
+    // run the consumer on the inlet for the benchmark's duration, recording
+    // when each new sample was returned and how long each call took
+    template <typename DataType>
+    void pollInlet(LSL_streamer& streamer_, const uint32_t id_, const std::string& consumer_, const Options& opt_, std::vector<Event>& consumed_, std::vector<double>& callDuration_)
+    {
+        consumed_.reserve(recorder.events[0].size());
+        callDuration_.reserve(static_cast<size_t>(opt_.duration * 1e6 / static_cast<double>(std::max<int64_t>(opt_.pollInterval, 1))) + 1000);
+        const bool peekLatest = consumer_.starts_with("peekLatest");
+        const auto handle     = consumer_.ends_with("Handle") ? streamer_.getInletHandle<DataType>(id_) : LSL_streamer::InletHandle<DataType>{};
+        int64_t lastSeen = std::numeric_limits<int64_t>::min();
+        const auto tEnd = nowNs() + static_cast<int64_t>(opt_.duration * 1e9);
+        while (nowNs() < tEnd)
+        {
+            const auto t0 = nowNs();
+            const auto samples = handle ?
+                (peekLatest ? handle.peekN() : handle.consumeN()) :
+                (peekLatest ? streamer_.peekN<DataType>(id_) : streamer_.consumeN<DataType>(id_));
+            const auto t = nowNs();
+            callDuration_.push_back(static_cast<double>(t - t0) / 1000.);
+            for (const auto& s : samples)
+            {
+                if (s.remote_system_time_stamp <= lastSeen)
+                    continue;
+                lastSeen = s.remote_system_time_stamp;
+                consumed_.push_back({s.remote_system_time_stamp, t});
+            }
+            if (opt_.pollInterval > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(opt_.pollInterval));
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    template <typename DataType>
+    std::vector<Result> runOne(LSL_streamer& streamer_, const Titta::Stream stream_, const float rate_, const std::string& consumer_, const Options& opt_)
+    {
+        // start outlet and connect an inlet to it
+        if (!streamer_.startOutlet(stream_))
+            DoExitWithMsg(std::format("could not start {} outlet", Titta::streamToString(stream_)));
+        const auto sourceID = std::format("LSL_streamer:Tobii_{}@{}", Titta::streamToString(stream_), streamer_.getSerialNumber());
+        const auto id       = streamer_.createListener(sourceID, std::nullopt, true);
+        const auto info     = streamer_.getInletInfo(id);
+
+        // warm up, then start measuring
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        streamer_.clear(id);
+        recorder.reset(stream_, static_cast<size_t>(std::max(rate_, 1.f) * opt_.duration * 1.5) + 1000);
+        LSL_streamer::setProbe(&probe);
+
+        std::vector<Event> consumed;
+        std::vector<double> callDuration;
+        pollInlet<DataType>(streamer_, id, consumer_, opt_, consumed, callDuration);
+
+        LSL_streamer::setProbe(nullptr);
+        recorder.stream = Titta::Stream::Unknown;
+        streamer_.stopOutlet(stream_);
+        streamer_.deleteListener(id);
+
+        // match up events by sample timestamp
+        std::unordered_map<int64_t, int64_t> callbackT;
+        const auto nCallback = recorder.size(static_cast<size_t>(LSL_streamer::ProbePoint::Callback));
+        callbackT.reserve(nCallback);
+        std::vector<double> latCallback;
+        for (size_t i = 0; i < nCallback; i++)
+        {
+            const auto& e = recorder.events[static_cast<size_t>(LSL_streamer::ProbePoint::Callback)][i];
+            callbackT.emplace(e.key, e.t);
+            latCallback.push_back(static_cast<double>(e.t - e.key * 1000) / 1000.);
+        }
+        const auto sinceCallback = [&callbackT](const Event* begin_, const Event* end_) { return latencySince(callbackT, begin_, end_); };
+        const auto stageLatency  = [&callbackT](const LSL_streamer::ProbePoint point_) { return probeLatencySince(callbackT, point_); };
+
+        std::vector<Result> out;
+        out.push_back(summarize(std::move(latCallback), "callback"));
+        out.push_back(summarize(stageLatency(LSL_streamer::ProbePoint::Pushed), "pushed"));
+        out.push_back(summarize(stageLatency(LSL_streamer::ProbePoint::Pulled), "pulled"));
+        out.push_back(summarize(sinceCallback(consumed.data(), consumed.data() + consumed.size()), consumer_));
+        out.push_back(summarize(std::move(callDuration), "call"));
+        for (auto& r : out)
+        {
+            r.stream        = Titta::streamToString(stream_);
+            r.channelFormat = channelFormatToString(info.channel_format());
+            r.numChannels   = info.channel_count();
+            r.rate          = rate_;
+            r.consumer      = consumer_;
+        }
+        return out;
+    }
+
+    // markers are pushed from a separate thread at the requested rate. NB: probes of the
+    // marker outlet and inlet fire with stream Titta::Stream::Unknown
+    std::vector<Result> runMarkers(LSL_streamer& streamer_, const float rate_, const std::string& consumer_, const Options& opt_)
+    {
+        // open marker outlet and connect an inlet to it
+        const std::string sourceID = "LSL_streamer:latency_markers";
+        const auto outID    = streamer_.createMarkerOutlet("latency_markers", std::nullopt, sourceID);
+        const auto id       = streamer_.createListener(sourceID, std::nullopt, true);
+        const auto info     = streamer_.getInletInfo(id);
+
+        // warm up, then start measuring
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        streamer_.clear(id);
+        const auto capacity = static_cast<size_t>(std::max(rate_, 1.f) * opt_.duration * 1.5) + 1000;
+        recorder.reset(Titta::Stream::Unknown, capacity);
+        LSL_streamer::setProbe(&probe);
+
+        std::vector<Event> sent;            // marker timestamp, time pushMarker() was called
+        std::vector<double> emitDuration;
+        sent.reserve(capacity);
+        emitDuration.reserve(capacity);
+        std::atomic<bool> stop = false;
+        std::thread producer([&]
+        {
+            const auto interval = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / std::max(rate_, 1.f)));
+            auto next = std::chrono::steady_clock::now();
+            for (size_t i = 0; !stop && sent.size() < capacity; i++)
+            {
+                std::this_thread::sleep_until(next);
+                next += interval;
+                const auto marker = std::format("marker {}", i);
+                const auto t0 = nowNs();
+                const auto ts = streamer_.pushMarker(outID, marker);
+                const auto t1 = nowNs();
+                sent.push_back({ts, t0});
+                emitDuration.push_back(static_cast<double>(t1 - t0) / 1000.);
+            }
+        });
+
+        std::vector<Event> consumed;
+        std::vector<double> callDuration;
+        pollInlet<LSL_streamer::marker>(streamer_, id, consumer_, opt_, consumed, callDuration);
+        stop = true;
+        producer.join();
+
+        LSL_streamer::setProbe(nullptr);
+        streamer_.deleteListener(id);
+        streamer_.deleteOutlet(outID);
+
+        std::unordered_map<int64_t, int64_t> pushT;
+        pushT.reserve(sent.size());
+        for (const auto& e : sent)
+            pushT.emplace(e.key, e.t);
+
+        std::vector<Result> out;
+        out.push_back(summarize(std::move(emitDuration), "emit"));
+        out.push_back(summarize(probeLatencySince(pushT, LSL_streamer::ProbePoint::Pushed), "pushed"));
+        out.push_back(summarize(probeLatencySince(pushT, LSL_streamer::ProbePoint::Pulled), "pulled"));
+        out.push_back(summarize(latencySince(pushT, consumed.data(), consumed.data() + consumed.size()), consumer_));
+        out.push_back(summarize(std::move(callDuration), "call"));
+        for (auto& r : out)
+        {
+            r.stream        = "markers";
+            r.channelFormat = channelFormatToString(info.channel_format());
+            r.numChannels   = info.channel_count();
+            r.rate          = rate_;
+            r.consumer      = consumer_;
+        }
+        return out;
+    }
+
+    void setRate(const std::string& address_, const Titta::Stream stream_, const float rate_)
+    {
+#ifdef LSL_STREAMER_TOBII_MOCK
+        auto config = TobiiMock::getEyeTrackerConfig(address_);
+        switch (stream_)
+        {
+            case Titta::Stream::Gaze:       config.gaze.frequency       = rate_;    break;
+            case Titta::Stream::ExtSignal:  config.extSignal.frequency  = rate_;    break;
+            case Titta::Stream::TimeSync:   config.timeSync.frequency   = rate_;    break;
+            default: break;
+        }
+        TobiiMock::addEyeTracker(std::move(config));
+#else
+        (void)address_; (void)stream_; (void)rate_;
+#endif
+    }
+
+    void writeResults(const std::vector<Result>& results_, const Options& opt_)
+    {
+        std::ofstream file;
+        if (!opt_.output.empty())
+            file.open(opt_.output);
+        std::ostream& os = opt_.output.empty() ? std::cout : file;
+
+        if (opt_.format == "json")
+        {
+            const auto sdk = LSL_streamer::getTobiiSDKVersion();
+            os << "{\n";
+            os << std::format("  \"lsl_version\": {},\n", LSL_streamer::getLSLVersion());
+            os << std::format("  \"tobii_sdk_version\": \"{}.{}.{}.{}\",\n", sdk.major, sdk.minor, sdk.revision, sdk.build);
+            os << std::format("  \"duration_s\": {},\n  \"poll_interval_us\": {},\n  \"pusher_threads\": {},\n", opt_.duration, opt_.pollInterval, opt_.pusherThreads);
+            os << "  \"results\": [\n";
+            for (size_t i = 0; i < results_.size(); i++)
+            {
+                const auto& r = results_[i];
+                os << std::format("    {{\"stream\": \"{}\", \"channel_format\": \"{}\", \"num_channels\": {}, \"rate_hz\": {}, \"consumer\": \"{}\", \"stage\": \"{}\", \"n\": {}, \"p50_us\": {:.3f}, \"p99_us\": {:.3f}, \"p999_us\": {:.3f}, \"max_us\": {:.3f}, \"mean_us\": {:.3f}}}{}\n",
+                    r.stream, r.channelFormat, r.numChannels, r.rate, r.consumer, r.stage, r.n, r.p50, r.p99, r.p999, r.max, r.mean, i + 1 < results_.size() ? "," : "");
+            }
+            os << "  ]\n}\n";
+        }
+        else
+        {
+            os << "stream,channel_format,num_channels,rate_hz,consumer,stage,n,p50_us,p99_us,p999_us,max_us,mean_us\n";
+            for (const auto& r : results_)
+                os << std::format("{},{},{},{},{},{},{},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}\n",
+                    r.stream, r.channelFormat, r.numChannels, r.rate, r.consumer, r.stage, r.n, r.p50, r.p99, r.p999, r.max, r.mean);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        Options opt;
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string arg = argv[i], val = argv[i + 1];
+            if      (arg == "--address")        opt.address = val;
+            else if (arg == "--streams")        opt.streams = split(val);
+            else if (arg == "--consumers")      opt.consumers = split(val);
+            else if (arg == "--duration")       opt.duration = std::stod(val);
+            else if (arg == "--poll-interval")  opt.pollInterval = std::stoll(val);
+            else if (arg == "--pusher-threads") opt.pusherThreads = std::stoull(val);
+            else if (arg == "--format")         opt.format = val;
+            else if (arg == "--output")         opt.output = val;
+            else if (arg == "--rates")
+            {
+                opt.rates.clear();
+                for (const auto& r : split(val))
+                    opt.rates.push_back(std::stof(r));
+            }
+            else
+                DoExitWithMsg(std::format("unknown argument {}", arg));
+        }
+
+        // markers do not need an eye tracker
+        const auto needEyeTracker = std::ranges::any_of(opt.streams, [](const std::string& s_) { return s_ != "markers"; });
+        if (needEyeTracker && opt.address.empty())
+        {
+            const auto eyeTrackers = Titta::findAllEyeTrackers();
+            if (eyeTrackers.empty())
+                DoExitWithMsg("no eye tracker");
+            opt.address = eyeTrackers[0].address;
+        }
+        auto streamerPtr = needEyeTracker ? std::make_unique<LSL_streamer>(opt.address) : std::make_unique<LSL_streamer>();
+        if (needEyeTracker)
+            std::cerr << "connected to: " << opt.address << std::endl;
+        auto& streamer = *streamerPtr;
+        if (opt.pusherThreads)
+            streamer.setPusherPool(std::make_shared<PusherPool>(opt.pusherThreads));
+
+        std::vector<Result> results;
+        for (const auto& streamName : opt.streams)
+        {
+            if (streamName == "markers")
+            {
+                for (const auto rate : opt.rates)
+                    for (const auto& consumer : opt.consumers)
+                    {
+                        std::cerr << std::format("{} @ {} Hz, {}", streamName, rate, consumer) << std::endl;
+                        const auto res = runMarkers(streamer, rate, consumer, opt);
+                        results.insert(results.end(), res.begin(), res.end());
+                    }
+                continue;
+            }
+            const auto stream = Titta::stringToStream(streamName, false, true);
+            for (const auto rate : opt.rates)
+            {
+                setRate(opt.address, stream, rate);
+                for (const auto& consumer : opt.consumers)
+                {
+                    std::cerr << std::format("{} @ {} Hz, {}", streamName, rate, consumer) << std::endl;
+                    std::vector<Result> res;
+                    switch (stream)
+                    {
+                        case Titta::Stream::Gaze:
+                            res = runOne<LSL_streamer::gaze>(streamer, stream, rate, consumer, opt);
+                            break;
+                        case Titta::Stream::ExtSignal:
+                            res = runOne<LSL_streamer::extSignal>(streamer, stream, rate, consumer, opt);
+                            break;
+                        case Titta::Stream::TimeSync:
+                            res = runOne<LSL_streamer::timeSync>(streamer, stream, rate, consumer, opt);
+                            break;
+                        default:
+                            DoExitWithMsg(std::format("stream {} is not supported by this benchmark", streamName));
+                    }
+                    results.insert(results.end(), res.begin(), res.end());
+                }
+#ifndef LSL_STREAMER_TOBII_MOCK
+                // rate can't be changed, no point running the other rates
+                break;
+#endif
+            }
+        }
+
+        writeResults(results, opt);
+    }
+    catch (const std::string& e)
+    {
+        std::cerr << "Error: " << e << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Error: Some exception occurred" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw errMsg_;
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
@@ -8,6 +8,7 @@
 
 
 void DoExitWithMsg(std::string errMsg_);
+void RelayMsg(std::string msg_);
 
 int main(int argc, char** argv)
 {
@@ -83,4 +84,8 @@ int main(int argc, char** argv)
 void DoExitWithMsg(std::string errMsg_)
 {
     std::cout << "Error: " << errMsg_ << std::endl;
-}
\ No newline at end of file
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
@@ -5,8 +5,15 @@
 #include <numeric>
 #include <map>
 #include <ranges>
+#include <future>
+#include <cmath>
 
 #include "Titta/utils.h"
+#include "buffer_ops.h"
+#include "spill_store.h"
+#include "compressed_store.h"
+#include "time_index.h"
+#include "sample_conversion.h"
 
 namespace
 {
@@ -26,6 +33,12 @@ namespace
 
         constexpr size_t                positioningBufSize      = 2<<11;
 
+        constexpr size_t                numericBufSize          = 2<<15;        // about half a minute at 2kHz
+        constexpr size_t                numericChunkSize        = 512;          // max samples a numeric inlet pulls from LSL at once
+
+        constexpr size_t                markerBufSize           = 2<<9;
+        constexpr auto                  markerStreamType        = "Markers";
+
         constexpr int64_t               clearTimeRangeStart     = 0;
         constexpr int64_t               clearTimeRangeEnd       = std::numeric_limits<int64_t>::max();
 
@@ -38,7 +51,17 @@ namespace
         constexpr size_t                peekNSamp               = 1;
         constexpr int64_t               peekTimeRangeStart      = 0;
         constexpr int64_t               peekTimeRangeEnd        = std::numeric_limits<int64_t>::max();
-        constexpr bool                  timeIsLocalTime         = true;
+        constexpr LSLTypes::TimeClock   timeClock               = LSLTypes::TimeClock::Local;
+        constexpr bool                  multiToWatermark        = true;
+        constexpr bool                  cursorFromStart         = true;
+        constexpr double                timeCorrectionTimeout   = 2.;
+        constexpr double                recorderPullTimeout     = 0.01;         // s, bounds how long a recorder thread takes to notice it should stop
+        constexpr size_t                bufferPoolSize          = 1;            // number of returned buffers kept per inlet
+        constexpr LSL_streamer::MemoryPolicy memoryPolicy       = LSL_streamer::MemoryPolicy::DropOldest;
+        constexpr size_t                compressBlockSize       = 1024;         // samples per compressed block
+        constexpr size_t                compressMinSamples      = 256;          // don't compress fewer samples than this at once
+        constexpr size_t                tierMigrationBatchSize  = 1<<16;        // samples moved at once when an inlet's older tier changes type
+        constexpr size_t                resampleMaxGridPoints   = 100'000'000;  // per call, bounds the memory resample() allocates
     }
 
     template <class...> constexpr std::false_type always_false{};
@@ -59,6 +82,8 @@ namespace
     template <>           struct LSLInletTypeToTittaStream<LSL_streamer::extSignal> { static constexpr Titta::Stream value = Titta::Stream::ExtSignal; };
     template <>           struct LSLInletTypeToTittaStream<LSL_streamer::timeSync> { static constexpr Titta::Stream value = Titta::Stream::TimeSync; };
     template <>           struct LSLInletTypeToTittaStream<LSL_streamer::positioning> { static constexpr Titta::Stream value = Titta::Stream::Positioning; };
+    template <>           struct LSLInletTypeToTittaStream<LSL_streamer::numeric> { static constexpr Titta::Stream value = Titta::Stream::Unknown; };
+    template <>           struct LSLInletTypeToTittaStream<LSL_streamer::marker> { static constexpr Titta::Stream value = Titta::Stream::Unknown; };
     template <typename T>
     constexpr Titta::Stream LSLInletTypeToTittaStream_v = LSLInletTypeToTittaStream<T>::value;
 
@@ -86,6 +111,37 @@ namespace
     template <>                struct LSLChannelFormatToCppType<lsl::cf_int64> { using type = int64_t; };
     template <enum lsl::channel_format_t T>
     using LSLChannelFormatToCppType_t = typename LSLChannelFormatToCppType<T>::type;
+
+    template <typename T>
+    constexpr Titta::Stream streamOfSample()
+    {
+        if      constexpr (std::is_same_v<T, Titta::gaze>)
+            return Titta::Stream::Gaze;
+        else if constexpr (std::is_same_v<T, Titta::eyeImage>)
+            return Titta::Stream::EyeImage;
+        else if constexpr (std::is_same_v<T, Titta::extSignal>)
+            return Titta::Stream::ExtSignal;
+        else if constexpr (std::is_same_v<T, Titta::timeSync>)
+            return Titta::Stream::TimeSync;
+        else if constexpr (std::is_same_v<T, LSLTypes::stampedPositioning>)
+            return Titta::Stream::Positioning;
+        else
+            static_assert(always_false<T>, "streamOfSample not implemented for this type");
+    }
+
+    bool isNumericChannelFormat(const lsl::channel_format_t format_)
+    {
+        return format_ != lsl::cf_string && format_ != lsl::cf_undefined;
+    }
+    // LSL takes 8-bit integer channel values as char
+    template <typename T>
+    auto* toLSLPointer(T* data_)
+    {
+        if constexpr (std::is_same_v<std::remove_const_t<T>, int8_t>)
+            return reinterpret_cast<std::conditional_t<std::is_const_v<T>, const char, char>*>(data_);
+        else
+            return data_;
+    }
 }
 
 // callbacks
@@ -93,6 +149,7 @@ void LSLGazeCallback(TobiiResearchGazeData* gaze_data_, void* user_data)
 {
     if (user_data)
     {
+        LSL_streamer::probe(LSL_streamer::ProbePoint::Callback, Titta::Stream::Gaze, gaze_data_->system_time_stamp);
         const auto instance = static_cast<LSL_streamer*>(user_data);
         instance->receiveSample(gaze_data_, nullptr);
     }
@@ -111,7 +168,7 @@ void LSLEyeImageCallback(TobiiResearchEyeImage* eye_image_, void* user_data)
     {
         const auto instance = static_cast<LSL_streamer*>(user_data);
         if (instance->isStreaming(Titta::Stream::EyeImage))
-            instance->pushSample(eye_image_);
+            instance->dispatchSample(Titta::eyeImage{eye_image_});
     }
 }
 void LSLEyeImageGifCallback(TobiiResearchEyeImageGif* eye_image_, void* user_data)
@@ -120,34 +177,39 @@ void LSLEyeImageGifCallback(TobiiResearchEyeImageGif* eye_image_, void* user_dat
     {
         const auto instance = static_cast<LSL_streamer*>(user_data);
         if (instance->isStreaming(Titta::Stream::EyeImage))
-            instance->pushSample(eye_image_);
+            instance->dispatchSample(Titta::eyeImage{eye_image_});
     }
 }
 void LSLExtSignalCallback(TobiiResearchExternalSignalData* ext_signal_, void* user_data)
 {
     if (user_data)
     {
+        LSL_streamer::probe(LSL_streamer::ProbePoint::Callback, Titta::Stream::ExtSignal, ext_signal_->system_time_stamp);
         const auto instance = static_cast<LSL_streamer*>(user_data);
         if (instance->isStreaming(Titta::Stream::ExtSignal))
-            instance->pushSample(*ext_signal_);
+            instance->dispatchSample(Titta::extSignal{*ext_signal_});
     }
 }
 void LSLTimeSyncCallback(TobiiResearchTimeSynchronizationData* time_sync_data_, void* user_data)
 {
     if (user_data)
     {
+        LSL_streamer::probe(LSL_streamer::ProbePoint::Callback, Titta::Stream::TimeSync, time_sync_data_->system_request_time_stamp);
         const auto instance = static_cast<LSL_streamer*>(user_data);
         if (instance->isStreaming(Titta::Stream::TimeSync))
-            instance->pushSample(*time_sync_data_);
+            instance->dispatchSample(Titta::timeSync{*time_sync_data_});
     }
 }
 void LSLPositioningCallback(TobiiResearchUserPositionGuide* position_data_, void* user_data)
 {
     if (user_data)
     {
+        // positioning data has no timestamp, stamp it with the time it was delivered
+        const auto timeStamp = Titta::getSystemTimestamp();
+        LSL_streamer::probe(LSL_streamer::ProbePoint::Callback, Titta::Stream::Positioning, timeStamp);
         const auto instance = static_cast<LSL_streamer*>(user_data);
         if (instance->isStreaming(Titta::Stream::Positioning))
-            instance->pushSample(*position_data_);
+            instance->dispatchSample(LSLTypes::stampedPositioning{Titta::positioning{*position_data_}, timeStamp});
     }
 }
 
@@ -201,16 +263,34 @@ LSL_streamer::LSL_streamer(const TobiiTypes::eyeTracker& et_)
 }
 LSL_streamer::~LSL_streamer()
 {
-    stopOutlet(Titta::Stream::Gaze);
-    stopOutlet(Titta::Stream::EyeOpenness);
-    stopOutlet(Titta::Stream::EyeImage);
-    stopOutlet(Titta::Stream::ExtSignal);
-    stopOutlet(Titta::Stream::TimeSync);
-    stopOutlet(Titta::Stream::Positioning);
+    // tell all recorder threads to stop first, so that they all wind down at the same time
+    auto inlets = _inStreams.removeAll();
+    for (const auto& inlet : inlets)
+        setWorkerThreadStopFlag(*inlet);
+
+    // stop the callbacks, and make sure any samples still waiting to be pushed are done
+    if (_localEyeTracker)
+    {
+        for (const auto stream : {Titta::Stream::Gaze, Titta::Stream::EyeOpenness, Titta::Stream::EyeImage, Titta::Stream::ExtSignal, Titta::Stream::TimeSync, Titta::Stream::Positioning})
+            stop(stream);
+        if (_pusherPool)
+            _pusherPool->flush(_pusherLane);
+    }
 
-    // stop all inlets
-    for (const auto& id : _inStreams | std::views::keys)
-        deleteListener(id);
+    // tear down inlets and outlets in parallel, so that shutdown takes about as long
+    // as the slowest of them, not the sum. Each task only touches its own inlet or outlet
+    std::vector<std::future<void>> teardown;
+    teardown.reserve(inlets.size() + _outStreams.size());
+    for (auto& inlet : inlets)
+        teardown.push_back(std::async(std::launch::async, [inlet = std::move(inlet)]() mutable
+        {
+            stopRecorder(*inlet, true);
+            inlet.reset();
+        }));
+    while (!_outStreams.empty())
+        teardown.push_back(std::async(std::launch::async, [outlet = _outStreams.extract(_outStreams.begin())]() mutable { outlet = {}; }));
+    for (auto& t : teardown)
+        t.get();
 }
 uint32_t LSL_streamer::getID()
 {
@@ -660,6 +740,7 @@ bool LSL_streamer::startOutlet(const Titta::Stream stream_, std::optional<bool>
 
     // make the outlet
     _outStreams.insert(std::make_pair(stream_,lsl::stream_outlet(info, 1)));
+    _outStats[static_cast<size_t>(stream_)].reset();
 
     // start the eye tracker stream
     return start(stream_, asGif_);
@@ -856,8 +937,8 @@ void LSL_streamer::receiveSample(const TobiiResearchGazeData* gaze_data_, const
         // if any data in staging area but no longer expecting to merge, flush to output
         if (isStreaming(Titta::Stream::Gaze))
         {
-            for (const auto& sample : _gazeStaging)
-                pushSample(sample);
+            for (auto& sample : _gazeStaging)
+                dispatchSample(std::move(sample));
         }
         _gazeStaging.clear();
         _gazeStagingEmpty = true;
@@ -941,42 +1022,39 @@ void LSL_streamer::receiveSample(const TobiiResearchGazeData* gaze_data_, const
     if (!emitBuffer.empty())
     {
         if (isStreaming(Titta::Stream::Gaze))
-            for (const auto& samp : emitBuffer)
-                pushSample(samp);
+            for (auto& samp : emitBuffer)
+                dispatchSample(std::move(samp));
+    }
+}
+
+template <typename SampleType>
+void LSL_streamer::dispatchSample(SampleType&& sample_)
+{
+    if (_pusherPool)
+    {
+        // eye images are not pushed into outlets, so they are not counted either
+        if constexpr (!std::is_same_v<std::remove_cvref_t<SampleType>, Titta::eyeImage>)
+            ++_outStats[static_cast<size_t>(streamOfSample<std::remove_cvref_t<SampleType>>())].posted;
+        _pusherPool->post(_pusherLane, this, PusherPool::sample_type{std::forward<SampleType>(sample_)});
     }
+    else
+        pushSample(std::forward<SampleType>(sample_));
+}
+void LSL_streamer::countPushed(const Titta::Stream stream_, const int64_t timeStamp_)
+{
+    probe(ProbePoint::Pushed, stream_, timeStamp_);
+    auto& stats = _outStats[static_cast<size_t>(stream_)];
+    ++stats.pushed;
+    stats.lastTimeStamp = timeStamp_;
 }
 
 void LSL_streamer::pushSample(const Titta::gaze& sample_)
 {
     using lsl_inlet_type = TittaStreamToLSLInletType_t<Titta::Stream::Gaze>;
-    using data_t = LSLChannelFormatToCppType_t<LSLInletTypeToChannelFormat_v<lsl_inlet_type>>;
-
-    const data_t sample[LSLInletTypeNumSamples_v<lsl_inlet_type>] = {
-        sample_.left_eye.gaze_point.position_on_display_area.x, sample_.left_eye.gaze_point.position_on_display_area.y,
-        sample_.left_eye.gaze_point.position_in_user_coordinates.x, sample_.left_eye.gaze_point.position_in_user_coordinates.y, sample_.left_eye.gaze_point.position_in_user_coordinates.z,
-        static_cast<data_t>(sample_.left_eye.gaze_point.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.gaze_point.available),
-        sample_.left_eye.pupil.diameter,
-        static_cast<data_t>(sample_.left_eye.pupil.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.pupil.available),
-        sample_.left_eye.gaze_origin.position_in_user_coordinates.x, sample_.left_eye.gaze_origin.position_in_user_coordinates.y, sample_.left_eye.gaze_origin.position_in_user_coordinates.z,
-        sample_.left_eye.gaze_origin.position_in_track_box_coordinates.x, sample_.left_eye.gaze_origin.position_in_track_box_coordinates.y, sample_.left_eye.gaze_origin.position_in_track_box_coordinates.z,
-        static_cast<data_t>(sample_.left_eye.gaze_origin.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.gaze_origin.available),
-        sample_.left_eye.eye_openness.diameter,
-        static_cast<data_t>(sample_.left_eye.eye_openness.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.eye_openness.available),
-
-        sample_.right_eye.gaze_point.position_on_display_area.x, sample_.right_eye.gaze_point.position_on_display_area.y,
-        sample_.right_eye.gaze_point.position_in_user_coordinates.x, sample_.right_eye.gaze_point.position_in_user_coordinates.y, sample_.right_eye.gaze_point.position_in_user_coordinates.z,
-        static_cast<data_t>(sample_.right_eye.gaze_point.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.gaze_point.available),
-        sample_.right_eye.pupil.diameter,
-        static_cast<data_t>(sample_.right_eye.pupil.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.pupil.available),
-        sample_.right_eye.gaze_origin.position_in_user_coordinates.x, sample_.right_eye.gaze_origin.position_in_user_coordinates.y, sample_.right_eye.gaze_origin.position_in_user_coordinates.z,
-        sample_.right_eye.gaze_origin.position_in_track_box_coordinates.x, sample_.right_eye.gaze_origin.position_in_track_box_coordinates.y, sample_.right_eye.gaze_origin.position_in_track_box_coordinates.z,
-        static_cast<data_t>(sample_.right_eye.gaze_origin.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.gaze_origin.available),
-        sample_.right_eye.eye_openness.diameter,
-        static_cast<data_t>(sample_.right_eye.eye_openness.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.eye_openness.available),
-
-        static_cast<data_t>(sample_.device_time_stamp) / 1'000'000.
-    };
-    _outStreams.at(Titta::Stream::Gaze).push_sample(sample, static_cast<double>(sample_.system_time_stamp)/1'000'000.);
+    const auto sample = SampleConversion::toLSL(sample_);
+    static_assert(std::tuple_size_v<decltype(sample)> == LSLInletTypeNumSamples_v<lsl_inlet_type>);
+    _outStreams.at(Titta::Stream::Gaze).push_sample(sample.data(), static_cast<double>(sample_.system_time_stamp)/1'000'000.);
+    countPushed(Titta::Stream::Gaze, sample_.system_time_stamp);
 }
 void LSL_streamer::pushSample(Titta::eyeImage&& sample_)
 {
@@ -985,35 +1063,26 @@ void LSL_streamer::pushSample(Titta::eyeImage&& sample_)
 void LSL_streamer::pushSample(const Titta::extSignal& sample_)
 {
     using lsl_inlet_type = TittaStreamToLSLInletType_t<Titta::Stream::ExtSignal>;
-    using data_t = LSLChannelFormatToCppType_t<LSLInletTypeToChannelFormat_v<lsl_inlet_type>>;
-
-    const data_t sample[LSLInletTypeNumSamples_v<lsl_inlet_type>] = {
-        sample_.device_time_stamp, sample_.system_time_stamp, sample_.value, sample_.change_type
-    };
-    _outStreams.at(Titta::Stream::ExtSignal).push_sample(sample, static_cast<double>(sample_.system_time_stamp) / 1'000'000.);
+    const auto sample = SampleConversion::toLSL(sample_);
+    static_assert(std::tuple_size_v<decltype(sample)> == LSLInletTypeNumSamples_v<lsl_inlet_type>);
+    _outStreams.at(Titta::Stream::ExtSignal).push_sample(sample.data(), static_cast<double>(sample_.system_time_stamp) / 1'000'000.);
+    countPushed(Titta::Stream::ExtSignal, sample_.system_time_stamp);
 }
 void LSL_streamer::pushSample(const Titta::timeSync& sample_)
 {
     using lsl_inlet_type = TittaStreamToLSLInletType_t<Titta::Stream::TimeSync>;
-    using data_t = LSLChannelFormatToCppType_t<LSLInletTypeToChannelFormat_v<lsl_inlet_type>>;
-
-    const data_t sample[LSLInletTypeNumSamples_v<lsl_inlet_type>] = {
-        sample_.system_request_time_stamp, sample_.device_time_stamp, sample_.system_response_time_stamp
-    };
-    _outStreams.at(Titta::Stream::TimeSync).push_sample(sample, static_cast<double>(sample_.system_request_time_stamp) / 1'000'000.);
+    const auto sample = SampleConversion::toLSL(sample_);
+    static_assert(std::tuple_size_v<decltype(sample)> == LSLInletTypeNumSamples_v<lsl_inlet_type>);
+    _outStreams.at(Titta::Stream::TimeSync).push_sample(sample.data(), static_cast<double>(sample_.system_request_time_stamp) / 1'000'000.);
+    countPushed(Titta::Stream::TimeSync, sample_.system_request_time_stamp);
 }
-void LSL_streamer::pushSample(const Titta::positioning& sample_)
+void LSL_streamer::pushSample(const LSLTypes::stampedPositioning& sample_)
 {
     using lsl_inlet_type = TittaStreamToLSLInletType_t<Titta::Stream::Positioning>;
-    using data_t = LSLChannelFormatToCppType_t<LSLInletTypeToChannelFormat_v<lsl_inlet_type>>;
-
-    const data_t sample[LSLInletTypeNumSamples_v<lsl_inlet_type>] = {
-        sample_.left_eye.user_position.x, sample_.left_eye.user_position.y, sample_.left_eye.user_position.z,
-        static_cast<float>(sample_.left_eye.validity == TOBII_RESEARCH_VALIDITY_VALID),
-        sample_.right_eye.user_position.x, sample_.right_eye.user_position.y, sample_.right_eye.user_position.z,
-        static_cast<float>(sample_.right_eye.validity == TOBII_RESEARCH_VALIDITY_VALID)
-    };
-    _outStreams.at(Titta::Stream::Positioning).push_sample(sample); // this stream doesn't have a timestamp
+    const auto sample = SampleConversion::toLSL(sample_.positioningData);
+    static_assert(std::tuple_size_v<decltype(sample)> == LSLInletTypeNumSamples_v<lsl_inlet_type>);
+    _outStreams.at(Titta::Stream::Positioning).push_sample(sample.data(), static_cast<double>(sample_.system_time_stamp) / 1'000'000.);
+    countPushed(Titta::Stream::Positioning, sample_.system_time_stamp);
 }
 
 bool LSL_streamer::stop(const Titta::Stream stream_)
@@ -1107,9 +1176,145 @@ void LSL_streamer::stopOutlet(const Titta::Stream stream_)
     // stop the callback
     stop(stream_);
 
+    // make sure any samples still waiting to be pushed are done before the outlet is removed
+    if (_pusherPool)
+        _pusherPool->flush(_pusherLane);
+
     // stop the outlet, if any
     if (_outStreams.contains(stream_))
         _outStreams.erase(stream_);
+    _outStats[static_cast<size_t>(stream_)].reset();
+}
+
+void LSL_streamer::setPusherPool(std::shared_ptr<PusherPool> pool_)
+{
+    if (!_outStreams.empty())
+        DoExitWithMsg("LSL_streamer::cpp::setPusherPool: cannot change the pusher pool while outlets are running, stop them first");
+
+    _pusherPool = std::move(pool_);
+    if (_pusherPool)
+        _pusherLane = _pusherPool->getLane();
+}
+
+LSL_streamer::OutletStats LSL_streamer::getOutletStats(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/) const
+{
+    return getOutletStats(Titta::stringToStream(std::move(stream_), snake_case_on_stream_not_found, true));
+}
+LSL_streamer::OutletStats LSL_streamer::getOutletStats(const Titta::Stream stream_) const
+{
+    // EyeOpenness is always packed in a gaze stream, so report for that instead
+    const auto stream = stream_ == Titta::Stream::EyeOpenness ? Titta::Stream::Gaze : stream_;
+    OutletStats out;
+    if (static_cast<size_t>(stream) < _outStats.size())
+    {
+        const auto& stats   = _outStats[static_cast<size_t>(stream)];
+        out.samplesPushed   = stats.pushed;
+        const uint64_t posted = stats.posted;
+        out.samplesPending  = _pusherPool ? posted - std::min<uint64_t>(posted, out.samplesPushed) : 0;
+        out.lastTimeStamp   = stats.lastTimeStamp;
+    }
+    if (const auto it = _outStreams.find(stream); it != _outStreams.end())
+        out.hasConsumers = const_cast<lsl::stream_outlet&>(it->second).have_consumers();    // NB: have_consumers() is not marked const by liblsl, but doesn't modify the outlet
+    return out;
+}
+
+void LSL_streamer::setProbe(const probe_fun_t probe_)
+{
+    _probe = probe_;
+}
+void LSL_streamer::probe(const ProbePoint point_, const Titta::Stream stream_, const int64_t timeStamp_)
+{
+    if (const auto p = _probe.load(std::memory_order_relaxed))
+        p(point_, stream_, timeStamp_);
+}
+
+uint32_t LSL_streamer::createNumericOutlet(std::string name_, std::string type_, const size_t numChannels_, const lsl::channel_format_t format_, std::optional<double> nominalRate_, std::optional<std::string> sourceID_)
+{
+    if (!isNumericChannelFormat(format_))
+        DoExitWithMsg(std::format("LSL_streamer::cpp::createNumericOutlet: channel format {} is not numeric.", static_cast<int>(format_)));
+    if (numChannels_ < 1)
+        DoExitWithMsg("LSL_streamer::cpp::createNumericOutlet: an outlet must have at least one channel.");
+
+    // deal with default arguments
+    const auto nominalRate  = nominalRate_.value_or(lsl::IRREGULAR_RATE);
+    auto sourceID           = sourceID_.value_or(std::format("LSL_streamer:{}", name_));
+
+    lsl::stream_info info(std::move(name_), std::move(type_), static_cast<int32_t>(numChannels_), nominalRate, format_, std::move(sourceID));
+    const auto id = getID();
+    _genericOutlets.insert(id, std::make_shared<GenericOutlet>(lsl::stream_outlet(info), numChannels_, format_));
+    return id;
+}
+uint32_t LSL_streamer::createMarkerOutlet(std::string name_, std::optional<std::string> type_, std::optional<std::string> sourceID_)
+{
+    // deal with default arguments
+    auto type       = type_.value_or(defaults::markerStreamType);
+    auto sourceID   = sourceID_.value_or(std::format("LSL_streamer:{}", name_));
+
+    lsl::stream_info info(std::move(name_), std::move(type), 1, lsl::IRREGULAR_RATE, lsl::cf_string, std::move(sourceID));
+    const auto id = getID();
+    _genericOutlets.insert(id, std::make_shared<GenericOutlet>(lsl::stream_outlet(info), 1, lsl::cf_string));
+    return id;
+}
+std::shared_ptr<LSL_streamer::GenericOutlet> LSL_streamer::getGenericOutlet(const uint32_t id_) const
+{
+    auto outlet = _genericOutlets.find(id_);
+    if (!outlet)
+        DoExitWithMsg(std::format("No outlet with id {} is known", id_));
+    return outlet;
+}
+template <typename T>
+void LSL_streamer::pushNumericChunk(const uint32_t id_, std::span<const T> data_, std::span<const int64_t> timeStamps_)
+{
+    const auto outlet   = getGenericOutlet(id_);
+    const auto nCh      = outlet->numChannels;
+    if (outlet->format == lsl::cf_string)
+        DoExitWithMsg(std::format("LSL_streamer::cpp::pushNumericChunk: outlet with id {} is a marker outlet, use pushMarker().", id_));
+    if (data_.size() % nCh)
+        DoExitWithMsg(std::format("LSL_streamer::cpp::pushNumericChunk: outlet with id {} has {} channels, the number of values pushed ({}) must be a multiple of that.", id_, nCh, data_.size()));
+    if (data_.empty())
+        return;
+    if (timeStamps_.empty())
+    {
+        outlet->outlet.push_chunk_multiplexed(toLSLPointer(data_.data()), data_.size());
+        return;
+    }
+    if (timeStamps_.size() != data_.size() / nCh)
+        DoExitWithMsg(std::format("LSL_streamer::cpp::pushNumericChunk: {} timestamps provided for {} samples.", timeStamps_.size(), data_.size() / nCh));
+
+    // LSL wants timestamps in seconds
+    std::vector<double> timeStamps(timeStamps_.size());
+    std::ranges::transform(timeStamps_, timeStamps.begin(), [](const int64_t ts_) { return static_cast<double>(ts_) / 1'000'000.; });
+    outlet->outlet.push_chunk_multiplexed(toLSLPointer(data_.data()), timeStamps.data(), data_.size());
+}
+size_t LSL_streamer::getOutletNumChannels(const uint32_t id_) const
+{
+    return getGenericOutlet(id_)->numChannels;
+}
+int64_t LSL_streamer::pushMarker(const uint32_t id_, const std::string& marker_, std::optional<int64_t> timeStamp_)
+{
+    const auto outlet = getGenericOutlet(id_);
+    if (outlet->format != lsl::cf_string)
+        DoExitWithMsg(std::format("LSL_streamer::cpp::pushMarker: outlet with id {} is not a marker outlet.", id_));
+
+    // NB: system time is the LSL clock (CheckClocks()), take it as late as possible
+    const auto timeStamp = timeStamp_.value_or(Titta::getSystemTimestamp());
+    // pushthrough: send now instead of waiting for the outlet's chunk to fill up
+    outlet->outlet.push_sample(&marker_, static_cast<double>(timeStamp) / 1'000'000., true);
+    probe(ProbePoint::Pushed, Titta::Stream::Unknown, timeStamp);
+    return timeStamp;
+}
+void LSL_streamer::deleteOutlet(const uint32_t id_)
+{
+    if (!_genericOutlets.remove(id_))
+        DoExitWithMsg(std::format("No outlet with id {} is known", id_));
+    // NB: pushes in progress on other threads keep the outlet alive until they are done
+}
+
+std::string LSL_streamer::getSerialNumber() const
+{
+    if (!_localEyeTracker)
+        DoExitWithMsg("Not connected to an eye tracker, cannot get its serial number");
+    return _localEyeTracker->serialNumber;
 }
 
 
@@ -1143,233 +1348,944 @@ read_lock  lockForReading(LSL_streamer::Inlet<DataType>& inlet_) { return  read_
 template <typename DataType>
 write_lock lockForWriting(LSL_streamer::Inlet<DataType>& inlet_) { return write_lock(inlet_._mutex); }
 template <typename DataType>
-std::vector<DataType>& getBuffer(LSL_streamer::Inlet<DataType>& inlet_)
+auto& getBuffer(LSL_streamer::Inlet<DataType>& inlet_)
 {
     return inlet_._buffer;
 }
-template <typename DataType>
-std::tuple<typename std::vector<DataType>::iterator, typename std::vector<DataType>::iterator>
-getIteratorsFromSampleAndSide(std::vector<DataType>& buf_, const size_t NSamp_, const Titta::BufferSide side_)
+// numeric inlets store the channel values of their samples beside the buffer
+// (LSL_streamer::Inlet::_values), the below keep them in step with it
+LSLTypes::numericValues makeNumericValues(const lsl::channel_format_t format_)
 {
-    auto startIt    = std::begin(buf_);
-    auto   endIt    = std::end(buf_);
-    const auto nSamp= std::min(NSamp_, std::size(buf_));
-
-    switch (side_)
+    switch (format_)
     {
-    case Titta::BufferSide::Start:
-        endIt   = std::next(startIt, nSamp);
-        break;
-    case Titta::BufferSide::End:
-        startIt = std::prev(endIt  , nSamp);
-        break;
+    case lsl::cf_float32:
+        return std::vector<float>{};
+    case lsl::cf_double64:
+        return std::vector<double>{};
+    case lsl::cf_int8:
+        return std::vector<int8_t>{};
+    case lsl::cf_int16:
+        return std::vector<int16_t>{};
+    case lsl::cf_int32:
+        return std::vector<int32_t>{};
+    case lsl::cf_int64:
+        return std::vector<int64_t>{};
     default:
-        DoExitWithMsg("LSL_streamer::::cpp::getIteratorsFromSampleAndSide: unknown Titta::BufferSide provided.");
-        break;
+        DoExitWithMsg(std::format("LSL_streamer::cpp::makeNumericValues: channel format {} is not numeric.", static_cast<int>(format_)));
     }
-    return { startIt, endIt };
 }
-
 template <typename DataType>
-std::tuple<typename std::vector<DataType>::iterator, typename std::vector<DataType>::iterator, bool>
-getIteratorsFromTimeRange(std::vector<DataType>& buf_, const int64_t timeStart_, const int64_t timeEnd_, const bool timeIsLocalTime_)
+size_t getBytesPerSample(LSL_streamer::Inlet<DataType>& inlet_)
 {
-    // !NB: appropriate locking is responsibility of caller!
-    // find elements within given range of time stamps, both sides inclusive.
-    // Since returns are iterators, what is returned is first matching element until one past last matching element
-    // 1. get buffer to traverse, if empty, return
-    auto startIt = std::begin(buf_);
-    auto   endIt = std::end(buf_);
-    if (std::empty(buf_))
-        return {startIt,endIt, true};
-
-    // 2. see which member variable to access
-    int64_t DataType::* field;
-    if (timeIsLocalTime_)
-        field = &DataType::local_system_time_stamp;
+    constexpr auto sampleBytes = sizeof(typename LSL_streamer::Inlet<DataType>::stored_t);
+    if constexpr (std::is_same_v<DataType, LSLTypes::numeric>)
+        return sampleBytes + inlet_._numChannels * std::visit([]<typename T>(const std::vector<T>&) { return sizeof(T); }, inlet_._values);
     else
-        field = &DataType::remote_system_time_stamp;
-
-    // 3. check if requested times are before or after vector start and end
-    const bool inclFirst = timeStart_ <= buf_.front().*field;
-    const bool inclLast  = timeEnd_   >= buf_.back().*field;
-
-    // 4. if start time later than beginning of samples, or end time earlier, find correct iterators
-    if (!inclFirst)
-        startIt = std::lower_bound(startIt, endIt, timeStart_, [&field](const DataType& a_, const int64_t& b_) {return a_.*field < b_;});
-    if (!inclLast)
-        endIt   = std::upper_bound(startIt, endIt, timeEnd_  , [&field](const int64_t& a_, const DataType& b_) {return a_ < b_.*field;});
-
-    // 5. done, return
-    return {startIt, endIt, inclFirst&&inclLast};
+        return sampleBytes;
 }
-
-template <typename T>
-std::vector<T> consumeFromVec(std::vector<T>& buf_, typename std::vector<T>::iterator startIt_, typename std::vector<T>::iterator endIt_)
+// heap memory owned by a stored sample, on top of its sizeof()
+template <typename Stored>
+size_t getPayloadBytes(const Stored& sample_)
 {
-    if (std::empty(buf_))
-        return std::vector<T>{};
-
-    // move out the indicated elements
-    if (startIt_==std::begin(buf_) && endIt_==std::end(buf_))
-        // whole buffer
-        return std::vector<T>(std::move(buf_));
+    if      constexpr (std::is_same_v<Stored, LSLTypes::eyeImage>)
+        return sample_.eyeImageData.data_size;
+    else if constexpr (std::is_same_v<Stored, LSLTypes::marker>)
+        return sample_.value.capacity();
     else
+        return 0;
+}
+template <typename Stored>
+constexpr bool hasPayload_v = std::is_same_v<Stored, LSLTypes::eyeImage> || std::is_same_v<Stored, LSLTypes::marker>;
+// copy samples out of the buffer, expanding packed samples
+template <typename DataType, typename It>
+std::vector<DataType> copyFromBuffer(It startIt_, It endIt_)
+{
+    if constexpr (LSLTypes::isPacked_v<DataType>)
     {
-        std::vector<T> out;
+        std::vector<DataType> out;
         out.reserve(std::distance(startIt_, endIt_));
-        out.insert(std::end(out), std::make_move_iterator(startIt_), std::make_move_iterator(endIt_));
-        buf_.erase(startIt_, endIt_);
+        std::transform(startIt_, endIt_, std::back_inserter(out), LSLTypes::unpack_fn<DataType>{});
         return out;
     }
+    else
+        return std::vector<DataType>(startIt_, endIt_);
 }
-
-template <typename T>
-std::vector<T> peekFromVec(const std::vector<T>& buf_, const typename std::vector<T>::const_iterator startIt_, const typename std::vector<T>::const_iterator endIt_)
+template <typename DataType>
+std::vector<DataType> copyFromBuffer(const std::vector<LSLTypes::storage_t<DataType>>& samples_)
 {
-    if (std::empty(buf_))
-        return std::vector<T>{};
-
-    // copy the indicated elements
-    return std::vector<T>(startIt_, endIt_);
+    return copyFromBuffer<DataType>(std::begin(samples_), std::end(samples_));
 }
-
+// bring inlet's and global memory accounting up to date after the buffer changed
 template <typename DataType>
-void clearVec(LSL_streamer::Inlet<DataType>& inlet_, const int64_t timeStart_, const int64_t timeEnd_, const bool timeIsLocalTime_)
+void updateMemoryAccounting(LSL_streamer::Inlet<DataType>& inlet_)
 {
-    auto l = lockForWriting(inlet_);  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
-    auto& buf = getBuffer(inlet_);
-    if (std::empty(buf))
-        return;
-
-    // find applicable range
-    auto [startIt, endIt, whole] = getIteratorsFromTimeRange(buf, timeStart_, timeEnd_, timeIsLocalTime_);
-    // clear the flagged bit
-    if (whole)
-        buf.clear();
+    // !NB: appropriate locking is responsibility of caller!
+    auto& account   = *inlet_._memoryAccount;
+    auto used       = std::size(getBuffer(inlet_)) * getBytesPerSample(inlet_) + inlet_._payloadBytes;
+    if constexpr (hasOlderTier_v<DataType>)
+        if (inlet_._olderTier && inlet_._olderTier->isInMemory())
+            used += inlet_._olderTier->bytes();
+    if (used >= inlet_._bytesUsed)
+        account.bytesUsed += used - inlet_._bytesUsed;
+    else
+        account.bytesUsed -= inlet_._bytesUsed - used;
+    inlet_._bytesUsed       = used;
+    inlet_._highWaterMark   = std::max(inlet_._highWaterMark, used);
+
+    const auto total = account.bytesUsed.load();
+    auto hwm = account.highWaterMark.load();
+    while (total > hwm && !account.highWaterMark.compare_exchange_weak(hwm, total))
+        ;
+}
+// samples in the older tier are older than those in the buffer, so together
+// the tiers form one sequence: [older tier | buffer]. Cursors and the functions
+// below that take tiered indices work with indices into that sequence
+template <typename DataType>
+size_t getNumInOlderTier(LSL_streamer::Inlet<DataType>& inlet_)
+{
+    if constexpr (hasOlderTier_v<DataType>)
+        return inlet_._olderTier ? inlet_._olderTier->size() : 0;
     else
-        buf.erase(startIt, endIt);
+        return 0;
 }
+// cursors hold positions into [older tier | buffer]. Keep them pointing to the
+// same samples when samples [start_, end_) of that sequence are removed (cursors
+// inside the removed range move to the first sample after it). NB: not needed
+// when samples move from the buffer to the older tier, that does not change
+// their position in the sequence
+template <typename DataType>
+void updateCursorsAfterErase(LSL_streamer::Inlet<DataType>& inlet_, const size_t start_, const size_t end_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    for (auto& pos : inlet_._cursors | std::views::values)
+    {
+        if (pos >= end_)
+            pos -= end_ - start_;
+        else if (pos > start_)
+            pos = start_;
+    }
 }
+// the time index holds positions into the buffer. Keep it pointing to the same
+// samples when samples [start_, end_) are removed from the buffer. Numeric
+// inlets' channel values of the removed samples are removed too.
+// Must be called after the samples were removed from the buffer
 template <typename DataType>
-void checkInletType(LSL_streamer::AllInlets& inlet_, const uint32_t id_)
+void updateIndicesAfterErase(LSL_streamer::Inlet<DataType>& inlet_, const size_t start_, const size_t end_)
 {
-    if (!std::holds_alternative<LSL_streamer::Inlet<DataType>>(inlet_))
+    // !NB: appropriate locking is responsibility of caller!
+    if constexpr (hasPayload_v<DataType>)
+    {
+        // the removed samples are gone, so sum what the remaining ones hold. Samples are
+        // removed in batches, so this is cheap per sample
+        const auto& buf = getBuffer(inlet_);
+        inlet_._payloadBytes = std::transform_reduce(std::begin(buf), std::end(buf), size_t{0}, std::plus<>{}, [](const auto& s_) { return getPayloadBytes(s_); });
+    }
+    TimeIndex::indexErased(std::span(std::as_const(getBuffer(inlet_))), inlet_._timeRuns, inlet_._numTimeIndexed, start_, end_);
+    if constexpr (std::is_same_v<DataType, LSLTypes::numeric>)
     {
-        const auto wanted = LSLInletTypeToTittaStream_v<DataType>;
-        const auto actual = getInletTypeImpl(inlet_);
-        DoExitWithMsg(std::format("Inlet with id {} should be of type {}, but the inlet associated with that ID instead was of type {}. Fatal error", id_, Titta::streamToString(wanted), Titta::streamToString(actual)));
+        std::visit(
+            [&](auto& values_) {
+                const auto nCh  = inlet_._numChannels;
+                const auto n    = std::size(values_) / nCh;
+                const auto s    = std::min(start_, n);
+                const auto e    = std::min(end_, n);
+                values_.erase(std::next(std::begin(values_), s * nCh), std::next(std::begin(values_), e * nCh));
+            }, inlet_._values);
     }
 }
-
-LSL_streamer::AllInlets& LSL_streamer::getAllInletsVariant(const uint32_t id_) const
+template <typename DataType>
+void updateIndicesAfterAppend(LSL_streamer::Inlet<DataType>& inlet_)
 {
-    if (!_inStreams.contains(id_))
-        DoExitWithMsg(std::format("No inlet with id {} is known", id_));
-
-    return *_inStreams.at(id_);
+    // !NB: appropriate locking is responsibility of caller!
+    const auto& buf = getBuffer(inlet_);
+    for (auto i = inlet_._numTimeIndexed; i < std::size(buf); i++)
+    {
+        if constexpr (hasPayload_v<DataType>)
+            inlet_._payloadBytes += getPayloadBytes(buf[i]);
+        // newest timestamps received, NB: kept when samples are consumed or cleared
+        for (size_t c = 0; c < LSLTypes::TimeClock::numClocks; c++)
+        {
+            const auto ts = LSLTypes::getTimeStamp(buf[i], static_cast<LSLTypes::TimeClock::Value>(c));
+            inlet_._newestReceived[c] = inlet_._hasReceived ? std::max(inlet_._newestReceived[c], ts) : ts;
+        }
+        inlet_._hasReceived = true;
+    }
+    TimeIndex::indexAppended(std::span(std::as_const(buf)), inlet_._timeRuns, inlet_._numTimeIndexed);
 }
+// after the whole buffer has been moved out by a consume call, give the inlet
+// back its capacity from the pool of spare buffers. NB: nothing is allocated
+// here, if the pool is empty the recorder thread provides a buffer before it
+// stores the next sample (makeSpareBuffer())
 template <typename DataType>
-LSL_streamer::Inlet<DataType>& LSL_streamer::getInlet(const uint32_t id_) const
+void restoreBufferCapacity(LSL_streamer::Inlet<DataType>& inlet_)
 {
-    auto& allInlets = getAllInletsVariant(id_);
-    checkInletType<DataType>(allInlets, id_);
+    // !NB: appropriate locking is responsibility of caller!
+    auto& buf = getBuffer(inlet_);
+    if (!std::empty(buf) || buf.capacity() >= inlet_._bufferCapacity)
+        return;
 
-    return std::get<Inlet<DataType>>(allInlets);
+    if (!inlet_._bufferPool.empty())
+    {
+        buf = std::move(inlet_._bufferPool.back());
+        inlet_._bufferPool.pop_back();
+    }
+    inlet_._spareBufferWanted = inlet_._bufferPool.size() < defaults::bufferPoolSize;
 }
-std::unique_ptr<std::thread>& LSL_streamer::getWorkerThread(LSL_streamer::AllInlets& inlet_)
+// spare buffer for the inlet, if it wants one (empty otherwise). For the recorder
+// threads, to be called before they lock the inlet, so that the allocation does
+// not happen while holding the lock. Hand it over with addSpareBuffer()
+template <typename DataType>
+std::vector<typename LSL_streamer::Inlet<DataType>::stored_t> makeSpareBuffer(const LSL_streamer::Inlet<DataType>& inlet_)
 {
-    return std::visit(
-        [](auto& in_) -> std::unique_ptr<std::thread>&{
-            return in_._recorder;
-        }, inlet_);
+    std::vector<typename LSL_streamer::Inlet<DataType>::stored_t> out;
+    // packed samples are stored in a different type of buffer, which keeps its storage anyway
+    if constexpr (!LSLTypes::isPacked_v<DataType>)
+    {
+        if (inlet_._spareBufferWanted)
+            out.reserve(inlet_._bufferCapacity);
+    }
+    return out;
 }
-bool LSL_streamer::getWorkerThreadStopFlag(LSL_streamer::AllInlets& inlet_)
+// swaps the spare buffer in if the inlet's buffer has lost its capacity, else puts
+// it in the pool. NB: spare_ may be left holding a buffer, free it after unlocking
+template <typename DataType>
+void addSpareBuffer(LSL_streamer::Inlet<DataType>& inlet_, std::vector<typename LSL_streamer::Inlet<DataType>::stored_t>& spare_)
 {
-    return std::visit(
-        [](auto& in_) -> bool {
-            return in_._recorder_should_stop;
-        }, inlet_);
-}
-void LSL_streamer::setWorkerThreadStopFlag(LSL_streamer::AllInlets& inlet_)
+    // !NB: appropriate locking is responsibility of caller!
+    if (!spare_.capacity() || spare_.capacity() < inlet_._bufferCapacity)
+        return;
+
+    auto& buf = getBuffer(inlet_);
+    if (std::empty(buf) && buf.capacity() < inlet_._bufferCapacity)
+        std::swap(buf, spare_);
+    else if (inlet_._bufferPool.size() < defaults::bufferPoolSize)
+        inlet_._bufferPool.push_back(std::move(spare_));
+    inlet_._spareBufferWanted = inlet_._bufferPool.size() < defaults::bufferPoolSize;
+}
+std::filesystem::path getSpillDirectory(LSL_streamer::MemoryAccount& account_)
+{
+    std::lock_guard l(account_.spillDirectoryMutex);
+    if (!account_.spillDirectory.empty())
+        return account_.spillDirectory;
+    std::error_code ec;
+    return std::filesystem::temp_directory_path(ec);
+}
+// get the inlet's older tier, which must be of type Tier. Creates it if there is
+// none. If there is a tier of the other type (the inlet's memory policy was
+// changed), its samples are moved to a new tier of type Tier
+template <typename Tier, typename DataType, typename MakeTier>
+SampleTier<typename LSL_streamer::Inlet<DataType>::stored_t>& getOlderTier(LSL_streamer::Inlet<DataType>& inlet_, MakeTier makeTier_)
 {
-    std::visit(
-        [](auto& in_){
-            in_._recorder_should_stop = true;
-        }, inlet_);
-}
+    // !NB: appropriate locking is responsibility of caller!
+    if (inlet_._olderTier && dynamic_cast<Tier*>(inlet_._olderTier.get()))
+        return *inlet_._olderTier;
 
-std::vector<lsl::stream_info> LSL_streamer::getRemoteStreams(std::string stream_, const bool snake_case_on_stream_not_found)
+    std::shared_ptr<SampleTier<typename LSL_streamer::Inlet<DataType>::stored_t>> tier = makeTier_();
+    if (inlet_._olderTier)
+    {
+        // NB: in batches, so that not all of the old tier's samples are in RAM at once
+        auto& old = *inlet_._olderTier;
+        for (size_t i = 0; i < old.size(); i += defaults::tierMigrationBatchSize)
+        {
+            const auto batch = old.read(i, i + defaults::tierMigrationBatchSize);
+            if (!tier->append(batch))
+            {
+                // the rest is lost
+                inlet_._samplesDropped += old.size() - i;
+                break;
+            }
+        }
+    }
+    inlet_._olderTier = std::move(tier);
+    // samples may have moved between RAM and disk, or been lost
+    updateMemoryAccounting(inlet_);
+    return *inlet_._olderTier;
+}
+// move oldest quarter of the buffer to the on-disk tier. Returns false if not
+// possible for this type of sample, or if writing has failed before.
+// NB: the tier writes the file on its own thread, not while the inlet's lock is held
+template <typename DataType>
+bool spillOldest(LSL_streamer::Inlet<DataType>& inlet_)
 {
-    if (!stream_.empty())
-        return getRemoteStreams(Titta::stringToStream(std::move(stream_), snake_case_on_stream_not_found, true));
+    // !NB: appropriate locking is responsibility of caller!
+    if constexpr (hasOlderTier_v<DataType>)
+    {
+        auto& buf = getBuffer(inlet_);
+        if (std::empty(buf))
+            return false;
+        using tier_t = SpillStore<typename LSL_streamer::Inlet<DataType>::stored_t>;
+        auto& tier = getOlderTier<tier_t>(inlet_, [&inlet_] { return std::make_shared<tier_t>(getSpillDirectory(*inlet_._memoryAccount)); });
+
+        const auto n = std::max<size_t>(std::size(buf) / 4, 1);
+        if (!tier.append(std::span(buf.data(), n)))
+            return false;
+        buf.erase(std::begin(buf), std::next(std::begin(buf), n));
+        updateIndicesAfterErase(inlet_, 0, n);
+        updateMemoryAccounting(inlet_);
+        return true;
+    }
     else
-        return getRemoteStreams(std::nullopt);
+        return false;
 }
-std::vector<lsl::stream_info> LSL_streamer::getRemoteStreams(std::optional<Titta::Stream> stream_)
+// compress oldest quarter of the buffer into the compressed tier. When the
+// buffer holds too few samples to be worth compressing, make room by dropping
+// the oldest compressed samples instead. Returns false if not possible for this
+// type of sample, or if there is nothing left to compress or drop
+template <typename DataType>
+bool compressOldest(LSL_streamer::Inlet<DataType>& inlet_)
 {
-    // filter if wanted
-    if (stream_.has_value())
+    // !NB: appropriate locking is responsibility of caller!
+    if constexpr (hasOlderTier_v<DataType>)
     {
-        if (*stream_!=Titta::Stream::Gaze && *stream_!=Titta::Stream::EyeImage && *stream_!=Titta::Stream::ExtSignal && *stream_!=Titta::Stream::TimeSync && *stream_!=Titta::Stream::Positioning)
-            DoExitWithMsg(std::format("LSL_streamer::cpp::getRemoteStreams: {} streams are not supported.", Titta::streamToString(*stream_)));
-        const auto streamName = std::format("Tobii_{}", Titta::streamToString(*stream_));
-        return lsl::resolve_stream("name", streamName, 0, 2.);
+        auto& buf = getBuffer(inlet_);
+        using tier_t = CompressedStore<typename LSL_streamer::Inlet<DataType>::stored_t>;
+        auto& tier = getOlderTier<tier_t>(inlet_, [] { return std::make_shared<tier_t>(defaults::compressBlockSize); });
+
+        if (std::size(buf) >= defaults::compressMinSamples || (tier.empty() && !std::empty(buf)))
+        {
+            const auto n = std::max<size_t>(std::size(buf) / 4, std::min(std::size(buf), defaults::compressMinSamples));
+            tier.append(std::span(buf.data(), n));
+            buf.erase(std::begin(buf), std::next(std::begin(buf), n));
+            updateIndicesAfterErase(inlet_, 0, n);
+        }
+        else if (!tier.empty())
+        {
+            const auto n = std::min(tier.size(), defaults::compressBlockSize);
+            tier.erase(0, n);
+            updateCursorsAfterErase(inlet_, 0, n);
+            inlet_._samplesDropped += n;
+        }
+        else
+            return false;
+        updateMemoryAccounting(inlet_);
+        return true;
     }
     else
-        return lsl::resolve_streams(2.);
+        return false;
 }
-
-uint32_t LSL_streamer::createListener(std::string streamSourceID_, std::optional<size_t> initialBufferSize_, std::optional<bool> startListening_)
+template <typename DataType>
+std::tuple<size_t, size_t> getTieredIndicesFromSampleAndSide(LSL_streamer::Inlet<DataType>& inlet_, const size_t NSamp_, const Titta::BufferSide side_)
 {
-    if (streamSourceID_.empty())
-        DoExitWithMsg("LSL_streamer::createListener: must specify stream source ID, cannot be empty");
-
-    // find stream with specified source ID
-    const auto streams = lsl::resolve_stream("source_id", streamSourceID_, 0, 2.);
-    if (streams.empty())
-        DoExitWithMsg(std::format("LSL_streamer::createListener: stream with source ID {} could not be found", streamSourceID_));
-    else if (streams.size()>1)
-        DoExitWithMsg(std::format("LSL_streamer::createListener: more than one stream with source ID {} found", streamSourceID_));
-
-    // start listening
-    return createListener(streams[0], initialBufferSize_, startListening_);
+    // !NB: appropriate locking is responsibility of caller!
+    const auto total = getNumInOlderTier(inlet_) + std::size(getBuffer(inlet_));
+    const auto nSamp = std::min(NSamp_, total);
+    switch (side_)
+    {
+    case Titta::BufferSide::Start:
+        return {0, nSamp};
+    case Titta::BufferSide::End:
+        return {total - nSamp, total};
+    default:
+        DoExitWithMsg("LSL_streamer::cpp::getTieredIndicesFromSampleAndSide: unknown Titta::BufferSide provided.");
+    }
 }
-uint32_t LSL_streamer::createListener(lsl::stream_info streamInfo_, std::optional<size_t> initialBufferSize_, std::optional<bool> doStartListening_)
+template <typename DataType>
+void checkTimeClock(const LSLTypes::TimeClock clock_, const std::string_view function_)
 {
-    // deal with default arguments
-    const auto doStartListening = doStartListening_.value_or(defaults::createStartsListening);
-
-    if (!streamInfo_.source_id().starts_with("LSL_streamer:Tobii_"))
-        DoExitWithMsg(std::format("LSL_streamer::createListener: stream {} (source_id: {}) is not an LSL_streamer stream, cannot be used.", streamInfo_.name(), streamInfo_.source_id()));
-
-# define MAKE_INLET(type, defaultName) \
-    _inStreams.emplace(id, \
-        std::make_unique<AllInlets>(std::in_place_type<Inlet<type>>, streamInfo_) \
-    ); \
-    auto& inlet = getInlet<type>(id); \
-    createdInlet = &inlet._lsl_inlet; \
-    getBuffer<type>(inlet).reserve(initialBufferSize_.value_or(defaults::defaultName));
+    if (clock_ == LSLTypes::TimeClock::Device && !LSLTypes::hasDeviceTimeStamp_v<DataType>)
+        DoExitWithMsg(std::format("LSL_streamer::cpp::{}: samples of this stream do not have a device timestamp.", function_));
+}
 
-    // subscribe to the stream
-    const auto id = getID();
-    const auto sType = streamInfo_.type();
-    lsl::stream_inlet* createdInlet = nullptr;
-    if (sType =="Gaze")
+template <typename DataType>
+std::tuple<size_t, size_t> getTieredIndicesFromTimeRange(LSL_streamer::Inlet<DataType>& inlet_, const int64_t timeStart_, const int64_t timeEnd_, const LSLTypes::TimeClock clock_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    const auto nOlder = getNumInOlderTier(inlet_);
+    auto [start, end] = BufferOps::getIndicesFromTimeRange(getBuffer(inlet_), timeStart_, timeEnd_, clock_, inlet_._timeRuns[clock_]);
+    start += nOlder;
+    end   += nOlder;
+    if constexpr (hasOlderTier_v<DataType>)
     {
-        MAKE_INLET(LSL_streamer::gaze, gazeBufSize)
+        if (nOlder)
+        {
+            // range starts in the older tier if a sample there is at or after its start,
+            // and ends there if no sample in the buffer is at or before its end
+            if (const auto s = inlet_._olderTier->firstAtOrAfter(timeStart_, clock_); s < nOlder)
+                start = s;
+            if (end == nOlder)
+                end   = inlet_._olderTier->pastLastAtOrBefore(timeEnd_, clock_);
+        }
     }
-    else if (sType == "VideoCompressed" || sType == "VideoRaw")
+    return {start, std::max(start, end)};
+}
+// remove samples [startIt_, endIt_) from the buffer and return them
+template <typename DataType, typename It>
+std::vector<DataType> consumeFromBuffer(LSL_streamer::Inlet<DataType>& inlet_, It startIt_, It endIt_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto& buf = getBuffer(inlet_);
+    const auto start = static_cast<size_t>(std::distance(std::begin(buf), startIt_));
+    const auto end   = static_cast<size_t>(std::distance(std::begin(buf), endIt_));
+    const auto nOlder= getNumInOlderTier(inlet_);
+    std::vector<DataType> out;
+    if constexpr (LSLTypes::isPacked_v<DataType>)
     {
-        MAKE_INLET(LSL_streamer::eyeImage, eyeImageBufSize)
+        // samples are expanded into a new vector anyway, so the buffer keeps its storage
+        out = copyFromBuffer<DataType>(startIt_, endIt_);
+        buf.erase(startIt_, endIt_);
+        updateIndicesAfterErase(inlet_, start, end);
     }
-    else if (sType == "TTL")
+    else
     {
-        MAKE_INLET(LSL_streamer::extSignal, extSignalBufSize)
+        out = BufferOps::consumeFromVec(buf, startIt_, endIt_);
+        updateIndicesAfterErase(inlet_, start, end);
+        restoreBufferCapacity(inlet_);
     }
-    else if (sType == "TimeSync")
+    updateCursorsAfterErase(inlet_, nOlder + start, nOlder + end);
+    updateMemoryAccounting(inlet_);
+    return out;
+}
+// get samples [start_, end_), removing them from the inlet if consume_ is set
+template <typename DataType>
+std::vector<DataType> getFromTiers(LSL_streamer::Inlet<DataType>& inlet_, const size_t start_, const size_t end_, const bool consume_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto& buf = getBuffer(inlet_);
+    const auto nOlder = getNumInOlderTier(inlet_);
+    std::vector<DataType> out;
+    if constexpr (hasOlderTier_v<DataType>)
     {
-        MAKE_INLET(LSL_streamer::timeSync, timeSyncBufSize)
+        if (start_ < nOlder)
+        {
+            out = copyFromBuffer<DataType>(inlet_._olderTier->read(start_, end_));
+            if (consume_)
+            {
+                inlet_._olderTier->erase(start_, end_);
+                updateCursorsAfterErase(inlet_, start_, std::min(end_, nOlder));
+                updateMemoryAccounting(inlet_);
+            }
+        }
+    }
+    if (end_ > nOlder)
+    {
+        const auto start    = std::max(start_, nOlder) - nOlder;
+        const auto end      = end_ - nOlder;
+        const auto startIt  = std::next(std::begin(buf), start);
+        const auto endIt    = std::next(std::begin(buf), end);
+        auto inRAM = consume_ ? consumeFromBuffer(inlet_, startIt, endIt) : copyFromBuffer<DataType>(startIt, endIt);
+        if (out.empty())
+            out = std::move(inRAM);
+        else
+            out.insert(std::end(out), std::make_move_iterator(std::begin(inRAM)), std::make_move_iterator(std::end(inRAM)));
+    }
+    return out;
+}
+// get samples in time range, removing them from the inlet if consume_ is set
+template <typename DataType>
+std::vector<DataType> getFromTimeRange(LSL_streamer::Inlet<DataType>& inlet_, const int64_t timeStart_, const int64_t timeEnd_, const LSLTypes::TimeClock clock_, const bool consume_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (getNumInOlderTier(inlet_))
+    {
+        auto [start, end] = getTieredIndicesFromTimeRange(inlet_, timeStart_, timeEnd_, clock_);
+        return getFromTiers(inlet_, start, end, consume_);
+    }
+
+    auto& buf = getBuffer(inlet_);
+    auto [startIt, endIt, whole] = BufferOps::getIteratorsFromTimeRange(buf, timeStart_, timeEnd_, clock_, inlet_._timeRuns[clock_]);
+    return consume_ ? consumeFromBuffer(inlet_, startIt, endIt) : copyFromBuffer<DataType>(startIt, endIt);
+}
+// newest timestamp the inlet has received, if any. NB: also when the sample
+// has since been consumed or cleared, so that a drained inlet still holds back
+// the watermark of multi-inlet calls
+template <typename DataType>
+std::optional<int64_t> getNewestTimeStamp(LSL_streamer::Inlet<DataType>& inlet_, const LSLTypes::TimeClock clock_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (!inlet_._hasReceived)
+        return std::nullopt;
+    return inlet_._newestReceived[clock_];
+}
+template <typename DataType>
+void clearFromTiers(LSL_streamer::Inlet<DataType>& inlet_, const size_t start_, const size_t end_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto& buf = getBuffer(inlet_);
+    const auto nOlder = getNumInOlderTier(inlet_);
+    if constexpr (hasOlderTier_v<DataType>)
+    {
+        if (start_ < nOlder)
+            inlet_._olderTier->erase(start_, end_);
+    }
+    if (end_ > nOlder)
+    {
+        const auto start    = std::max(start_, nOlder) - nOlder;
+        const auto end      = end_ - nOlder;
+        buf.erase(std::next(std::begin(buf), start), std::next(std::begin(buf), end));
+        updateIndicesAfterErase(inlet_, start, end);
+    }
+    updateCursorsAfterErase(inlet_, start_, end_);
+    // NB: also when only the older tier's samples were removed
+    updateMemoryAccounting(inlet_);
+}
+// remove samples that all cursors have read, from both tiers. Only done once at
+// least half the samples have been read so that each sample is moved at most
+// once on average
+template <typename DataType>
+void reclaimBehindCursors(LSL_streamer::Inlet<DataType>& inlet_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (inlet_._cursors.empty())
+        return;
+    const auto total  = getNumInOlderTier(inlet_) + std::size(getBuffer(inlet_));
+    const auto minPos = std::ranges::min(inlet_._cursors | std::views::values);
+    if (minPos == 0 || (minPos < total && minPos * 2 < total))
+        return;
+
+    clearFromTiers(inlet_, 0, minPos);
+}
+// check memory budgets before storing a new sample, which owns payloadBytes_ of
+// heap memory. Returns false if the sample should be discarded
+template <typename DataType>
+bool makeRoomForSample(LSL_streamer::Inlet<DataType>& inlet_, const size_t payloadBytes_ = 0)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    const auto sampleBytes = getBytesPerSample(inlet_) + payloadBytes_;
+    auto& account   = *inlet_._memoryAccount;
+    auto& buf       = getBuffer(inlet_);
+    const auto isOverInletBudget  = [&] { return inlet_._memoryBudget && inlet_._bytesUsed + sampleBytes > inlet_._memoryBudget; };
+    const auto isOverGlobalBudget = [&] { const auto budget = account.budget.load(); return budget && account.bytesUsed + sampleBytes > budget; };
+
+    while (true)
+    {
+        const auto overInlet = isOverInletBudget();
+        if (!overInlet && !isOverGlobalBudget())
+        {
+            inlet_._ingestStopped = false;
+            return true;
+        }
+
+        const auto policy = overInlet ? inlet_._memoryPolicy : account.policy.load();
+        if (policy == LSL_streamer::MemoryPolicy::StopIngest)
+            break;
+        if (policy == LSL_streamer::MemoryPolicy::SpillToDisk && spillOldest(inlet_))
+            continue;
+        if (policy == LSL_streamer::MemoryPolicy::Compress && compressOldest(inlet_))
+            continue;
+        if (std::empty(buf))
+            break;
+
+        // DropOldest (or spilling or compressing not possible). Drop in
+        // batches, so that the cost of moving the remaining samples is amortized
+        const auto n = std::max<size_t>(std::size(buf) / 16, 1);
+        const auto nOlder = getNumInOlderTier(inlet_);
+        buf.erase(std::begin(buf), std::next(std::begin(buf), n));
+        updateIndicesAfterErase(inlet_, 0, n);
+        updateCursorsAfterErase(inlet_, nOlder, nOlder + n);
+        inlet_._samplesDropped += n;
+        updateMemoryAccounting(inlet_);
+    }
+
+    // StopIngest, or nothing left to drop
+    inlet_._ingestStopped = true;
+    inlet_._samplesDropped++;
+    return false;
+}
+template <typename DataType>
+size_t& getCursor(LSL_streamer::Inlet<DataType>& inlet_, const std::string& cursor_, const uint32_t id_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto it = inlet_._cursors.find(cursor_);
+    if (it == inlet_._cursors.end())
+        DoExitWithMsg(std::format("Inlet with id {} has no cursor named {}", id_, cursor_));
+    return it->second;
+}
+template <typename DataType>
+void clearVec(LSL_streamer::Inlet<DataType>& inlet_, const int64_t timeStart_, const int64_t timeEnd_, const LSLTypes::TimeClock clock_)
+{
+    auto l = lockForWriting(inlet_);  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
+    if (getNumInOlderTier(inlet_))
+    {
+        auto [start, end] = getTieredIndicesFromTimeRange(inlet_, timeStart_, timeEnd_, clock_);
+        clearFromTiers(inlet_, start, end);
+        return;
+    }
+    auto [start, end] = BufferOps::clearFromVec(getBuffer(inlet_), timeStart_, timeEnd_, clock_, inlet_._timeRuns[clock_]);
+    updateIndicesAfterErase(inlet_, start, end);
+    updateCursorsAfterErase(inlet_, start, end);
+    updateMemoryAccounting(inlet_);
+}
+// lock multiple inlets, always in order of id so that calls that lock multiple inlets cannot deadlock
+template <typename Lock>
+std::vector<Lock> lockInletsInOrder(std::vector<std::pair<uint32_t, mutex_type*>> mutexes_, const std::string_view function_)
+{
+    std::ranges::sort(mutexes_, {}, &std::pair<uint32_t, mutex_type*>::first);
+    if (const auto it = std::ranges::adjacent_find(mutexes_, {}, &std::pair<uint32_t, mutex_type*>::first); it != mutexes_.end())
+        DoExitWithMsg(std::format("LSL_streamer::cpp::{}: inlet with id {} was given more than once", function_, it->first));
+    std::vector<Lock> out;
+    out.reserve(mutexes_.size());
+    for (const auto& m : mutexes_)
+        out.emplace_back(*m.second);
+    return out;
+}
+// for each of gaze_, the most recent of signals_ at or before it (nullptr if none): calls
+// fun_(index into gaze_, signal). Both are taken to be in order of time, so one pass suffices
+template <typename Signal, typename Fun>
+void asOfJoin(const std::vector<LSLTypes::gaze>& gaze_, const std::vector<Signal>& signals_, const LSLTypes::TimeClock clock_, Fun fun_)
+{
+    size_t j = 0;
+    for (size_t i = 0; i < gaze_.size(); i++)
+    {
+        const auto t = LSLTypes::getTimeStamp(gaze_[i], clock_);
+        while (j < signals_.size() && LSLTypes::getTimeStamp(signals_[j], clock_) <= t)
+            j++;
+        fun_(i, j ? &signals_[j - 1] : nullptr);
+    }
+}
+// get numeric samples [start_, end_), removing them from the inlet if consume_ is set
+LSL_streamer::NumericSamples getNumericSamples(LSL_streamer::Inlet<LSLTypes::numeric>& inlet_, const size_t start_, const size_t end_, const bool consume_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto& buf = getBuffer(inlet_);
+    const auto nCh = inlet_._numChannels;
+    LSL_streamer::NumericSamples out;
+    out.numChannels = nCh;
+    out.remoteTimeStamps.reserve(end_ - start_);
+    out.localTimeStamps .reserve(end_ - start_);
+    for (auto i = start_; i < end_; i++)
+    {
+        out.remoteTimeStamps.push_back(buf[i].remote_system_time_stamp);
+        out.localTimeStamps .push_back(buf[i].local_system_time_stamp);
+    }
+    // channel values are contiguous, copy them in one go
+    out.values = std::visit(
+        [&]<typename T>(const std::vector<T>& values_) -> LSLTypes::numericValues {
+            return std::vector<T>(std::next(std::begin(values_), start_ * nCh), std::next(std::begin(values_), end_ * nCh));
+        }, inlet_._values);
+
+    if (consume_ && start_ < end_)
+    {
+        buf.erase(std::next(std::begin(buf), start_), std::next(std::begin(buf), end_));
+        updateIndicesAfterErase(inlet_, start_, end_);
+        updateMemoryAccounting(inlet_);
+    }
+    return out;
+}
+
+// copy of samples [start_, end_) in the form in which they are stored (not expanded)
+template <typename DataType>
+std::vector<LSLTypes::storage_t<DataType>> copyStoredFromTiers(LSL_streamer::Inlet<DataType>& inlet_, const size_t start_, const size_t end_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto& buf = getBuffer(inlet_);
+    const auto nOlder = getNumInOlderTier(inlet_);
+    std::vector<LSLTypes::storage_t<DataType>> out;
+    if constexpr (hasOlderTier_v<DataType>)
+    {
+        if (start_ < nOlder)
+            out = inlet_._olderTier->read(start_, end_);
+    }
+    if (end_ > nOlder)
+        out.insert(std::end(out), std::next(std::begin(buf), std::max(start_, nOlder) - nOlder), std::next(std::begin(buf), end_ - nOlder));
+    return out;
+}
+// samples in time range on the local clock, plus the sample before and after it (if any) so
+// that the whole range can be interpolated
+// smallest and largest timestamp of the inlet's samples (both tiers), if it has any. For the
+// buffer, these are the bounds of its time index, or its ends if its timestamps are sorted
+template <typename DataType>
+std::optional<std::pair<int64_t, int64_t>> getTimeExtent(LSL_streamer::Inlet<DataType>& inlet_, const LSLTypes::TimeClock clock_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    std::optional<std::pair<int64_t, int64_t>> out;
+    const auto add = [&out](const int64_t min_, const int64_t max_)
+    {
+        out = out ? std::pair{std::min(out->first, min_), std::max(out->second, max_)} : std::pair{min_, max_};
+    };
+    if constexpr (hasOlderTier_v<DataType>)
+    {
+        if (getNumInOlderTier(inlet_))
+            add(inlet_._olderTier->minTimeStamp(clock_), inlet_._olderTier->maxTimeStamp(clock_));
+    }
+    const auto& buf = getBuffer(inlet_);
+    if (!std::empty(buf))
+    {
+        if (const auto& runs = inlet_._timeRuns[clock_]; !std::empty(runs))
+            add(runs.front().minFrom, runs.back().maxUpTo);
+        else
+            add(LSLTypes::getTimeStamp(buf.front(), clock_), LSLTypes::getTimeStamp(buf.back(), clock_));
+    }
+    return out;
+}
+template <typename DataType>
+std::tuple<size_t, size_t> getResampleIndices(LSL_streamer::Inlet<DataType>& inlet_, std::span<const int64_t> grid_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (grid_.empty())
+        return {0, 0};
+    const auto n = getNumInOlderTier(inlet_) + std::size(getBuffer(inlet_));
+    auto [start, end] = getTieredIndicesFromTimeRange(inlet_, grid_.front(), grid_.back(), LSLTypes::TimeClock::Local);
+    return {start ? start - 1 : 0, std::min(end + 1, n)};
+}
+
+// where a point of a time grid falls among samples: the sample at or before it and how far
+// it is (0-1) towards the next sample. index is outsideSamples for grid points before the
+// first or after the last sample
+struct GridPosition
+{
+    size_t index;
+    double fraction;
+};
+constexpr size_t outsideSamples = static_cast<size_t>(-1);
+// times_ must be sorted. Both are, so a single pass suffices
+std::vector<GridPosition> getGridPositions(std::span<const int64_t> times_, std::span<const int64_t> grid_)
+{
+    std::vector<GridPosition> out(grid_.size(), {outsideSamples, 0.});
+    size_t j = 0;
+    for (size_t k = 0; k < grid_.size(); k++)
+    {
+        const auto t = grid_[k];
+        if (times_.empty() || t < times_.front() || t > times_.back())
+            continue;
+        while (j + 1 < times_.size() && times_[j + 1] <= t)
+            j++;
+        out[k] = {j, times_[j] == t ? 0. : static_cast<double>(t - times_[j]) / static_cast<double>(times_[j + 1] - times_[j])};
+    }
+    return out;
+}
+// values at the grid positions, interpolated linearly between the two neighboring samples.
+// getValues_(i) returns a pointer to the numChannels_ values of sample i, out_ is column-major
+// (numChannels_ values per grid point). NaN outside the samples
+template <typename Getter>
+void interpolateLinear(const std::vector<GridPosition>& positions_, Getter getValues_, const size_t numChannels_, double* out_)
+{
+    for (const auto& p : positions_)
+    {
+        if (p.index == outsideSamples)
+            std::fill_n(out_, numChannels_, std::numeric_limits<double>::quiet_NaN());
+        else if (p.fraction == 0.)
+            std::copy_n(getValues_(p.index), numChannels_, out_);
+        else
+        {
+            const auto a = getValues_(p.index);
+            const auto b = getValues_(p.index + 1);
+            for (size_t c = 0; c < numChannels_; c++)
+                out_[c] = a[c] + p.fraction * (static_cast<double>(b[c]) - a[c]);
+        }
+        out_ += numChannels_;
+    }
+}
+// values at the grid positions, taken from the nearest sample. fill_ outside the samples
+template <typename Getter, typename Out>
+void interpolateNearest(const std::vector<GridPosition>& positions_, Getter getValues_, const size_t numChannels_, Out* out_, const Out fill_)
+{
+    for (const auto& p : positions_)
+    {
+        if (p.index == outsideSamples)
+            std::fill_n(out_, numChannels_, fill_);
+        else
+            std::copy_n(getValues_(p.fraction < .5 ? p.index : p.index + 1), numChannels_, out_);
+        out_ += numChannels_;
+    }
+}
+
+// resample a gaze or numeric inlet's samples onto the time grid_ (local clock). Other inlet
+// types are not resampled, callers should reject them
+template <typename DataType>
+LSL_streamer::ResampledStream resampleInlet(LSL_streamer::Inlet<DataType>& inlet_, std::span<const int64_t> grid_)
+{
+    LSL_streamer::ResampledStream out;
+    if constexpr (std::is_same_v<DataType, LSLTypes::gaze>)
+    {
+        // work on the stored form: its values and flags are exactly what is to be resampled
+        std::vector<LSLTypes::packedGaze> samples;
+        {
+            auto l = lockForReading(inlet_);
+            auto [start, end] = getResampleIndices(inlet_, grid_);
+            samples = copyStoredFromTiers(inlet_, start, end);
+        }
+        // local timestamps may step back (time_index.h), interpolation needs them sorted
+        if (!std::ranges::is_sorted(samples, {}, &LSLTypes::packedGaze::local_system_time_stamp))
+            std::ranges::stable_sort(samples, {}, &LSLTypes::packedGaze::local_system_time_stamp);
+        std::vector<int64_t> times(samples.size());
+        std::ranges::transform(samples, times.begin(), &LSLTypes::packedGaze::local_system_time_stamp);
+        const auto positions = getGridPositions(times, grid_);
+
+        out.numChannels = std::tuple_size_v<decltype(LSLTypes::packedGaze::values)>;
+        out.values.resize(out.numChannels * grid_.size());
+        out.flags .resize(grid_.size());
+        interpolateLinear (positions, [&](const size_t i_) { return samples[i_].values.data(); }, out.numChannels, out.values.data());
+        interpolateNearest(positions, [&](const size_t i_) { return &samples[i_].flags; }, 1, out.flags.data(), uint32_t{0});
+    }
+    else if constexpr (std::is_same_v<DataType, LSLTypes::numeric>)
+    {
+        LSL_streamer::NumericSamples samples;
+        {
+            auto l = lockForReading(inlet_);
+            auto [start, end] = getResampleIndices(inlet_, grid_);
+            samples = getNumericSamples(inlet_, start, end, false);
+        }
+        const auto nCh = samples.numChannels;
+        // local timestamps may step back (time_index.h), interpolation needs them sorted
+        if (!std::ranges::is_sorted(samples.localTimeStamps))
+        {
+            std::vector<size_t> order(samples.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::ranges::stable_sort(order, {}, [&](const size_t i_) { return samples.localTimeStamps[i_]; });
+            std::vector<int64_t> times(order.size());
+            std::ranges::transform(order, times.begin(), [&](const size_t i_) { return samples.localTimeStamps[i_]; });
+            samples.localTimeStamps = std::move(times);
+            std::visit(
+                [&]<typename T>(std::vector<T>& values_) {
+                    std::vector<T> sorted(values_.size());
+                    for (size_t i = 0; i < order.size(); i++)
+                        std::copy_n(values_.data() + order[i] * nCh, nCh, sorted.data() + i * nCh);
+                    values_ = std::move(sorted);
+                }, samples.values);
+        }
+        const auto positions = getGridPositions(samples.localTimeStamps, grid_);
+
+        out.numChannels = nCh;
+        out.values.resize(nCh * grid_.size());
+        std::visit(
+            [&]<typename T>(const std::vector<T>& values_) {
+                const auto getValues = [&](const size_t i_) { return values_.data() + i_ * nCh; };
+                // integer channels hold levels or codes, which should not be blended
+                if constexpr (std::is_floating_point_v<T>)
+                    interpolateLinear (positions, getValues, nCh, out.values.data());
+                else
+                    interpolateNearest(positions, getValues, nCh, out.values.data(), std::numeric_limits<double>::quiet_NaN());
+            }, samples.values);
+    }
+    return out;
+}
+}
+// numeric and marker inlets have no stream type of their own
+template <typename DataType>
+std::string getInletTypeName()
+{
+    if constexpr (std::is_same_v<DataType, LSLTypes::numeric>)
+        return "numeric";
+    else if constexpr (std::is_same_v<DataType, LSLTypes::marker>)
+        return "marker";
+    else
+        return Titta::streamToString(LSLInletTypeToTittaStream_v<DataType>);
+}
+template <typename DataType>
+void checkInletType(LSL_streamer::AllInlets& inlet_, const uint32_t id_)
+{
+    if (!std::holds_alternative<LSL_streamer::Inlet<DataType>>(inlet_))
+    {
+        const auto wanted = getInletTypeName<DataType>();
+        const auto actual = std::visit([]<typename T>(const LSL_streamer::Inlet<T>&) { return getInletTypeName<T>(); }, inlet_);
+        DoExitWithMsg(std::format("Inlet with id {} should be of type {}, but the inlet associated with that ID instead was of type {}. Fatal error", id_, wanted, actual));
+    }
+}
+
+std::shared_ptr<LSL_streamer::AllInlets> LSL_streamer::getAllInletsVariant(const uint32_t id_) const
+{
+    auto inlet = _inStreams.find(id_);
+    if (!inlet)
+        DoExitWithMsg(std::format("No inlet with id {} is known", id_));
+
+    return inlet;
+}
+template <typename DataType>
+std::shared_ptr<LSL_streamer::Inlet<DataType>> LSL_streamer::getInlet(const uint32_t id_) const
+{
+    auto allInlets = getAllInletsVariant(id_);
+    checkInletType<DataType>(*allInlets, id_);
+
+    // NB: shares ownership with allInlets
+    auto& inlet = std::get<Inlet<DataType>>(*allInlets);
+    return {std::move(allInlets), &inlet};
+}
+void LSL_streamer::setWorkerThreadStopFlag(LSL_streamer::AllInlets& inlet_)
+{
+    std::visit(
+        [](auto& in_){
+            in_._recorder_should_stop = true;
+        }, inlet_);
+}
+
+std::vector<lsl::stream_info> LSL_streamer::getRemoteStreams(std::string stream_, const bool snake_case_on_stream_not_found)
+{
+    if (!stream_.empty())
+        return getRemoteStreams(Titta::stringToStream(std::move(stream_), snake_case_on_stream_not_found, true));
+    else
+        return getRemoteStreams(std::nullopt);
+}
+std::vector<lsl::stream_info> LSL_streamer::getRemoteStreams(std::optional<Titta::Stream> stream_)
+{
+    // filter if wanted
+    if (stream_.has_value())
+    {
+        if (*stream_!=Titta::Stream::Gaze && *stream_!=Titta::Stream::EyeImage && *stream_!=Titta::Stream::ExtSignal && *stream_!=Titta::Stream::TimeSync && *stream_!=Titta::Stream::Positioning)
+            DoExitWithMsg(std::format("LSL_streamer::cpp::getRemoteStreams: {} streams are not supported.", Titta::streamToString(*stream_)));
+        const auto streamName = std::format("Tobii_{}", Titta::streamToString(*stream_));
+        return lsl::resolve_stream("name", streamName, 0, 2.);
+    }
+    else
+        return lsl::resolve_streams(2.);
+}
+
+uint32_t LSL_streamer::createListener(std::string streamSourceID_, std::optional<size_t> initialBufferSize_, std::optional<bool> startListening_)
+{
+    if (streamSourceID_.empty())
+        DoExitWithMsg("LSL_streamer::createListener: must specify stream source ID, cannot be empty");
+
+    // find stream with specified source ID
+    const auto streams = lsl::resolve_stream("source_id", streamSourceID_, 0, 2.);
+    if (streams.empty())
+        DoExitWithMsg(std::format("LSL_streamer::createListener: stream with source ID {} could not be found", streamSourceID_));
+    else if (streams.size()>1)
+        DoExitWithMsg(std::format("LSL_streamer::createListener: more than one stream with source ID {} found", streamSourceID_));
+
+    // start listening
+    return createListener(streams[0], initialBufferSize_, startListening_);
+}
+uint32_t LSL_streamer::createListener(lsl::stream_info streamInfo_, std::optional<size_t> initialBufferSize_, std::optional<bool> doStartListening_)
+{
+    // deal with default arguments
+    const auto doStartListening = doStartListening_.value_or(defaults::createStartsListening);
+
+    // streams that are not LSL_streamer streams can be received with a generic numeric inlet, or
+    // if they are single channel string streams, with a marker inlet
+    const auto isLSLStreamerStream  = streamInfo_.source_id().starts_with("LSL_streamer:Tobii_");
+    const auto isMarkerStream       = !isLSLStreamerStream && streamInfo_.channel_format() == lsl::cf_string;
+    if (!isLSLStreamerStream && !isMarkerStream && !isNumericChannelFormat(streamInfo_.channel_format()))
+        DoExitWithMsg(std::format("LSL_streamer::createListener: stream {} (source_id: {}) is not an LSL_streamer stream and does not have a numeric or string channel format, cannot be used.", streamInfo_.name(), streamInfo_.source_id()));
+    if (isMarkerStream && streamInfo_.channel_count() != 1)
+        DoExitWithMsg(std::format("LSL_streamer::createListener: string stream {} (source_id: {}) has {} channels, only single channel marker streams can be used.", streamInfo_.name(), streamInfo_.source_id(), streamInfo_.channel_count()));
+
+# define MAKE_INLET(type, defaultName) \
+    createdInlet = std::make_shared<AllInlets>(std::in_place_type<Inlet<type>>, streamInfo_, _inletMemory); \
+    auto& inlet = std::get<Inlet<type>>(*createdInlet); \
+    inlet._bufferCapacity = initialBufferSize_.value_or(defaults::defaultName); \
+    getBuffer<type>(inlet).reserve(inlet._bufferCapacity);
+
+    // subscribe to the stream
+    const auto id = getID();
+    const auto sType = streamInfo_.type();
+    std::shared_ptr<AllInlets> createdInlet;
+    if (isMarkerStream)
+    {
+        MAKE_INLET(LSL_streamer::marker, markerBufSize)
+    }
+    else if (!isLSLStreamerStream)
+    {
+        if (streamInfo_.channel_count() < 1)
+            DoExitWithMsg(std::format("LSL_streamer::createListener: stream {} (source_id: {}) has no channels, cannot be used.", streamInfo_.name(), streamInfo_.source_id()));
+        MAKE_INLET(LSL_streamer::numeric, numericBufSize)
+        inlet._numChannels  = streamInfo_.channel_count();
+        inlet._values       = makeNumericValues(streamInfo_.channel_format());
+        std::visit([&](auto& values_) { values_.reserve(inlet._bufferCapacity * inlet._numChannels); }, inlet._values);
+    }
+    else if (sType =="Gaze")
+    {
+        MAKE_INLET(LSL_streamer::gaze, gazeBufSize)
+    }
+    else if (sType == "VideoCompressed" || sType == "VideoRaw")
+    {
+        MAKE_INLET(LSL_streamer::eyeImage, eyeImageBufSize)
+    }
+    else if (sType == "TTL")
+    {
+        MAKE_INLET(LSL_streamer::extSignal, extSignalBufSize)
+    }
+    else if (sType == "TimeSync")
+    {
+        MAKE_INLET(LSL_streamer::timeSync, timeSyncBufSize)
     }
     else if (sType == "Positioning")
     {
@@ -1381,7 +2297,10 @@ uint32_t LSL_streamer::createListener(lsl::stream_info streamInfo_, std::optiona
     if (createdInlet)
     {
         // immediately start time offset collection, we'll need that
-        createdInlet->time_correction(5.);
+        getLSLInlet(*createdInlet).time_correction(5.);
+
+        // register the inlet only once it is set up
+        _inStreams.insert(id, std::move(createdInlet));
 
         // start the stream
         if (doStartListening)
@@ -1392,81 +2311,101 @@ uint32_t LSL_streamer::createListener(lsl::stream_info streamInfo_, std::optiona
 #undef MAKE_INLET
 }
 
+template <typename DataType>
+LSL_streamer::InletHandle<DataType> LSL_streamer::getInletHandle(const uint32_t id_) const
+{
+    return {id_, getInlet<DataType>(id_)};
+}
+
 Titta::Stream LSL_streamer::getInletType(const uint32_t id_) const
 {
-    return getInletTypeImpl(getAllInletsVariant(id_));
+    return getInletTypeImpl(*getAllInletsVariant(id_));
+}
+bool LSL_streamer::isMarkerInlet(const uint32_t id_) const
+{
+    return std::holds_alternative<Inlet<marker>>(*getAllInletsVariant(id_));
 }
 
 lsl::stream_info LSL_streamer::getInletInfo(const uint32_t id_) const
 {
     // get inlet
-    auto& inlet = getAllInletsVariant(id_);
+    const auto inlet = getAllInletsVariant(id_);
     lsl::stream_inlet& lsl_inlet = std::visit(
         [](auto& in_) -> lsl::stream_inlet& {
             return in_._lsl_inlet;
-        }, inlet);
+        }, *inlet);
 
     // return it's stream info
     return lsl_inlet.info(2.);
 }
 
-void LSL_streamer::startListening(const uint32_t id_)
+double LSL_streamer::getInletTimeCorrection(const uint32_t id_, std::optional<double> timeout_) const
 {
-    auto& inlet = getAllInletsVariant(id_);
-    // ignore if listener already started
-    if (getWorkerThread(inlet))
-        return;
-
-    // start receiving samples
-    auto& lslInlet = getLSLInlet(inlet);
-    lslInlet.open_stream(5.);
+    return getLSLInlet(*getAllInletsVariant(id_)).time_correction(timeout_.value_or(defaults::timeCorrectionTimeout));
+}
 
-    // start recorder thread
-    switch (getInletType(id_))
-    {
-    case Titta::Stream::Gaze:
-    case Titta::Stream::EyeOpenness:
-        getInlet<gaze>(id_)._recorder = std::make_unique<std::thread>(&LSL_streamer::recorderThreadFunc<gaze>, this, id_);
-        break;
-    case Titta::Stream::EyeImage:
-        break;
-    case Titta::Stream::ExtSignal:
-        getInlet<gaze>(id_)._recorder = std::make_unique<std::thread>(&LSL_streamer::recorderThreadFunc<extSignal>, this, id_);
-        break;
-    case Titta::Stream::TimeSync:
-        getInlet<gaze>(id_)._recorder = std::make_unique<std::thread>(&LSL_streamer::recorderThreadFunc<timeSync>, this, id_);
-        break;
-    case Titta::Stream::Positioning:
-        getInlet<gaze>(id_)._recorder = std::make_unique<std::thread>(&LSL_streamer::recorderThreadFunc<positioning>, this, id_);
-        break;
-    }
+void LSL_streamer::startListening(const uint32_t id_)
+{
+    const auto inlet = getAllInletsVariant(id_);
+    std::visit(
+        [this, id_]<typename T>(Inlet<T>& in_) {
+            std::lock_guard l(in_._recorderMutex);
+            // a thread may still have gotten at the inlet just before it was deleted
+            if (in_._deleted)
+                DoExitWithMsg(std::format("LSL_streamer::cpp::startListening: inlet with id {} has been deleted.", id_));
+            // ignore if listener already started
+            if (in_._recorder)
+                return;
+
+            // start receiving samples
+            in_._lsl_inlet.open_stream(5.);
+
+            // start recorder thread
+            // NB: the thread is always joined before the inlet is destroyed (stopRecorder())
+            if constexpr (std::is_same_v<T, numeric>)
+                in_._recorder = std::make_unique<std::thread>(&LSL_streamer::numericRecorderThreadFunc, this, std::ref(in_));
+            else if constexpr (std::is_same_v<T, marker>)
+                in_._recorder = std::make_unique<std::thread>(&LSL_streamer::markerRecorderThreadFunc, this, std::ref(in_));
+            else if constexpr (!std::is_same_v<T, eyeImage>)
+                in_._recorder = std::make_unique<std::thread>(&LSL_streamer::recorderThreadFunc<T>, this, std::ref(in_));
+        }, *inlet);
 }
 
 bool LSL_streamer::isListening(const uint32_t id_) const
 {
-    auto& inlet = getAllInletsVariant(id_);
-    return getWorkerThread(inlet) && getWorkerThreadStopFlag(inlet);
+    const auto inlet = getAllInletsVariant(id_);
+    return std::visit(
+        []<typename T>(Inlet<T>& in_) {
+            std::lock_guard l(in_._recorderMutex);
+            return in_._recorder && !in_._recorder_should_stop;
+        }, *inlet);
 }
 
 template <typename DataType>
-void LSL_streamer::recorderThreadFunc(const uint32_t id_)
+void LSL_streamer::recorderThreadFunc(Inlet<DataType>& inlet_)
 {
     using data_t = LSLChannelFormatToCppType_t<LSLInletTypeToChannelFormat_v<DataType>>;
     constexpr size_t numElem = LSLInletTypeNumSamples_v<DataType>;
     using array_t = data_t[numElem];
-    auto& inlet = getInlet<DataType>(id_);
-    while (!inlet._recorder_should_stop)
+    while (!inlet_._recorder_should_stop)
     {
         array_t sample = { 0 };
-        auto remoteT = inlet._lsl_inlet.pull_sample<data_t,numElem>(sample, 0.1);
+        // NB: short timeout so that a stop request is noticed quickly
+        auto remoteT = inlet_._lsl_inlet.template pull_sample<data_t,numElem>(sample, defaults::recorderPullTimeout);
         if (remoteT <= 0.)
             continue;
-        auto tCorr = inlet._lsl_inlet.time_correction(0);
+        probe(ProbePoint::Pulled, LSLInletTypeToTittaStream_v<DataType>, timeStampSecondsToUs(remoteT));
+        auto tCorr = inlet_._lsl_inlet.time_correction(0);
         // now parse into type
+        auto spare = makeSpareBuffer(inlet_);
+        auto l = lockForWriting(inlet_);
+        addSpareBuffer(inlet_, spare);
+        if (!makeRoomForSample(inlet_))
+            continue;
         if constexpr (std::is_same_v<DataType, gaze>)
         {
             data_t* ptr = sample;
-            inlet._buffer.emplace_back(LSL_streamer::gaze{
+            inlet_._buffer.emplace_back(LSLTypes::storage<gaze>::pack(LSL_streamer::gaze{
                 {
                     {   // left eye
                         {   // gazePoint
@@ -1476,13 +2415,13 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
                             {   // position_in_user_coordinates
                                 static_cast<float>(*ptr++), static_cast<float>(*ptr++), static_cast<float>(*ptr++)
                             },
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                         {   // pupilData
                             static_cast<float>(*ptr++),
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                         {   // gazeOrigin
                             {   // position_in_user_coordinates
@@ -1491,13 +2430,13 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
                             {   // position_in_track_box_coordinates
                                 static_cast<float>(*ptr++), static_cast<float>(*ptr++), static_cast<float>(*ptr++)
                             },
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                         {   // eyeOpenness
                             static_cast<float>(*ptr++),
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                     },
                     // right eye
@@ -1509,13 +2448,13 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
                             {   // position_in_user_coordinates
                                 static_cast<float>(*ptr++), static_cast<float>(*ptr++), static_cast<float>(*ptr++)
                             },
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                         {   // pupilData
                             static_cast<float>(*ptr++),
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                         {   // gazeOrigin
                             {   // position_in_user_coordinates
@@ -1524,13 +2463,13 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
                             {   // position_in_track_box_coordinates
                                 static_cast<float>(*ptr++), static_cast<float>(*ptr++), static_cast<float>(*ptr++)
                             },
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                         {   // eyeOpenness
                             static_cast<float>(*ptr++),
-                            *ptr == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
-                            *ptr == 1.
+                            *ptr++ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID,
+                            *ptr++ == 1.
                         },
                     },
                     // device time
@@ -1540,7 +2479,7 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
                 },
             timeStampSecondsToUs(remoteT),
             timeStampSecondsToUs(remoteT + tCorr)
-            });
+            }));
         }
         else if constexpr (std::is_same_v<DataType, LSL_streamer::eyeImage>)
         {
@@ -1549,7 +2488,7 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
         else if constexpr (std::is_same_v<DataType, LSL_streamer::extSignal>)
         {
             data_t* ptr = sample;
-            inlet._buffer.emplace_back(LSL_streamer::extSignal{
+            inlet_._buffer.emplace_back(LSL_streamer::extSignal{
                 {
                     *ptr++, *ptr++, static_cast<uint32_t>(*ptr++), *ptr==TOBII_RESEARCH_EXTERNAL_SIGNAL_VALUE_CHANGED? TOBII_RESEARCH_EXTERNAL_SIGNAL_VALUE_CHANGED: *ptr == TOBII_RESEARCH_EXTERNAL_SIGNAL_INITIAL_VALUE? TOBII_RESEARCH_EXTERNAL_SIGNAL_INITIAL_VALUE: TOBII_RESEARCH_EXTERNAL_SIGNAL_CONNECTION_RESTORED
                 },
@@ -1560,7 +2499,7 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
         else if constexpr (std::is_same_v<DataType, LSL_streamer::timeSync>)
         {
             data_t* ptr = sample;
-            inlet._buffer.emplace_back(LSL_streamer::timeSync{
+            inlet_._buffer.emplace_back(LSL_streamer::timeSync{
                 {
                     *ptr++, *ptr++, *ptr
                 },
@@ -1571,7 +2510,7 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
         else if constexpr (std::is_same_v<DataType, LSL_streamer::positioning>)
         {
             data_t* ptr = sample;
-            inlet._buffer.emplace_back(LSL_streamer::positioning{
+            inlet_._buffer.emplace_back(LSL_streamer::positioning{
                 {
                     // left eye
                     {
@@ -1588,113 +2527,663 @@ void LSL_streamer::recorderThreadFunc(const uint32_t id_)
                 timeStampSecondsToUs(remoteT + tCorr)
             });
         }
+        updateIndicesAfterAppend(inlet_);
+        updateMemoryAccounting(inlet_);
+    }
+}
+void LSL_streamer::numericRecorderThreadFunc(Inlet<numeric>& inlet_)
+{
+    // samples are pulled in chunks, in the layout in which their values are stored
+    const auto nCh = inlet_._numChannels;
+    std::visit(
+        [&]<typename T>(const std::vector<T>&) {
+            std::vector<T>      chunk(defaults::numericChunkSize * nCh);
+            std::vector<double> remoteTs(defaults::numericChunkSize);
+            while (!inlet_._recorder_should_stop)
+            {
+                // wait for a sample (NB: short timeout so that a stop request is noticed quickly),
+                // then take what else is available without waiting
+                auto nValues = inlet_._lsl_inlet.pull_chunk_multiplexed(toLSLPointer(chunk.data()), remoteTs.data(), nCh, 1, defaults::recorderPullTimeout);
+                if (!nValues)
+                    continue;
+                nValues += inlet_._lsl_inlet.pull_chunk_multiplexed(toLSLPointer(chunk.data() + nCh), remoteTs.data() + 1, chunk.size() - nCh, remoteTs.size() - 1, 0.);
+                const auto nSamp = nValues / nCh;
+                for (size_t i = 0; i < nSamp; i++)
+                    probe(ProbePoint::Pulled, LSLInletTypeToTittaStream_v<numeric>, timeStampSecondsToUs(remoteTs[i]));
+                auto tCorr = inlet_._lsl_inlet.time_correction(0);
+
+                auto spare = makeSpareBuffer(inlet_);
+                auto l = lockForWriting(inlet_);
+                addSpareBuffer(inlet_, spare);
+                auto& values = std::get<std::vector<T>>(inlet_._values);
+                for (size_t i = 0; i < nSamp; i++)
+                {
+                    if (!makeRoomForSample(inlet_))
+                        continue;
+                    inlet_._buffer.emplace_back(LSL_streamer::numeric{
+                        timeStampSecondsToUs(remoteTs[i]),
+                        timeStampSecondsToUs(remoteTs[i] + tCorr)
+                    });
+                    const auto first = std::next(std::begin(chunk), i * nCh);
+                    values.insert(std::end(values), first, std::next(first, nCh));
+                    // NB: per sample, so that the budget check of the next sample sees this one
+                    updateMemoryAccounting(inlet_);
+                }
+                updateIndicesAfterAppend(inlet_);
+            }
+        }, inlet_._values);
+}
+void LSL_streamer::markerRecorderThreadFunc(Inlet<marker>& inlet_)
+{
+    std::vector<std::string>    values;
+    std::vector<double>         remoteTs;
+    std::string                 value;
+    while (!inlet_._recorder_should_stop)
+    {
+        // wait for a marker (NB: short timeout so that a stop request is noticed quickly),
+        // then take what else is available without waiting
+        auto remoteT = inlet_._lsl_inlet.pull_sample(&value, 1, defaults::recorderPullTimeout);
+        while (remoteT != 0.)
+        {
+            probe(ProbePoint::Pulled, LSLInletTypeToTittaStream_v<marker>, timeStampSecondsToUs(remoteT));
+            values.push_back(std::move(value));
+            remoteTs.push_back(remoteT);
+            remoteT = inlet_._lsl_inlet.pull_sample(&value, 1, 0.);
+        }
+        if (values.empty())
+            continue;
+        auto tCorr = inlet_._lsl_inlet.time_correction(0);
+
+        auto spare = makeSpareBuffer(inlet_);
+        auto l = lockForWriting(inlet_);
+        addSpareBuffer(inlet_, spare);
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (!makeRoomForSample(inlet_, values[i].capacity()))
+                continue;
+            inlet_._buffer.emplace_back(LSL_streamer::marker{
+                std::move(values[i]),
+                timeStampSecondsToUs(remoteTs[i]),
+                timeStampSecondsToUs(remoteTs[i] + tCorr)
+            });
+            // NB: per sample, so that the budget check of the next sample sees this one
+            updateIndicesAfterAppend(inlet_);
+            updateMemoryAccounting(inlet_);
+        }
+        values.clear();
+        remoteTs.clear();
     }
 }
 
 
 template <typename DataType>
 std::vector<DataType> LSL_streamer::consumeN(const uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
+{
+    return consumeN(getInlet<DataType>(id_), NSamp_, side_);
+}
+template <typename DataType>
+std::vector<DataType> LSL_streamer::consumeN(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
 {
     // deal with default arguments
     const auto N    = NSamp_.value_or(defaults::consumeNSamp);
     const auto side = side_ .value_or(defaults::consumeSide);
 
-    auto& inlet = getInlet<DataType>(id_);
+    auto& inlet = *inletRef_;
     auto l      = lockForWriting(inlet);  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
     auto& buf   = getBuffer(inlet);
 
-    auto [startIt, endIt] = getIteratorsFromSampleAndSide(buf, N, side);
-    return consumeFromVec(buf, startIt, endIt);
+    if (getNumInOlderTier(inlet))
+    {
+        auto [start, end] = getTieredIndicesFromSampleAndSide(inlet, N, side);
+        return getFromTiers(inlet, start, end, true);
+    }
+
+    auto [startIt, endIt] = BufferOps::getIteratorsFromSampleAndSide(buf, N, side);
+    return consumeFromBuffer(inlet, startIt, endIt);
 }
 template <typename DataType>
-std::vector<DataType> LSL_streamer::consumeTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_)
+std::vector<DataType> LSL_streamer::consumeTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    return consumeTimeRange(getInlet<DataType>(id_), timeStart_, timeEnd_, clock_);
+}
+template <typename DataType>
+std::vector<DataType> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
 {
     // deal with default arguments
     const auto timeStart        = timeStart_      .value_or(defaults::consumeTimeRangeStart);
     const auto timeEnd          = timeEnd_        .value_or(defaults::consumeTimeRangeEnd);
-    const auto timeIsLocalTime  = timeIsLocalTime_.value_or(defaults::timeIsLocalTime);
+    const auto clock            = clock_          .value_or(defaults::timeClock);
+    checkTimeClock<DataType>(clock, "consumeTimeRange");
 
-    auto& inlet = getInlet<DataType>(id_);
+    auto& inlet = *inletRef_;
+    auto l      = lockForWriting(inlet);  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
+    return getFromTimeRange(inlet, timeStart, timeEnd, clock, true);
+}
+
+LSL_streamer::NumericSamples LSL_streamer::consumeNumericN(const uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
+{
+    // deal with default arguments
+    const auto N    = NSamp_.value_or(defaults::consumeNSamp);
+    const auto side = side_ .value_or(defaults::consumeSide);
+
+    const auto inletRef = getInlet<numeric>(id_);
+    auto& inlet = *inletRef;
+    auto l      = lockForWriting(inlet);
+
+    auto [start, end] = getTieredIndicesFromSampleAndSide(inlet, N, side);
+    return getNumericSamples(inlet, start, end, true);
+}
+LSL_streamer::NumericSamples LSL_streamer::consumeNumericTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    // deal with default arguments
+    const auto timeStart        = timeStart_      .value_or(defaults::consumeTimeRangeStart);
+    const auto timeEnd          = timeEnd_        .value_or(defaults::consumeTimeRangeEnd);
+    const auto clock            = clock_          .value_or(defaults::timeClock);
+    checkTimeClock<numeric>(clock, "consumeNumericTimeRange");
+
+    const auto inletRef = getInlet<numeric>(id_);
+    auto& inlet = *inletRef;
     auto l      = lockForWriting(inlet);  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
-    auto& buf   = getBuffer(inlet);
 
-    auto [startIt, endIt, whole] = getIteratorsFromTimeRange(buf, timeStart, timeEnd, timeIsLocalTime);
-    return consumeFromVec(buf, startIt, endIt);
+    auto [start, end] = getTieredIndicesFromTimeRange(inlet, timeStart, timeEnd, clock);
+    return getNumericSamples(inlet, start, end, true);
+}
+LSL_streamer::NumericSamples LSL_streamer::peekNumericN(const uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
+{
+    // deal with default arguments
+    const auto N    = NSamp_.value_or(defaults::peekNSamp);
+    const auto side = side_ .value_or(defaults::peekSide);
+
+    const auto inletRef = getInlet<numeric>(id_);
+    auto& inlet = *inletRef;
+    auto l      = lockForReading(inlet);
+
+    auto [start, end] = getTieredIndicesFromSampleAndSide(inlet, N, side);
+    return getNumericSamples(inlet, start, end, false);
+}
+LSL_streamer::NumericSamples LSL_streamer::peekNumericTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    // deal with default arguments
+    auto timeStart       = timeStart_      .value_or(defaults::peekTimeRangeStart);
+    auto timeEnd         = timeEnd_        .value_or(defaults::peekTimeRangeEnd);
+    auto clock           = clock_          .value_or(defaults::timeClock);
+    checkTimeClock<numeric>(clock, "peekNumericTimeRange");
+
+    const auto inletRef = getInlet<numeric>(id_);
+    auto& inlet = *inletRef;
+    auto l      = lockForReading(inlet);
+
+    auto [start, end] = getTieredIndicesFromTimeRange(inlet, timeStart, timeEnd, clock);
+    return getNumericSamples(inlet, start, end, false);
+}
+
+LSL_streamer::SampleBundle LSL_streamer::consumeTimeRangeMulti(std::span<const uint32_t> ids_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_, std::optional<bool> toWatermark_)
+{
+    // deal with default arguments
+    const auto timeStart        = timeStart_      .value_or(defaults::consumeTimeRangeStart);
+    const auto timeEnd          = timeEnd_        .value_or(defaults::consumeTimeRangeEnd);
+    const auto clock            = clock_          .value_or(defaults::timeClock);
+    const auto toWatermark      = toWatermark_    .value_or(defaults::multiToWatermark);
+
+    return getTimeRangeMulti(ids_, timeStart, timeEnd, clock, toWatermark, true, "consumeTimeRangeMulti");
+}
+LSL_streamer::SampleBundle LSL_streamer::peekTimeRangeMulti(std::span<const uint32_t> ids_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_, std::optional<bool> toWatermark_)
+{
+    // deal with default arguments
+    const auto timeStart        = timeStart_      .value_or(defaults::peekTimeRangeStart);
+    const auto timeEnd          = timeEnd_        .value_or(defaults::peekTimeRangeEnd);
+    const auto clock            = clock_          .value_or(defaults::timeClock);
+    const auto toWatermark      = toWatermark_    .value_or(defaults::multiToWatermark);
+
+    return getTimeRangeMulti(ids_, timeStart, timeEnd, clock, toWatermark, false, "peekTimeRangeMulti");
+}
+LSL_streamer::SampleBundle LSL_streamer::getTimeRangeMulti(std::span<const uint32_t> ids_, const int64_t timeStart_, int64_t timeEnd_, const TimeClock clock_, const bool toWatermark_, const bool consume_, const std::string_view function_)
+{
+    // look up all inlets before locking any
+    std::vector<std::shared_ptr<AllInlets>> inlets;
+    inlets.reserve(ids_.size());
+    for (const auto id : ids_)
+    {
+        inlets.push_back(getAllInletsVariant(id));
+        std::visit([&]<typename T>(Inlet<T>&) { checkTimeClock<T>(clock_, function_); }, *inlets.back());
+    }
+
+    // lock all inlets together
+    std::vector<std::pair<uint32_t, mutex_type*>> mutexes;
+    mutexes.reserve(ids_.size());
+    for (size_t i = 0; i < ids_.size(); i++)
+        mutexes.emplace_back(ids_[i], std::visit([](auto& in_) { return &in_._mutex; }, *inlets[i]));
+    std::vector<read_lock>  readLocks;
+    std::vector<write_lock> writeLocks;
+    if (consume_)
+        writeLocks = lockInletsInOrder<write_lock>(std::move(mutexes), function_);
+    else
+        readLocks  = lockInletsInOrder<read_lock>(std::move(mutexes), function_);
+
+    // while all are locked, no inlet receives new samples, so the watermark holds for all of them.
+    // NB: irregular rate streams are sparse, their newest sample says little about how far the
+    // others have come, so they do not hold back the watermark
+    if (toWatermark_)
+        for (const auto& inlet : inlets)
+            std::visit(
+                [&](auto& in_) {
+                    if (in_._irregularRate)
+                        return;
+                    if (const auto newest = getNewestTimeStamp(in_, clock_))
+                        timeEnd_ = std::min(timeEnd_, *newest);
+                }, *inlet);
+
+    SampleBundle out;
+    out.timeEnd = timeEnd_;
+    out.samples.reserve(inlets.size());
+    for (const auto& inlet : inlets)
+        out.samples.push_back(std::visit(
+            [&]<typename T>(Inlet<T>& in_) -> AllSamples {
+                if constexpr (std::is_same_v<T, numeric>)
+                {
+                    auto [start, end] = getTieredIndicesFromTimeRange(in_, timeStart_, timeEnd_, clock_);
+                    return getNumericSamples(in_, start, end, consume_);
+                }
+                else
+                    return getFromTimeRange(in_, timeStart_, timeEnd_, clock_, consume_);
+            }, *inlet));
+    return out;
+}
+
+LSL_streamer::GazeWithSignals LSL_streamer::peekGazeWithSignals(const uint32_t gazeId_, const uint32_t extSignalId_, std::optional<uint32_t> timeSyncId_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    // deal with default arguments
+    const auto timeStart        = timeStart_      .value_or(defaults::peekTimeRangeStart);
+    const auto timeEnd          = timeEnd_        .value_or(defaults::peekTimeRangeEnd);
+    const auto clock            = clock_          .value_or(defaults::timeClock);
+
+    const auto gazeRef          = getInlet<gaze>(gazeId_);
+    const auto extSignalRef     = getInlet<extSignal>(extSignalId_);
+    const auto timeSyncRef      = timeSyncId_ ? getInlet<timeSync>(*timeSyncId_) : nullptr;
+
+    // lock all inlets together
+    std::vector<std::pair<uint32_t, mutex_type*>> mutexes{{gazeId_, &gazeRef->_mutex}, {extSignalId_, &extSignalRef->_mutex}};
+    if (timeSyncRef)
+        mutexes.emplace_back(*timeSyncId_, &timeSyncRef->_mutex);
+    const auto locks = lockInletsInOrder<read_lock>(std::move(mutexes), "peekGazeWithSignals");
+
+    // signals from the last one before the range on, so that the first gaze samples have one too
+    const auto getSignals = [&](auto& inlet_)
+    {
+        auto [start, end] = getTieredIndicesFromTimeRange(inlet_, timeStart, timeEnd, clock);
+        return getFromTiers(inlet_, start ? start - 1 : 0, end, false);
+    };
+
+    GazeWithSignals out;
+    out.samples = getFromTimeRange(*gazeRef, timeStart, timeEnd, clock, false);
+    const auto n = out.samples.size();
+
+    const auto extSignals = getSignals(*extSignalRef);
+    out.extSignalValue    .resize(n);
+    out.extSignalTimeStamp.resize(n);
+    asOfJoin(out.samples, extSignals, clock,
+        [&](const size_t i_, const extSignal* s_) {
+            out.extSignalValue[i_]     = s_ ? s_->extSignalData.value : 0;
+            out.extSignalTimeStamp[i_] = s_ ? LSLTypes::getTimeStamp(*s_, clock) : -1;
+        });
+
+    if (timeSyncRef)
+    {
+        const auto timeSyncs = getSignals(*timeSyncRef);
+        out.timeSyncRoundTrip.resize(n);
+        asOfJoin(out.samples, timeSyncs, clock,
+            [&](const size_t i_, const timeSync* s_) {
+                out.timeSyncRoundTrip[i_] = s_ ? s_->timeSyncData.system_response_time_stamp - s_->timeSyncData.system_request_time_stamp : -1;
+            });
+    }
+    return out;
+}
+
+LSL_streamer::ResampledBundle LSL_streamer::resample(std::span<const uint32_t> ids_, const double rate_, const int64_t timeStart_, const int64_t timeEnd_)
+{
+    if (ids_.empty())
+        DoExitWithMsg("LSL_streamer::cpp::resample: no inlets provided");
+    if (!std::isfinite(rate_) || rate_ <= 0.)
+        DoExitWithMsg(std::format("LSL_streamer::cpp::resample: rate must be a positive number, {} was given", rate_));
+    if (timeEnd_ < timeStart_)
+        DoExitWithMsg("LSL_streamer::cpp::resample: end of the time range is before its start");
+
+    // look up all inlets first, so that nothing is done if any of them cannot be resampled
+    std::vector<std::shared_ptr<AllInlets>> inlets;
+    inlets.reserve(ids_.size());
+    for (const auto id : ids_)
+    {
+        inlets.push_back(getAllInletsVariant(id));
+        std::visit(
+            [&]<typename DataType>(Inlet<DataType>&) {
+                if constexpr (!std::is_same_v<DataType, gaze> && !std::is_same_v<DataType, numeric>)
+                    DoExitWithMsg(std::format("LSL_streamer::cpp::resample: inlet with id {} is a {} inlet, only gaze and numeric inlets can be resampled", id, getInletTypeName<DataType>()));
+            }, *inlets.back());
+    }
+
+    // the range the inlets have samples in. NB: may change before the inlets are resampled,
+    // that only affects which grid points at the edges get values
+    std::optional<std::pair<int64_t, int64_t>> extent;
+    for (const auto& inlet : inlets)
+        std::visit(
+            [&](auto& in_) {
+                auto l = lockForReading(in_);
+                if (const auto e = getTimeExtent(in_, LSLTypes::TimeClock::Local))
+                    extent = extent ? std::pair{std::min(extent->first, e->first), std::max(extent->second, e->second)} : *e;
+            }, *inlet);
+
+    // the grid, in us on the local clock. Only the points from timeStart_ on that fall within the
+    // extent of the inlets' samples, others would not get values anyway
+    ResampledBundle out;
+    const auto period = 1'000'000. / rate_;
+    if (extent && extent->second >= timeStart_ && extent->first <= timeEnd_)
+    {
+        // NB: in double, int64_t differences may overflow for very wide ranges
+        const auto first = std::ceil ((static_cast<double>(std::max(extent->first , timeStart_)) - static_cast<double>(timeStart_)) / period);
+        const auto last  = std::floor((static_cast<double>(std::min(extent->second, timeEnd_  )) - static_cast<double>(timeStart_)) / period);
+        if (last - first + 1. > static_cast<double>(defaults::resampleMaxGridPoints))
+            DoExitWithMsg(std::format("LSL_streamer::cpp::resample: the inlets' samples in the time range would be resampled onto {} grid points, at most {} are supported. Use a shorter time range or a lower rate", last - first + 1., defaults::resampleMaxGridPoints));
+        if (last >= first)
+            out.timeStamps.reserve(static_cast<size_t>(last - first + 1.));
+        for (auto k = first; k <= last; k++)
+            out.timeStamps.push_back(timeStart_ + std::llround(k * period));
+    }
+
+    // each inlet is resampled on its own thread and only locked while its samples are copied
+    std::vector<std::future<ResampledStream>> streams;
+    streams.reserve(inlets.size());
+    for (const auto& inlet : inlets)
+        streams.push_back(std::async(inlets.size() > 1 ? std::launch::async : std::launch::deferred,
+            [&out, inlet]() { return std::visit([&](auto& in_) { return resampleInlet(in_, out.timeStamps); }, *inlet); }));
+    out.streams.reserve(streams.size());
+    for (auto& s : streams)
+        out.streams.push_back(s.get());
+    return out;
+}
+
+void LSL_streamer::setMemoryBudget(const uint32_t id_, const size_t bytes_, std::optional<MemoryPolicy> policy_)
+{
+    // deal with default arguments
+    const auto policy = policy_.value_or(defaults::memoryPolicy);
+
+    std::visit(
+        [&]<typename T>(Inlet<T>& in_) {
+            if constexpr (!hasOlderTier_v<T>)
+                if (policy == MemoryPolicy::SpillToDisk || policy == MemoryPolicy::Compress)
+                    DoExitWithMsg(std::format("LSL_streamer::cpp::setMemoryBudget: inlet with id {} is an eye image, numeric or marker inlet, whose samples cannot be spilled to disk or compressed. Use the DropOldest or StopIngest policy.", id_));
+            auto l = lockForWriting(in_);
+            in_._memoryBudget = bytes_;
+            in_._memoryPolicy = policy;
+        }, *getAllInletsVariant(id_));
+}
+void LSL_streamer::setSpillDirectory(std::filesystem::path directory_)
+{
+    std::lock_guard l(_inletMemory->spillDirectoryMutex);
+    _inletMemory->spillDirectory = std::move(directory_);
+}
+void LSL_streamer::setGlobalMemoryBudget(const size_t bytes_, std::optional<MemoryPolicy> policy_)
+{
+    // deal with default arguments
+    const auto policy = policy_.value_or(defaults::memoryPolicy);
+
+    // not an error, as the global policy also applies to inlets that can spill or compress
+    if (bytes_ && (policy == MemoryPolicy::SpillToDisk || policy == MemoryPolicy::Compress))
+        RelayMsg("LSL_streamer::setGlobalMemoryBudget: eye image, numeric and marker inlets cannot spill to disk or compress their samples, they drop their oldest samples instead when over the global budget.");
+
+    _inletMemory->policy = policy;
+    _inletMemory->budget = bytes_;
+}
+LSL_streamer::MemoryStats LSL_streamer::getMemoryStats(const uint32_t id_) const
+{
+    return getMemoryStats(*getAllInletsVariant(id_));
+}
+LSL_streamer::MemoryStats LSL_streamer::getMemoryStats(AllInlets& inlet_)
+{
+    return std::visit(
+        []<typename T>(Inlet<T>& in_) {
+            auto l = lockForReading(in_);
+            MemoryStats out;
+            out.bytesUsed       = in_._bytesUsed;
+            constexpr auto sampleBytes = sizeof(typename Inlet<T>::stored_t);
+            out.bytesCapacity   = getBuffer(in_).capacity() * sampleBytes;
+            for (const auto& b : in_._bufferPool)
+                out.bytesCapacity += b.capacity() * sampleBytes;
+            if constexpr (std::is_same_v<T, numeric>)
+                out.bytesCapacity += std::visit([]<typename V>(const std::vector<V>& values_) { return values_.capacity() * sizeof(V); }, in_._values);
+            out.highWaterMark   = in_._highWaterMark;
+            if constexpr (hasOlderTier_v<T>)
+            {
+                if (in_._olderTier)
+                    (in_._olderTier->isInMemory() ? out.bytesCompressed : out.bytesSpilled) = in_._olderTier->bytes();
+            }
+            out.samplesDropped  = in_._samplesDropped;
+            out.ingestStopped   = in_._ingestStopped;
+            return out;
+        }, inlet_);
+}
+LSL_streamer::MemoryStats LSL_streamer::getGlobalMemoryStats() const
+{
+    MemoryStats out;
+    for (const auto& inlet : _inStreams.getAll())
+    {
+        const auto s = getMemoryStats(*inlet);
+        out.bytesCapacity   += s.bytesCapacity;
+        out.bytesSpilled    += s.bytesSpilled;
+        out.bytesCompressed += s.bytesCompressed;
+        out.samplesDropped  += s.samplesDropped;
+        out.ingestStopped    = out.ingestStopped || s.ingestStopped;
+    }
+    out.bytesUsed       = _inletMemory->bytesUsed;
+    out.highWaterMark   = _inletMemory->highWaterMark;
+    return out;
+}
+
+template <typename DataType>
+void LSL_streamer::returnBuffer(const uint32_t id_, std::vector<DataType>&& buffer_)
+{
+    // destroy samples outside of the lock
+    auto buffer = std::move(buffer_);
+    buffer.clear();
+
+    const auto inletRef = getInlet<DataType>(id_);
+    auto& inlet = *inletRef;
+    // packed samples are stored in a different type of buffer, which keeps its storage anyway
+    if constexpr (!LSLTypes::isPacked_v<DataType>)
+    {
+        auto l      = lockForWriting(inlet);
+        if (buffer.capacity() >= inlet._bufferCapacity && inlet._bufferPool.size() < defaults::bufferPoolSize)
+            inlet._bufferPool.push_back(std::move(buffer));
+        inlet._spareBufferWanted = inlet._bufferPool.size() < defaults::bufferPoolSize;
+        // NB: if not kept, buffer is freed after the lock is released
+        // (locals are destroyed in reverse order of declaration)
+    }
+}
+
+void LSL_streamer::addCursor(const uint32_t id_, std::string cursor_, std::optional<bool> fromStart_)
+{
+    // deal with default arguments
+    const auto fromStart = fromStart_.value_or(defaults::cursorFromStart);
+
+    std::visit(
+        [&]<typename T>(Inlet<T>& in_) {
+            if constexpr (std::is_same_v<T, numeric>)
+                DoExitWithMsg(std::format("LSL_streamer::addCursor: inlet with id {} is a numeric inlet, cursors are not available for these", id_));
+            auto l = lockForWriting(in_);
+            if (in_._cursors.contains(cursor_))
+                DoExitWithMsg(std::format("LSL_streamer::addCursor: inlet with id {} already has a cursor named {}", id_, cursor_));
+            in_._cursors.emplace(std::move(cursor_), fromStart ? 0 : getNumInOlderTier(in_) + std::size(getBuffer(in_)));
+        }, *getAllInletsVariant(id_));
+}
+void LSL_streamer::removeCursor(const uint32_t id_, const std::string& cursor_)
+{
+    std::visit(
+        [&]<typename T>(Inlet<T>& in_) {
+            auto l = lockForWriting(in_);
+            if (!in_._cursors.erase(cursor_))
+                DoExitWithMsg(std::format("LSL_streamer::removeCursor: inlet with id {} has no cursor named {}", id_, cursor_));
+            // the removed cursor may have been holding back reclamation
+            reclaimBehindCursors(in_);
+        }, *getAllInletsVariant(id_));
+}
+std::vector<std::string> LSL_streamer::getCursors(const uint32_t id_) const
+{
+    return std::visit(
+        []<typename T>(Inlet<T>& in_) {
+            auto l = lockForReading(in_);
+            std::vector<std::string> out;
+            out.reserve(in_._cursors.size());
+            std::ranges::copy(in_._cursors | std::views::keys, std::back_inserter(out));
+            return out;
+        }, *getAllInletsVariant(id_));
+}
+template <typename DataType>
+std::vector<DataType> LSL_streamer::consumeN(const uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_)
+{
+    // deal with default arguments
+    const auto N    = NSamp_.value_or(defaults::consumeNSamp);
+
+    const auto inletRef = getInlet<DataType>(id_);
+    auto& inlet = *inletRef;
+    auto l      = lockForWriting(inlet);
+    auto& pos   = getCursor(inlet, cursor_, id_);
+
+    // copy out unread samples, other cursors may still need them. NB: unread
+    // samples may have been moved to the older tier, are read from there
+    const auto total= getNumInOlderTier(inlet) + std::size(getBuffer(inlet));
+    const auto n    = std::min(N, total - pos);
+    auto out        = getFromTiers(inlet, pos, pos + n, false);
+    pos += n;
+
+    reclaimBehindCursors(inlet);
+    return out;
 }
 
 template <typename DataType>
 std::vector<DataType> LSL_streamer::peekN(const uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
+{
+    return peekN(getInlet<DataType>(id_), NSamp_, side_);
+}
+template <typename DataType>
+std::vector<DataType> LSL_streamer::peekN(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
+{
+    // deal with default arguments
+    const auto N    = NSamp_.value_or(defaults::peekNSamp);
+    const auto side = side_ .value_or(defaults::peekSide);
+
+    auto& inlet = *inletRef_;
+    auto l      = lockForReading(inlet);
+    auto& buf   = getBuffer(inlet);
+
+    if (getNumInOlderTier(inlet))
+    {
+        auto [start, end] = getTieredIndicesFromSampleAndSide(inlet, N, side);
+        return getFromTiers(inlet, start, end, false);
+    }
+
+    auto [startIt, endIt] = BufferOps::getIteratorsFromSampleAndSide(buf, N, side);
+    return copyFromBuffer<DataType>(startIt, endIt);
+}
+template <typename DataType>
+std::vector<DataType> LSL_streamer::peekTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    return peekTimeRange(getInlet<DataType>(id_), timeStart_, timeEnd_, clock_);
+}
+template <typename DataType>
+std::vector<DataType> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    // deal with default arguments
+    auto timeStart       = timeStart_      .value_or(defaults::peekTimeRangeStart);
+    auto timeEnd         = timeEnd_        .value_or(defaults::peekTimeRangeEnd);
+    auto clock           = clock_          .value_or(defaults::timeClock);
+    checkTimeClock<DataType>(clock, "peekTimeRange");
+
+    auto& inlet     = *inletRef_;
+    auto l          = lockForReading(inlet);
+    return getFromTimeRange(inlet, timeStart, timeEnd, clock, false);
+}
+
+template <typename DataType>
+LSL_streamer::BufferView<DataType> LSL_streamer::peekNView(const uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
+{
+    return peekNView(getInlet<DataType>(id_), NSamp_, side_);
+}
+template <typename DataType>
+LSL_streamer::BufferView<DataType> LSL_streamer::peekNView(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_)
 {
     // deal with default arguments
     const auto N    = NSamp_.value_or(defaults::peekNSamp);
     const auto side = side_ .value_or(defaults::peekSide);
 
-    auto& inlet = getInlet<DataType>(id_);
+    auto& inlet = *inletRef_;
     auto l      = lockForReading(inlet);
     auto& buf   = getBuffer(inlet);
 
-    auto [startIt, endIt] = getIteratorsFromSampleAndSide(buf, N, side);
-    return peekFromVec(buf, startIt, endIt);
+    auto [startIt, endIt] = BufferOps::getIteratorsFromSampleAndSide(buf, N, side);
+    return BufferView<DataType>(inletRef_, std::move(l), BufferOps::viewFromVec(startIt, endIt));
 }
 template <typename DataType>
-std::vector<DataType> LSL_streamer::peekTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_)
+LSL_streamer::BufferView<DataType> LSL_streamer::peekTimeRangeView(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
+{
+    return peekTimeRangeView(getInlet<DataType>(id_), timeStart_, timeEnd_, clock_);
+}
+template <typename DataType>
+LSL_streamer::BufferView<DataType> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<DataType>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
 {
     // deal with default arguments
     auto timeStart       = timeStart_      .value_or(defaults::peekTimeRangeStart);
     auto timeEnd         = timeEnd_        .value_or(defaults::peekTimeRangeEnd);
-    auto timeIsLocalTime = timeIsLocalTime_.value_or(defaults::timeIsLocalTime);
+    auto clock           = clock_          .value_or(defaults::timeClock);
+    checkTimeClock<DataType>(clock, "peekTimeRangeView");
 
-    auto& inlet     = getInlet<DataType>(id_);
+    auto& inlet     = *inletRef_;
     auto l          = lockForReading(inlet);
     auto& buf       = getBuffer(inlet);
 
-    auto [startIt, endIt, whole] = getIteratorsFromTimeRange(buf, timeStart, timeEnd, timeIsLocalTime);
-    return peekFromVec(buf, startIt, endIt);
+    auto [startIt, endIt, whole] = BufferOps::getIteratorsFromTimeRange(buf, timeStart, timeEnd, clock, inlet._timeRuns[clock]);
+    return BufferView<DataType>(inletRef_, std::move(l), BufferOps::viewFromVec(startIt, endIt));
 }
 
 void LSL_streamer::clear(const uint32_t id_)
 {
-    // visit with generic lambda so we get the inlet, lock and cal clear() on its buffer
-    const auto stream = getInletType(id_);
-    if (stream == Titta::Stream::Positioning)
-    {
-        auto& inlet = getInlet<positioning>(id_);
-        auto l      = lockForWriting(inlet);    // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
-        auto& buf   = getBuffer(inlet);
-        if (std::empty(buf))
-            return;
-        buf.clear();
-    }
-    else
-        clearTimeRange(id_);
+    clearTimeRange(id_);
 }
-void LSL_streamer::clearTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_)
+void LSL_streamer::clearTimeRange(const uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_)
 {
     // deal with default arguments
     const auto timeStart        = timeStart_      .value_or(defaults::clearTimeRangeStart);
     const auto timeEnd          = timeEnd_        .value_or(defaults::clearTimeRangeEnd);
-    const auto timeIsLocalTime  = timeIsLocalTime_.value_or(defaults::timeIsLocalTime);
+    const auto clock            = clock_          .value_or(defaults::timeClock);
 
-    // visit with templated lambda that allows us to get the data type, then
-    // check if type is positioning, error, else forward. May need to split in two
-    // overloaded lambdas actually, first for positioning, then templated generic
     switch (getInletType(id_))
     {
         case Titta::Stream::Gaze:
         case Titta::Stream::EyeOpenness:
-            clearVec(getInlet<LSL_streamer::gaze>(id_), timeStart, timeEnd, timeIsLocalTime);
+            clearVec(*getInlet<LSL_streamer::gaze>(id_), timeStart, timeEnd, clock);
             break;
         case Titta::Stream::EyeImage:
-            clearVec(getInlet<LSL_streamer::eyeImage>(id_), timeStart, timeEnd, timeIsLocalTime);
+            clearVec(*getInlet<LSL_streamer::eyeImage>(id_), timeStart, timeEnd, clock);
             break;
         case Titta::Stream::ExtSignal:
-            clearVec(getInlet<LSL_streamer::extSignal>(id_), timeStart, timeEnd, timeIsLocalTime);
+            clearVec(*getInlet<LSL_streamer::extSignal>(id_), timeStart, timeEnd, clock);
             break;
         case Titta::Stream::TimeSync:
-            clearVec(getInlet<LSL_streamer::timeSync>(id_), timeStart, timeEnd, timeIsLocalTime);
+            clearVec(*getInlet<LSL_streamer::timeSync>(id_), timeStart, timeEnd, clock);
             break;
         case Titta::Stream::Positioning:
-            DoExitWithMsg("Titta::cpp::clearTimeRange: not supported for the positioning stream.");
+            checkTimeClock<LSL_streamer::positioning>(clock, "clearTimeRange");
+            clearVec(*getInlet<LSL_streamer::positioning>(id_), timeStart, timeEnd, clock);
+            break;
+        case Titta::Stream::Unknown:    // generic numeric or marker inlet
+            if (isMarkerInlet(id_))
+            {
+                checkTimeClock<LSL_streamer::marker>(clock, "clearTimeRange");
+                clearVec(*getInlet<LSL_streamer::marker>(id_), timeStart, timeEnd, clock);
+            }
+            else
+            {
+                checkTimeClock<LSL_streamer::numeric>(clock, "clearTimeRange");
+                clearVec(*getInlet<LSL_streamer::numeric>(id_), timeStart, timeEnd, clock);
+            }
             break;
     }
 }
@@ -1704,60 +3193,157 @@ void LSL_streamer::stopListening(const uint32_t id_, std::optional<bool> clearBu
     // deal with default arguments
     const auto clearBuffer = clearBuffer_.value_or(defaults::stopBufferEmpties);
 
-    auto& inlet = getAllInletsVariant(id_);
-    auto& lsl_inlet = getLSLInlet(inlet);
-
-    // stop thread
-    setWorkerThreadStopFlag(inlet);
-    getWorkerThread(inlet)->join();
-
-    // close stream
-    lsl_inlet.close_stream();
-
-    // flush to be sure there's nothing stale left in LSL's buffers that would appear when we restart
-    lsl_inlet.flush();
+    stopRecorder(*getAllInletsVariant(id_));
 
     // clean up if wanted
     if (clearBuffer)
         clear(id_);
 }
+void LSL_streamer::stopRecorder(AllInlets& inlet_, const bool final_)
+{
+    std::visit(
+        [final_]<typename T>(Inlet<T>& in_) {
+            std::lock_guard l(in_._recorderMutex);
+            // NB: set under the lock, so that a concurrent startListening() either
+            // starts before us (and its thread is stopped below) or sees the flag
+            if (final_)
+                in_._deleted = true;
+            // stop thread, if running. It notices within a pull timeout
+            if (in_._recorder)
+            {
+                in_._recorder_should_stop = true;
+                in_._recorder->join();
+                in_._recorder.reset();
+                in_._recorder_should_stop = false;
+            }
+
+            // close stream
+            in_._lsl_inlet.close_stream();
+
+            // flush to be sure there's nothing stale left in LSL's buffers that would appear when we restart
+            in_._lsl_inlet.flush();
+        }, inlet_);
+}
 
 void LSL_streamer::deleteListener(const uint32_t id_)
 {
-    stopListening(id_);
-    // stop time syncer
+    // remove from registry first, so that no new calls can get at the inlet
+    const auto inlet = _inStreams.remove(id_);
+    if (!inlet)
+        DoExitWithMsg(std::format("No inlet with id {} is known", id_));
 
-    // delete entry to clean it all up
-    _inStreams.erase(id_);
+    stopRecorder(*inlet, true);
+    // NB: calls still using the inlet on other threads keep it alive, it is
+    // destroyed (and its samples removed from the global memory accounting)
+    // when the last of them is done
 }
 
+// generic outlets, instantiate templated functions
+template void LSL_streamer::pushNumericChunk(uint32_t id_, std::span<const float> data_, std::span<const int64_t> timeStamps_);
+template void LSL_streamer::pushNumericChunk(uint32_t id_, std::span<const double> data_, std::span<const int64_t> timeStamps_);
+template void LSL_streamer::pushNumericChunk(uint32_t id_, std::span<const int8_t> data_, std::span<const int64_t> timeStamps_);
+template void LSL_streamer::pushNumericChunk(uint32_t id_, std::span<const int16_t> data_, std::span<const int64_t> timeStamps_);
+template void LSL_streamer::pushNumericChunk(uint32_t id_, std::span<const int32_t> data_, std::span<const int64_t> timeStamps_);
+template void LSL_streamer::pushNumericChunk(uint32_t id_, std::span<const int64_t> data_, std::span<const int64_t> timeStamps_);
+
 // gaze data (including eye openness), instantiate templated functions
 template std::vector<LSL_streamer::gaze> LSL_streamer::consumeN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::gaze> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::gaze> LSL_streamer::consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_);
+template void LSL_streamer::returnBuffer(uint32_t id_, std::vector<LSL_streamer::gaze>&& buffer_);
+template std::vector<LSL_streamer::gaze> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 template std::vector<LSL_streamer::gaze> LSL_streamer::peekN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::gaze> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::gaze> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::gaze> LSL_streamer::peekNView(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::InletHandle<LSL_streamer::gaze> LSL_streamer::getInletHandle(uint32_t id_) const;
+template std::vector<LSL_streamer::gaze> LSL_streamer::consumeN(const std::shared_ptr<Inlet<LSL_streamer::gaze>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::gaze> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<LSL_streamer::gaze>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::gaze> LSL_streamer::peekN(const std::shared_ptr<Inlet<LSL_streamer::gaze>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::gaze> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<LSL_streamer::gaze>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::gaze> LSL_streamer::peekNView(const std::shared_ptr<Inlet<LSL_streamer::gaze>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::BufferView<LSL_streamer::gaze> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<LSL_streamer::gaze>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::gaze> LSL_streamer::peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 
 // eye images, instantiate templated functions
 template std::vector<LSL_streamer::eyeImage> LSL_streamer::consumeN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::eyeImage> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_);
+template void LSL_streamer::returnBuffer(uint32_t id_, std::vector<LSL_streamer::eyeImage>&& buffer_);
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 template std::vector<LSL_streamer::eyeImage> LSL_streamer::peekN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::eyeImage> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::eyeImage> LSL_streamer::peekNView(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::InletHandle<LSL_streamer::eyeImage> LSL_streamer::getInletHandle(uint32_t id_) const;
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::consumeN(const std::shared_ptr<Inlet<LSL_streamer::eyeImage>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<LSL_streamer::eyeImage>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::peekN(const std::shared_ptr<Inlet<LSL_streamer::eyeImage>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::eyeImage> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<LSL_streamer::eyeImage>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::eyeImage> LSL_streamer::peekNView(const std::shared_ptr<Inlet<LSL_streamer::eyeImage>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::BufferView<LSL_streamer::eyeImage> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<LSL_streamer::eyeImage>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::eyeImage> LSL_streamer::peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 
 // external signals, instantiate templated functions
 template std::vector<LSL_streamer::extSignal> LSL_streamer::consumeN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::extSignal> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::extSignal> LSL_streamer::consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_);
+template void LSL_streamer::returnBuffer(uint32_t id_, std::vector<LSL_streamer::extSignal>&& buffer_);
+template std::vector<LSL_streamer::extSignal> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 template std::vector<LSL_streamer::extSignal> LSL_streamer::peekN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::extSignal> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::extSignal> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::extSignal> LSL_streamer::peekNView(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::InletHandle<LSL_streamer::extSignal> LSL_streamer::getInletHandle(uint32_t id_) const;
+template std::vector<LSL_streamer::extSignal> LSL_streamer::consumeN(const std::shared_ptr<Inlet<LSL_streamer::extSignal>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::extSignal> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<LSL_streamer::extSignal>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::extSignal> LSL_streamer::peekN(const std::shared_ptr<Inlet<LSL_streamer::extSignal>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::extSignal> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<LSL_streamer::extSignal>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::extSignal> LSL_streamer::peekNView(const std::shared_ptr<Inlet<LSL_streamer::extSignal>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::BufferView<LSL_streamer::extSignal> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<LSL_streamer::extSignal>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::extSignal> LSL_streamer::peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 
 // time sync data, instantiate templated functions
 template std::vector<LSL_streamer::timeSync> LSL_streamer::consumeN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::timeSync> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::timeSync> LSL_streamer::consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_);
+template void LSL_streamer::returnBuffer(uint32_t id_, std::vector<LSL_streamer::timeSync>&& buffer_);
+template std::vector<LSL_streamer::timeSync> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 template std::vector<LSL_streamer::timeSync> LSL_streamer::peekN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-template std::vector<LSL_streamer::timeSync> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+template std::vector<LSL_streamer::timeSync> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::timeSync> LSL_streamer::peekNView(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::InletHandle<LSL_streamer::timeSync> LSL_streamer::getInletHandle(uint32_t id_) const;
+template std::vector<LSL_streamer::timeSync> LSL_streamer::consumeN(const std::shared_ptr<Inlet<LSL_streamer::timeSync>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::timeSync> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<LSL_streamer::timeSync>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::timeSync> LSL_streamer::peekN(const std::shared_ptr<Inlet<LSL_streamer::timeSync>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::timeSync> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<LSL_streamer::timeSync>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::timeSync> LSL_streamer::peekNView(const std::shared_ptr<Inlet<LSL_streamer::timeSync>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::BufferView<LSL_streamer::timeSync> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<LSL_streamer::timeSync>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::timeSync> LSL_streamer::peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 
 // positioning data, instantiate templated functions
-// NB: positioning data does not have timestamps, so the Time Range version of the below functions are not defined for the positioning stream
 template std::vector<LSL_streamer::positioning> LSL_streamer::consumeN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-//template std::vector<LSL_streamer::positioning> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
+template std::vector<LSL_streamer::positioning> LSL_streamer::consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_);
+template void LSL_streamer::returnBuffer(uint32_t id_, std::vector<LSL_streamer::positioning>&& buffer_);
+template std::vector<LSL_streamer::positioning> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
 template std::vector<LSL_streamer::positioning> LSL_streamer::peekN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
-//template std::vector<LSL_streamer::positioning> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
+template std::vector<LSL_streamer::positioning> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::positioning> LSL_streamer::peekNView(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::InletHandle<LSL_streamer::positioning> LSL_streamer::getInletHandle(uint32_t id_) const;
+template std::vector<LSL_streamer::positioning> LSL_streamer::consumeN(const std::shared_ptr<Inlet<LSL_streamer::positioning>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::positioning> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<LSL_streamer::positioning>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::positioning> LSL_streamer::peekN(const std::shared_ptr<Inlet<LSL_streamer::positioning>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::positioning> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<LSL_streamer::positioning>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::positioning> LSL_streamer::peekNView(const std::shared_ptr<Inlet<LSL_streamer::positioning>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::BufferView<LSL_streamer::positioning> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<LSL_streamer::positioning>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::positioning> LSL_streamer::peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+
+// markers, instantiate templated functions
+template std::vector<LSL_streamer::marker> LSL_streamer::consumeN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::marker> LSL_streamer::consumeN(uint32_t id_, const std::string& cursor_, std::optional<size_t> NSamp_);
+template void LSL_streamer::returnBuffer(uint32_t id_, std::vector<LSL_streamer::marker>&& buffer_);
+template std::vector<LSL_streamer::marker> LSL_streamer::consumeTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::marker> LSL_streamer::peekN(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::marker> LSL_streamer::peekTimeRange(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::marker> LSL_streamer::peekNView(uint32_t id_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::InletHandle<LSL_streamer::marker> LSL_streamer::getInletHandle(uint32_t id_) const;
+template std::vector<LSL_streamer::marker> LSL_streamer::consumeN(const std::shared_ptr<Inlet<LSL_streamer::marker>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::marker> LSL_streamer::consumeTimeRange(const std::shared_ptr<Inlet<LSL_streamer::marker>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template std::vector<LSL_streamer::marker> LSL_streamer::peekN(const std::shared_ptr<Inlet<LSL_streamer::marker>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template std::vector<LSL_streamer::marker> LSL_streamer::peekTimeRange(const std::shared_ptr<Inlet<LSL_streamer::marker>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::marker> LSL_streamer::peekNView(const std::shared_ptr<Inlet<LSL_streamer::marker>>& inletRef_, std::optional<size_t> NSamp_, std::optional<Titta::BufferSide> side_);
+template LSL_streamer::BufferView<LSL_streamer::marker> LSL_streamer::peekTimeRangeView(const std::shared_ptr<Inlet<LSL_streamer::marker>>& inletRef_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
+template LSL_streamer::BufferView<LSL_streamer::marker> LSL_streamer::peekTimeRangeView(uint32_t id_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<TimeClock> clock_);
@@ -0,0 +1,163 @@
+#include "LSL_streamer/LSL_streamer_host.h"
+#include <array>
+#include <format>
+#include <ranges>
+#include <algorithm>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    constexpr std::array outletStreams = {Titta::Stream::Gaze, Titta::Stream::EyeImage, Titta::Stream::ExtSignal, Titta::Stream::TimeSync, Titta::Stream::Positioning};
+
+    std::map<Titta::Stream, LSL_streamer::OutletStats> getStats(const LSL_streamer& streamer_)
+    {
+        std::map<Titta::Stream, LSL_streamer::OutletStats> out;
+        for (const auto stream : outletStreams)
+            if (streamer_.isStreaming(stream))
+                out.emplace(stream, streamer_.getOutletStats(stream));
+        return out;
+    }
+}
+
+LSL_streamer_host::LSL_streamer_host(std::optional<size_t> numPusherThreads_) :
+    _pusherPool(std::make_shared<PusherPool>(numPusherThreads_.value_or(0))),
+    _resolver("starts-with(source_id,'LSL_streamer:')")
+{}
+LSL_streamer_host::~LSL_streamer_host()
+{
+    // destroy streamers (which stops their outlets) before the pusher pool they use goes away
+    std::lock_guard l(_streamersMutex);
+    _streamers.clear();
+}
+
+std::string LSL_streamer_host::connect(std::string address_)
+{
+    // reserve the address, then connect without holding the lock: connecting to an
+    // eye tracker takes a while and would block all calls on the other eye trackers
+    {
+        std::lock_guard l(_streamersMutex);
+        if (_streamers.contains(address_) || _connecting.contains(address_))
+            DoExitWithMsg(std::format("LSL_streamer_host::connect: already connected to eye tracker at address {}", address_));
+        _connecting.insert(address_);
+    }
+
+    std::shared_ptr<LSL_streamer> streamer;
+    std::string serial;
+    try
+    {
+        streamer = std::make_shared<LSL_streamer>(address_);
+        streamer->setPusherPool(_pusherPool);
+        serial = streamer->getSerialNumber();
+    }
+    catch (...)
+    {
+        std::lock_guard l(_streamersMutex);
+        _connecting.erase(address_);
+        throw;
+    }
+
+    std::lock_guard l(_streamersMutex);
+    _connecting.erase(address_);
+    _streamers.emplace(std::move(address_), std::move(streamer));
+    return serial;
+}
+void LSL_streamer_host::disconnect(const std::string& address_)
+{
+    std::shared_ptr<LSL_streamer> streamer;
+    {
+        std::lock_guard l(_streamersMutex);
+        auto it = _streamers.find(address_);
+        if (it == _streamers.end())
+            DoExitWithMsg(std::format("LSL_streamer_host::disconnect: not connected to eye tracker at address {}", address_));
+        streamer = std::move(it->second);
+        _streamers.erase(it);
+    }
+    // streamer is destroyed here, outside the lock (unless getStreamer()'s caller still holds it)
+}
+bool LSL_streamer_host::isConnected(const std::string& address_) const
+{
+    std::lock_guard l(_streamersMutex);
+    return _streamers.contains(address_);
+}
+std::vector<std::string> LSL_streamer_host::getConnectedEyeTrackers() const
+{
+    std::lock_guard l(_streamersMutex);
+    std::vector<std::string> out;
+    out.reserve(_streamers.size());
+    std::ranges::copy(_streamers | std::views::keys, std::back_inserter(out));
+    return out;
+}
+std::shared_ptr<LSL_streamer> LSL_streamer_host::getStreamer(const std::string& address_)
+{
+    std::lock_guard l(_streamersMutex);
+    auto it = _streamers.find(address_);
+    if (it == _streamers.end())
+        DoExitWithMsg(std::format("LSL_streamer_host::getStreamer: not connected to eye tracker at address {}", address_));
+    return it->second;
+}
+LSL_streamer& LSL_streamer_host::getStreamerLocked(const std::string& address_) const
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto it = _streamers.find(address_);
+    if (it == _streamers.end())
+        DoExitWithMsg(std::format("LSL_streamer_host: not connected to eye tracker at address {}", address_));
+    return *it->second;
+}
+
+
+bool LSL_streamer_host::startOutlet(const std::string& address_, const Titta::Stream stream_, std::optional<bool> asGif_)
+{
+    std::lock_guard l(_streamersMutex);
+    return getStreamerLocked(address_).startOutlet(stream_, asGif_);
+}
+bool LSL_streamer_host::startOutlet(const std::string& address_, std::string stream_, std::optional<bool> asGif_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    return startOutlet(address_, Titta::stringToStream(std::move(stream_), snake_case_on_stream_not_found, true), asGif_);
+}
+bool LSL_streamer_host::startOutlets(const Titta::Stream stream_, std::optional<bool> asGif_)
+{
+    std::lock_guard l(_streamersMutex);
+    bool success = true;
+    for (const auto& streamer : _streamers | std::views::values)
+        success = streamer->startOutlet(stream_, asGif_) && success;
+    return success;
+}
+void LSL_streamer_host::stopOutlet(const std::string& address_, const Titta::Stream stream_)
+{
+    std::lock_guard l(_streamersMutex);
+    getStreamerLocked(address_).stopOutlet(stream_);
+}
+void LSL_streamer_host::stopOutlets(const Titta::Stream stream_)
+{
+    std::lock_guard l(_streamersMutex);
+    for (const auto& streamer : _streamers | std::views::values)
+        streamer->stopOutlet(stream_);
+}
+
+
+std::map<Titta::Stream, LSL_streamer::OutletStats> LSL_streamer_host::getStreamStats(const std::string& address_) const
+{
+    std::lock_guard l(_streamersMutex);
+    return getStats(getStreamerLocked(address_));
+}
+std::map<std::string, std::map<Titta::Stream, LSL_streamer::OutletStats>> LSL_streamer_host::getAllStreamStats() const
+{
+    std::lock_guard l(_streamersMutex);
+    std::map<std::string, std::map<Titta::Stream, LSL_streamer::OutletStats>> out;
+    for (const auto& [address, streamer] : _streamers)
+        out.emplace(address, getStats(*streamer));
+    return out;
+}
+
+
+std::vector<lsl::stream_info> LSL_streamer_host::getRemoteStreams(std::optional<Titta::Stream> stream_)
+{
+    auto streams = _resolver.results();
+    if (stream_.has_value())
+    {
+        const auto streamName = std::format("Tobii_{}", Titta::streamToString(*stream_));
+        std::erase_if(streams, [&streamName](auto& s_) { return s_.name() != streamName; });
+    }
+    return streams;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <tuple>
+#include <iterator>
+#include <algorithm>
+
+#include "Titta/Titta.h"
+#include "Titta/utils.h"
+#include "LSL_streamer/types.h"
+#include "time_index.h"
+
+// Operations on the sample buffers of inlets. These are the core of all
+// consume, peek and clear calls. They are kept separate from LSL_streamer.cpp
+// so that they can be benchmarked in isolation.
+// !NB: appropriate locking of the buffer is responsibility of the caller!
+namespace BufferOps
+{
+    template <typename DataType>
+    std::tuple<typename std::vector<DataType>::iterator, typename std::vector<DataType>::iterator>
+    getIteratorsFromSampleAndSide(std::vector<DataType>& buf_, const size_t NSamp_, const Titta::BufferSide side_)
+    {
+        auto startIt    = std::begin(buf_);
+        auto   endIt    = std::end(buf_);
+        const auto nSamp= std::min(NSamp_, std::size(buf_));
+
+        switch (side_)
+        {
+        case Titta::BufferSide::Start:
+            endIt   = std::next(startIt, nSamp);
+            break;
+        case Titta::BufferSide::End:
+            startIt = std::prev(endIt  , nSamp);
+            break;
+        default:
+            DoExitWithMsg("LSL_streamer::::cpp::getIteratorsFromSampleAndSide: unknown Titta::BufferSide provided.");
+            break;
+        }
+        return { startIt, endIt };
+    }
+
+    // index of first sample with timestamp >= timeStart_ and one past the last
+    // sample with timestamp <= timeEnd_ (time_index.h), on the given clock. NB:
+    // end may be before start if no sample is in the range. runs_ is the time
+    // index of the buffer for the clock, empty if timestamps are sorted
+    template <typename DataType>
+    std::tuple<size_t, size_t>
+    getIndicesFromTimeRange(const std::vector<DataType>& buf_, const int64_t timeStart_, const int64_t timeEnd_, const LSLTypes::TimeClock clock_, std::span<const TimeIndex::Run> runs_ = {})
+    {
+        // !NB: appropriate locking is responsibility of caller!
+        const auto getTime = [&buf_, clock_](const size_t i_) { return LSLTypes::getTimeStamp(buf_[i_], clock_); };
+        const auto n = std::size(buf_);
+        return {
+            TimeIndex::firstAtOrAfter    (n, runs_, getTime, timeStart_),
+            TimeIndex::pastLastAtOrBefore(n, runs_, getTime, timeEnd_)
+        };
+    }
+
+    template <typename DataType>
+    std::tuple<typename std::vector<DataType>::iterator, typename std::vector<DataType>::iterator, bool>
+    getIteratorsFromTimeRange(std::vector<DataType>& buf_, const int64_t timeStart_, const int64_t timeEnd_, const LSLTypes::TimeClock clock_, std::span<const TimeIndex::Run> runs_ = {})
+    {
+        // !NB: appropriate locking is responsibility of caller!
+        // find elements within given range of time stamps, both sides inclusive.
+        // Since returns are iterators, what is returned is first matching element until one past last matching element
+        auto [start, end] = getIndicesFromTimeRange(buf_, timeStart_, timeEnd_, clock_, runs_);
+        end = std::max(start, end);
+        return {std::next(std::begin(buf_), start), std::next(std::begin(buf_), end), start == 0 && end == std::size(buf_)};
+    }
+
+    template <typename T>
+    std::vector<T> consumeFromVec(std::vector<T>& buf_, typename std::vector<T>::iterator startIt_, typename std::vector<T>::iterator endIt_)
+    {
+        if (std::empty(buf_))
+            return std::vector<T>{};
+
+        // move out the indicated elements
+        if (startIt_==std::begin(buf_) && endIt_==std::end(buf_))
+            // whole buffer
+            return std::vector<T>(std::move(buf_));
+        else
+        {
+            std::vector<T> out;
+            out.reserve(std::distance(startIt_, endIt_));
+            out.insert(std::end(out), std::make_move_iterator(startIt_), std::make_move_iterator(endIt_));
+            buf_.erase(startIt_, endIt_);
+            return out;
+        }
+    }
+
+    template <typename T>
+    std::vector<T> peekFromVec(const std::vector<T>& buf_, const typename std::vector<T>::const_iterator startIt_, const typename std::vector<T>::const_iterator endIt_)
+    {
+        if (std::empty(buf_))
+            return std::vector<T>{};
+
+        // copy the indicated elements
+        return std::vector<T>(startIt_, endIt_);
+    }
+
+    template <typename It>
+    std::span<const std::iter_value_t<It>> viewFromVec(const It startIt_, const It endIt_)
+    {
+        // reference the indicated elements, valid for as long as the buffer is not modified
+        return std::span<const std::iter_value_t<It>>(startIt_, endIt_);
+    }
+
+    // returns the range of indices [start, end) that was removed
+    template <typename DataType>
+    std::tuple<size_t, size_t> clearFromVec(std::vector<DataType>& buf_, const int64_t timeStart_, const int64_t timeEnd_, const LSLTypes::TimeClock clock_, std::span<const TimeIndex::Run> runs_ = {})
+    {
+        if (std::empty(buf_))
+            return {0, 0};
+
+        // find applicable range
+        auto [startIt, endIt, whole] = getIteratorsFromTimeRange(buf_, timeStart_, timeEnd_, clock_, runs_);
+        const size_t start = std::distance(std::begin(buf_), startIt);
+        const size_t end   = std::distance(std::begin(buf_), endIt);
+        // clear the flagged bit
+        if (whole)
+            buf_.clear();
+        else
+            buf_.erase(startIt, endIt);
+        return {start, end};
+    }
+}
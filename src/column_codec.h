@@ -0,0 +1,251 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <type_traits>
+#include <algorithm>
+
+// Lossless encodings for columns of samples (all values of one field for a run
+// of samples). Columns of slowly changing values compress well:
+// - integers (timestamps, counters) are stored as zigzagged delta-of-delta in
+//   LEB128 varints, so a regular clock costs one byte per sample
+// - floating point values are XORed with the previous value, so that the sign,
+//   exponent and leading mantissa bits that did not change become zero bits,
+//   and stored as in Gorilla (Pelkonen et al., 2015): one bit if unchanged,
+//   otherwise only the bits between the leading and trailing zeros of the XOR.
+//   Floats widened to double have 29 trailing zero mantissa bits, which this
+//   drops too
+// Decoders check they stay within the input and return false when they don't
+namespace ColumnCodec
+{
+    inline void putVarint(std::vector<uint8_t>& out_, uint64_t val_)
+    {
+        while (val_ >= 0x80)
+        {
+            out_.push_back(static_cast<uint8_t>(val_ | 0x80));
+            val_ >>= 7;
+        }
+        out_.push_back(static_cast<uint8_t>(val_));
+    }
+    inline bool getVarint(const uint8_t*& in_, const uint8_t* end_, uint64_t& val_)
+    {
+        val_ = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (in_ == end_)
+                return false;
+            const uint8_t b = *in_++;
+            val_ |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    inline uint64_t zigzag(const int64_t val_)   { return (static_cast<uint64_t>(val_) << 1) ^ static_cast<uint64_t>(val_ >> 63); }
+    inline int64_t  unzigzag(const uint64_t val_) { return static_cast<int64_t>(val_ >> 1) ^ -static_cast<int64_t>(val_ & 1); }
+
+    // integer columns: delta-of-delta
+    inline void encodeInts(std::span<const int64_t> values_, std::vector<uint8_t>& out_)
+    {
+        int64_t prev = 0, prevDelta = 0;
+        for (const auto v : values_)
+        {
+            // NB: wrap-around arithmetic, so that any input round-trips
+            const auto delta = static_cast<int64_t>(static_cast<uint64_t>(v) - static_cast<uint64_t>(prev));
+            putVarint(out_, zigzag(static_cast<int64_t>(static_cast<uint64_t>(delta) - static_cast<uint64_t>(prevDelta))));
+            prev      = v;
+            prevDelta = delta;
+        }
+    }
+    inline bool decodeInts(const uint8_t*& in_, const uint8_t* end_, std::span<int64_t> values_)
+    {
+        uint64_t prev = 0, prevDelta = 0;
+        for (auto& v : values_)
+        {
+            uint64_t enc;
+            if (!getVarint(in_, end_, enc))
+                return false;
+            prevDelta += static_cast<uint64_t>(unzigzag(enc));
+            prev      += prevDelta;
+            v          = static_cast<int64_t>(prev);
+        }
+        return true;
+    }
+
+    // bit stream, least significant bit first
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out_) : _out(out_) {}
+        ~BitWriter() { flush(); }
+
+        void put(uint64_t bits_, int count_)
+        {
+            // add at most 32 bits at a time, so that the accumulator does not overflow
+            while (count_ > 32)
+            {
+                put(bits_ & 0xFFFF'FFFF, 32);
+                bits_  >>= 32;
+                count_  -= 32;
+            }
+            _acc   |= (bits_ & ((uint64_t{1} << count_) - 1)) << _n;
+            _n     += count_;
+            while (_n >= 8)
+            {
+                _out.push_back(static_cast<uint8_t>(_acc));
+                _acc >>= 8;
+                _n    -= 8;
+            }
+        }
+        void flush()
+        {
+            if (_n)
+                _out.push_back(static_cast<uint8_t>(_acc));
+            _acc = 0;
+            _n   = 0;
+        }
+
+    private:
+        std::vector<uint8_t>&   _out;
+        uint64_t                _acc = 0;
+        int                     _n   = 0;
+    };
+    class BitReader
+    {
+    public:
+        BitReader(const uint8_t*& in_, const uint8_t* end_) : _in(in_), _end(end_) {}
+
+        bool get(uint64_t& bits_, int count_)
+        {
+            bits_ = 0;
+            for (int shift = 0; count_ > 0; shift += 32)
+            {
+                const int n = std::min(count_, 32);
+                while (_n < n)
+                {
+                    if (_in == _end)
+                        return false;
+                    _acc |= static_cast<uint64_t>(*_in++) << _n;
+                    _n   += 8;
+                }
+                bits_  |= (_acc & ((uint64_t{1} << n) - 1)) << shift;
+                _acc  >>= n;
+                _n     -= n;
+                count_ -= n;
+            }
+            return true;
+        }
+
+    private:
+        const uint8_t*& _in;    // NB: left at the first byte not (completely) consumed
+        const uint8_t*  _end;
+        uint64_t        _acc = 0;
+        int             _n   = 0;
+    };
+
+    // floating point columns: Gorilla XOR encoding
+    template <typename T>
+    using bits_t = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+    template <typename T>
+    constexpr int numBits_v = sizeof(T) * 8;
+    // bits needed to store a leading zero count, or a length of meaningful bits minus one
+    template <typename T>
+    constexpr int numCountBits_v = std::bit_width(static_cast<unsigned>(numBits_v<T> - 1));
+
+    template <typename T>
+    void encodeFloats(std::span<const T> values_, std::vector<uint8_t>& out_)
+    {
+        static_assert(std::is_floating_point_v<T>);
+        constexpr int W = numBits_v<T>;
+        constexpr int C = numCountBits_v<T>;
+        BitWriter bw(out_);
+        bits_t<T> prev = 0;
+        int prevLead = W, prevTrail = 0;    // window of meaningful bits of previous XOR (none yet)
+        for (const auto v : values_)
+        {
+            const auto bits = std::bit_cast<bits_t<T>>(v);
+            const auto x    = bits ^ prev;
+            prev = bits;
+            if (!x)
+            {
+                bw.put(0, 1);
+                continue;
+            }
+            const int lead  = std::countl_zero(x);
+            const int trail = std::countr_zero(x);
+            if (prevLead < W && lead >= prevLead && trail >= prevTrail)
+            {
+                // fits in previous window
+                bw.put(0b01, 2);
+                bw.put(x >> prevTrail, W - prevLead - prevTrail);
+            }
+            else
+            {
+                const int len = W - lead - trail;
+                bw.put(0b11, 2);
+                bw.put(static_cast<uint64_t>(lead), C);
+                bw.put(static_cast<uint64_t>(len - 1), C);
+                bw.put(x >> trail, len);
+                prevLead  = lead;
+                prevTrail = trail;
+            }
+        }
+    }
+    template <typename T>
+    bool decodeFloats(const uint8_t*& in_, const uint8_t* end_, std::span<T> values_)
+    {
+        static_assert(std::is_floating_point_v<T>);
+        constexpr int W = numBits_v<T>;
+        constexpr int C = numCountBits_v<T>;
+        BitReader br(in_, end_);
+        bits_t<T> prev = 0;
+        int prevLead = W, prevTrail = 0;
+        for (auto& v : values_)
+        {
+            uint64_t ctrl, x;
+            if (!br.get(ctrl, 1))
+                return false;
+            if (ctrl)
+            {
+                if (!br.get(ctrl, 1))
+                    return false;
+                if (ctrl)
+                {
+                    uint64_t lead, len;
+                    if (!br.get(lead, C) || !br.get(len, C) || static_cast<int>(lead + len + 1) > W)
+                        return false;
+                    prevLead  = static_cast<int>(lead);
+                    prevTrail = W - prevLead - static_cast<int>(len + 1);
+                }
+                else if (prevLead == W)
+                    return false;   // no previous window
+                if (!br.get(x, W - prevLead - prevTrail))
+                    return false;
+                prev ^= static_cast<bits_t<T>>(x << prevTrail);
+            }
+            v = std::bit_cast<T>(prev);
+        }
+        return true;
+    }
+
+    // dispatch on value type
+    template <typename T>
+    void encode(std::span<const T> values_, std::vector<uint8_t>& out_)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+            encodeFloats(values_, out_);
+        else
+            encodeInts(values_, out_);
+    }
+    template <typename T>
+    bool decode(const uint8_t*& in_, const uint8_t* end_, std::span<T> values_)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+            return decodeFloats(in_, end_, values_);
+        else
+            return decodeInts(in_, end_, values_);
+    }
+}
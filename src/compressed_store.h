@@ -0,0 +1,183 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <format>
+#include <memory>
+
+#include "Titta/utils.h"
+#include "sample_tier.h"
+#include "sample_columns.h"
+#include "time_index.h"
+
+// Compressed in-memory tier of an inlet's buffer. Older samples are frozen
+// into blocks in which each field is a separately compressed column
+// (sample_columns.h): timestamps as delta-of-delta, floating point values with
+// Gorilla XOR encoding. Gaze data typically takes 5-10x less memory this way.
+// A per-block index of the range of timestamps allows finding the blocks that
+// hold a time range, within a block only the timestamp column is decoded to
+// locate a sample. Blocks are decoded when samples are read from them.
+template <typename DataType>
+class CompressedStore : public SampleTier<DataType>
+{
+    static_assert(hasOlderTier_v<DataType>, "CompressedStore: only trivially copyable samples can be compressed");
+
+    struct Block
+    {
+        std::vector<uint8_t>    data;
+        size_t                  first;      // index of first sample in the whole store
+        size_t                  count;
+        TimeIndex::Extent       extent;
+        TimeIndex::Bounds       bounds;
+        TimeIndex::runs_t       runs;
+    };
+
+public:
+    explicit CompressedStore(const size_t blockSize_ = 1024) :
+        _blockSize(std::max<size_t>(blockSize_, 1))
+    {}
+
+    size_t size()  const override { return _blocks.empty() ? 0 : _blocks.back().first + _blocks.back().count; }
+    size_t bytes() const override { return _bytes; }
+    bool   isInMemory() const override { return true; }
+
+    bool append(std::span<const DataType> samples_) override
+    {
+        while (!samples_.empty())
+        {
+            const auto n = std::min(samples_.size(), _blockSize);
+            addBlock(samples_.first(n), size());
+            samples_ = samples_.subspan(n);
+        }
+        return true;
+    }
+
+    size_t firstAtOrAfter(const int64_t time_, const LSLTypes::TimeClock clock_) const override
+    {
+        return TimeIndex::firstAtOrAfter(_blocks, &getTimeStamps, time_, clock_);
+    }
+    size_t pastLastAtOrBefore(const int64_t time_, const LSLTypes::TimeClock clock_) const override
+    {
+        return TimeIndex::pastLastAtOrBefore(_blocks, &getTimeStamps, time_, clock_);
+    }
+
+    int64_t minTimeStamp(const LSLTypes::TimeClock clock_) const override { return _blocks.front().bounds.minFrom[clock_]; }
+    int64_t maxTimeStamp(const LSLTypes::TimeClock clock_) const override { return _blocks.back().bounds.maxUpTo[clock_]; }
+
+    std::vector<DataType> read(const size_t start_, size_t end_) const override
+    {
+        end_ = std::min(end_, size());
+        std::vector<DataType> out;
+        if (start_ >= end_)
+            return out;
+        out.reserve(end_ - start_);
+        for (const auto& block : _blocks)
+        {
+            const auto s = std::max(start_, block.first);
+            const auto e = std::min(end_, block.first + block.count);
+            if (s >= e)
+                continue;
+            if (s == block.first && e == block.first + block.count)
+                decode(block, out);
+            else
+            {
+                const auto samples = decode(block);
+                out.insert(out.end(), samples.begin() + (s - block.first), samples.begin() + (e - block.first));
+            }
+        }
+        return out;
+    }
+
+    // blocks that are partially removed are re-encoded
+    void erase(const size_t start_, size_t end_) override
+    {
+        end_ = std::min(end_, size());
+        if (start_ >= end_)
+            return;
+        std::vector<Block> kept;
+        kept.reserve(_blocks.size());
+        for (auto& block : _blocks)
+        {
+            const auto s = std::max(start_, block.first);
+            const auto e = std::min(end_, block.first + block.count);
+            if (s >= e)
+            {
+                // untouched
+                kept.push_back(std::move(block));
+                continue;
+            }
+
+            _bytes -= block.data.size();
+            if (s == block.first && e == block.first + block.count)
+                continue;
+            auto samples = decode(block);
+            samples.erase(samples.begin() + (s - block.first), samples.begin() + (e - block.first));
+            kept.push_back(makeBlock(samples, 0));
+        }
+        _blocks = std::move(kept);
+        renumber();
+        TimeIndex::updateBounds(_blocks);
+    }
+
+    void clear() override
+    {
+        _blocks.clear();
+        _bytes = 0;
+    }
+
+private:
+    Block makeBlock(std::span<const DataType> samples_, const size_t first_)
+    {
+        Block block{{}, first_, samples_.size(), TimeIndex::getExtent(samples_), {}, TimeIndex::makeIndex(samples_)};
+        SampleColumns::encodeBlock(samples_, block.data);
+        block.data.shrink_to_fit();
+        _bytes += block.data.size();
+        return block;
+    }
+    void addBlock(std::span<const DataType> samples_, const size_t first_)
+    {
+        _blocks.push_back(makeBlock(samples_, first_));
+        TimeIndex::boundsAppended(_blocks);
+    }
+    void renumber()
+    {
+        size_t first = 0;
+        for (auto& block : _blocks)
+        {
+            block.first = first;
+            first += block.count;
+        }
+    }
+    static void decode(const Block& block_, std::vector<DataType>& out_)
+    {
+        if (!SampleColumns::decodeBlock<DataType>(block_.data, block_.count, out_))
+            DoExitWithMsg("CompressedStore: corrupt block");
+    }
+    static std::vector<DataType> decode(const Block& block_)
+    {
+        std::vector<DataType> out;
+        decode(block_, out);
+        return out;
+    }
+    // access to the timestamps of a block's samples. Remote and local
+    // timestamps have their own column, for the device clock the whole block
+    // is decoded
+    static auto getTimeStamps(const Block& block_, const LSLTypes::TimeClock clock_)
+    {
+        auto ts = std::make_shared<std::vector<int64_t>>();
+        if (clock_ == LSLTypes::TimeClock::Device)
+        {
+            const auto samples = decode(block_);
+            ts->resize(samples.size());
+            std::ranges::transform(samples, ts->begin(), [](const DataType& s_) { return LSLTypes::getTimeStamp(s_, LSLTypes::TimeClock::Device); });
+        }
+        else if (!SampleColumns::decodeTimeStamps<DataType>(block_.data, block_.count, clock_ == LSLTypes::TimeClock::Local, *ts))
+            DoExitWithMsg("CompressedStore: corrupt block");
+        return [ts](const size_t i_) { return (*ts)[i_]; };
+    }
+
+private:
+    size_t                  _blockSize;
+    std::vector<Block>      _blocks;
+    size_t                  _bytes = 0;
+};
@@ -0,0 +1,109 @@
+#include "mapped_file.h"
+#include <fstream>
+#include <format>
+#include <memory>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+#include "Titta/utils.h"
+
+#ifdef _WIN32
+namespace
+{
+    // closes a handle when going out of scope, unless released
+    struct HandleCloser
+    {
+        void operator()(void* handle_) const
+        {
+            if (handle_ && handle_ != INVALID_HANDLE_VALUE)
+                CloseHandle(handle_);
+        }
+    };
+    using HandleGuard = std::unique_ptr<void, HandleCloser>;
+}
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path_)
+{
+#ifdef _WIN32
+    // NB: handles are guarded until construction succeeded, the destructor does not run if it throws
+    HandleGuard file(CreateFileW(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    if (file.get() == INVALID_HANDLE_VALUE)
+        DoExitWithMsg(std::format("MappedFile: cannot open {} (error {})", path_.string(), GetLastError()));
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file.get(), &size))
+        DoExitWithMsg(std::format("MappedFile: cannot get size of {} (error {})", path_.string(), GetLastError()));
+    const auto fileSize = static_cast<size_t>(size.QuadPart);
+    if (!fileSize)
+    {
+        _file = file.release();
+        return;
+    }
+    HandleGuard mapping(CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    if (!mapping)
+        DoExitWithMsg(std::format("MappedFile: cannot map {} (error {})", path_.string(), GetLastError()));
+    _data = static_cast<const std::byte*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0));
+    if (!_data)
+        DoExitWithMsg(std::format("MappedFile: cannot map {} (error {})", path_.string(), GetLastError()));
+    _size    = fileSize;
+    _file    = file.release();
+    _mapping = mapping.release();
+#else
+    const int fd = open(path_.c_str(), O_RDONLY);
+    if (fd == -1)
+        DoExitWithMsg(std::format("MappedFile: cannot open {} (errno {})", path_.string(), errno));
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+    {
+        close(fd);
+        DoExitWithMsg(std::format("MappedFile: cannot get size of {} (errno {})", path_.string(), errno));
+    }
+    _size = static_cast<size_t>(st.st_size);
+    if (_size)
+    {
+        void* ptr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            close(fd);
+            DoExitWithMsg(std::format("MappedFile: cannot map {} (errno {})", path_.string(), errno));
+        }
+        _data = static_cast<const std::byte*>(ptr);
+    }
+    // mapping stays valid after the descriptor is closed
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(_mapping);
+    if (_file && _file != INVALID_HANDLE_VALUE)
+        CloseHandle(_file);
+#else
+    if (_data)
+        munmap(const_cast<std::byte*>(_data), _size);
+#endif
+}
+
+bool MappedFile::write(const std::filesystem::path& path_, const void* data_, const size_t size_)
+{
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file.write(static_cast<const char*>(data_), static_cast<std::streamsize>(size_));
+    file.close();
+    return !file.fail();
+}
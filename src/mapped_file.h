@@ -0,0 +1,28 @@
+#pragma once
+#include <filesystem>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file, used for the on-disk tier of inlet
+// buffers (spill_store.h). The mapping is released when the object is destroyed.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path_);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::byte*    data() const { return _data; }
+    size_t              size() const { return _size; }
+
+    // write bytes to a new file (replacing any existing file). Returns false on failure
+    static bool write(const std::filesystem::path& path_, const void* data_, size_t size_);
+
+private:
+    const std::byte*    _data   = nullptr;
+    size_t              _size   = 0;
+#ifdef _WIN32
+    void*               _file   = nullptr;
+    void*               _mapping= nullptr;
+#endif
+};
@@ -0,0 +1,92 @@
+#include "LSL_streamer/pusher_pool.h"
+#include "LSL_streamer/LSL_streamer.h"
+
+#include <algorithm>
+
+
+PusherPool::PusherPool(size_t numThreads_)
+{
+    if (!numThreads_)
+        numThreads_ = std::max(1u, std::thread::hardware_concurrency() / 4);
+
+    for (size_t i = 0; i < numThreads_; i++)
+    {
+        auto& lane = _lanes.emplace_back(std::make_unique<Lane>());
+        lane->thread = std::thread(&PusherPool::workerThreadFunc, this, std::ref(*lane));
+    }
+}
+PusherPool::~PusherPool()
+{
+    // signal all threads first, then wait for them, so shutdown happens in parallel
+    for (const auto& lane : _lanes)
+    {
+        std::lock_guard l(lane->mutex);
+        lane->shouldStop = true;
+        lane->cv.notify_one();
+    }
+    for (const auto& lane : _lanes)
+        if (lane->thread.joinable())
+            lane->thread.join();
+}
+
+size_t PusherPool::getLane()
+{
+    return _nextLane++ % _lanes.size();
+}
+size_t PusherPool::getQueueSize(const size_t lane_) const
+{
+    const auto& lane = *_lanes.at(lane_);
+    std::lock_guard l(lane.mutex);
+    return lane.queue.size();
+}
+
+void PusherPool::post(const size_t lane_, LSL_streamer* streamer_, sample_type&& sample_)
+{
+    auto& lane = *_lanes[lane_];
+    {
+        std::lock_guard l(lane.mutex);
+        lane.queue.push_back({streamer_, std::move(sample_)});
+    }
+    lane.cv.notify_one();
+}
+
+void PusherPool::flush(const size_t lane_)
+{
+    auto& lane = *_lanes.at(lane_);
+    std::future<void> done;
+    {
+        // NB: always enqueue the marker, even if the queue is empty: the worker may have
+        // taken the last item off the queue and still be pushing it. Items are handled in
+        // order, so the marker completes only once that push is done
+        std::lock_guard l(lane.mutex);
+        std::promise<void> marker;
+        done = marker.get_future();
+        lane.queue.push_back({nullptr, std::move(marker)});
+    }
+    lane.cv.notify_one();
+    done.wait();
+}
+
+void PusherPool::workerThreadFunc(Lane& lane_)
+{
+    std::unique_lock l(lane_.mutex);
+    while (true)
+    {
+        lane_.cv.wait(l, [&lane_] { return lane_.shouldStop || !lane_.queue.empty(); });
+        if (lane_.queue.empty())
+            // should stop and nothing left to do
+            return;
+
+        // take item, push it without holding the lock
+        auto item = std::move(lane_.queue.front());
+        lane_.queue.pop_front();
+        l.unlock();
+
+        if (auto* marker = std::get_if<std::promise<void>>(&item.payload))
+            marker->set_value();
+        else
+            std::visit([&item](auto& sample_) { item.streamer->pushSample(std::move(sample_)); }, std::get<sample_type>(item.payload));
+
+        l.lock();
+    }
+}
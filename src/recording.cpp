@@ -0,0 +1,311 @@
+#include "LSL_streamer/recording.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <limits>
+
+#include "Titta/Titta.h"
+#include "Titta/utils.h"
+#include "mapped_file.h"
+#include "sample_columns.h"
+
+namespace
+{
+    namespace defaults
+    {
+        constexpr size_t                blockSize               = 4096;
+        constexpr int64_t               readTimeRangeStart      = 0;
+        constexpr int64_t               readTimeRangeEnd        = std::numeric_limits<int64_t>::max();
+        constexpr bool                  timeIsLocalTime         = true;
+    }
+
+    // file layout: FileHeader, blocks (see sample_columns.h), padding to 8 bytes, IndexEntry per block, Footer
+    constexpr char      fileMagic[8]    = {'L','S','L','S','R','E','C','\0'};
+    constexpr char      footerMagic[8]  = {'L','S','L','S','I','D','X','\0'};
+    constexpr uint32_t  formatVersion   = 2;      // 2: gaze device timestamps stored as integers
+
+    struct FileHeader
+    {
+        char        magic[8];
+        uint32_t    version;
+        uint32_t    stream;         // Titta::Stream of the samples in the file
+        uint32_t    numColumns;
+        uint32_t    blockSize;
+    };
+    struct IndexEntry
+    {
+        uint64_t    offset;
+        uint32_t    size;
+        uint32_t    numSamples;
+        // per clock (remote, local): maximum timestamp in this and all earlier
+        // blocks, and minimum timestamp in this and all later blocks. These
+        // are monotonic even if the timestamps are not (local timestamps
+        // depend on the time correction at reception), so they can be binary
+        // searched to find the blocks that may hold samples in a time range
+        int64_t     maxUpTo[2];
+        int64_t     minFrom[2];
+    };
+    struct Footer
+    {
+        uint64_t    indexOffset;
+        uint64_t    numBlocks;
+        uint64_t    numSamples;
+        char        magic[8];
+    };
+
+    template <typename DataType>
+    constexpr Titta::Stream streamOf()
+    {
+        if      constexpr (std::is_same_v<DataType, LSLTypes::gaze>)
+            return Titta::Stream::Gaze;
+        else if constexpr (std::is_same_v<DataType, LSLTypes::eyeImage>)
+            return Titta::Stream::EyeImage;
+        else if constexpr (std::is_same_v<DataType, LSLTypes::extSignal>)
+            return Titta::Stream::ExtSignal;
+        else if constexpr (std::is_same_v<DataType, LSLTypes::timeSync>)
+            return Titta::Stream::TimeSync;
+        else if constexpr (std::is_same_v<DataType, LSLTypes::positioning>)
+            return Titta::Stream::Positioning;
+    }
+
+    template <typename DataType>
+    int64_t getTimeStamp(const DataType& sample_, const bool timeIsLocalTime_)
+    {
+        return timeIsLocalTime_ ? sample_.local_system_time_stamp : sample_.remote_system_time_stamp;
+    }
+}
+
+
+namespace Recording
+{
+template <typename DataType>
+Writer<DataType>::Writer(const std::filesystem::path& file_, std::optional<size_t> blockSize_) :
+    _blockSize(std::max<size_t>(blockSize_.value_or(defaults::blockSize), 1))
+{
+    _file.open(file_, std::ios::binary | std::ios::trunc);
+    if (!_file)
+        DoExitWithMsg(std::format("Recording::Writer: cannot open {} for writing", file_.string()));
+
+    FileHeader header{};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version    = formatVersion;
+    header.stream     = static_cast<uint32_t>(streamOf<DataType>());
+    header.numColumns = static_cast<uint32_t>(SampleColumns::numColumns_v<DataType>);
+    header.blockSize  = static_cast<uint32_t>(_blockSize);
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _offset = sizeof(header);
+    _isOpen = true;
+    _pending.reserve(_blockSize);
+}
+template <typename DataType>
+Writer<DataType>::~Writer()
+{
+    // NB: a destructor must not throw. Call close() to find out whether writing succeeded
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+template <typename DataType>
+void Writer<DataType>::append(std::span<const DataType> samples_)
+{
+    if (!_isOpen)
+        DoExitWithMsg("Recording::Writer::append: recording is closed");
+
+    while (!samples_.empty())
+    {
+        const auto n = std::min(samples_.size(), _blockSize - _pending.size());
+        _pending.insert(_pending.end(), samples_.begin(), samples_.begin() + n);
+        samples_ = samples_.subspan(n);
+        if (_pending.size() == _blockSize)
+            writeBlock();
+    }
+}
+
+template <typename DataType>
+void Writer<DataType>::writeBlock()
+{
+    if (_pending.empty())
+        return;
+
+    std::vector<uint8_t> block;
+    SampleColumns::encodeBlock<DataType>(_pending, block);
+    _file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+    const auto blockSize = block.size();
+
+    BlockInfo info{_offset, static_cast<uint32_t>(blockSize), static_cast<uint32_t>(_pending.size()),
+        std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+        std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    for (const auto& s : _pending)
+    {
+        info.remoteMin = std::min(info.remoteMin, s.remote_system_time_stamp);
+        info.remoteMax = std::max(info.remoteMax, s.remote_system_time_stamp);
+        info.localMin  = std::min(info.localMin,  s.local_system_time_stamp);
+        info.localMax  = std::max(info.localMax,  s.local_system_time_stamp);
+    }
+    _blocks.push_back(info);
+    _offset     += blockSize;
+    _numSamples += _pending.size();
+    _pending.clear();
+}
+
+template <typename DataType>
+void Writer<DataType>::close()
+{
+    if (!_isOpen)
+        return;
+    _isOpen = false;
+    writeBlock();
+
+    // align index, so that it can be used in place from the memory mapping
+    constexpr char padding[8] = {};
+    const auto pad = (8 - _offset % 8) % 8;
+    _file.write(padding, static_cast<std::streamsize>(pad));
+    _offset += pad;
+
+    std::vector<IndexEntry> index(_blocks.size());
+    int64_t maxUpTo[2] = { std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min() };
+    for (size_t b = 0; b < _blocks.size(); b++)
+    {
+        maxUpTo[0] = std::max(maxUpTo[0], _blocks[b].remoteMax);
+        maxUpTo[1] = std::max(maxUpTo[1], _blocks[b].localMax);
+        index[b] = {_blocks[b].offset, _blocks[b].size, _blocks[b].numSamples, {maxUpTo[0], maxUpTo[1]}, {}};
+    }
+    int64_t minFrom[2] = { std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max() };
+    for (size_t b = _blocks.size(); b-- > 0; )
+    {
+        minFrom[0] = std::min(minFrom[0], _blocks[b].remoteMin);
+        minFrom[1] = std::min(minFrom[1], _blocks[b].localMin);
+        index[b].minFrom[0] = minFrom[0];
+        index[b].minFrom[1] = minFrom[1];
+    }
+    _file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(IndexEntry)));
+
+    Footer footer{_offset, index.size(), _numSamples, {}};
+    std::memcpy(footer.magic, footerMagic, sizeof(footerMagic));
+    _file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    _file.close();
+    if (_file.fail())
+        DoExitWithMsg("Recording::Writer::close: error writing recording");
+}
+
+
+template <typename DataType>
+Reader<DataType>::Reader(const std::filesystem::path& file_) :
+    _file(std::make_unique<MappedFile>(file_))
+{
+    const auto* data = _file->data();
+    const auto  size = _file->size();
+    FileHeader header;
+    Footer     footer;
+    if (size < sizeof(header) + sizeof(footer))
+        DoExitWithMsg(std::format("Recording::Reader: {} is not a recording, or is incomplete", file_.string()));
+    std::memcpy(&header, data, sizeof(header));
+    std::memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) || std::memcmp(footer.magic, footerMagic, sizeof(footerMagic)))
+        DoExitWithMsg(std::format("Recording::Reader: {} is not a recording, or is incomplete", file_.string()));
+    if (header.version != formatVersion)
+        DoExitWithMsg(std::format("Recording::Reader: {} has format version {}, only version {} is supported", file_.string(), header.version, formatVersion));
+    if (header.stream != static_cast<uint32_t>(streamOf<DataType>()) || header.numColumns != SampleColumns::numColumns_v<DataType>)
+        DoExitWithMsg(std::format("Recording::Reader: {} does not contain {} samples", file_.string(), Titta::streamToString(streamOf<DataType>())));
+    if (footer.indexOffset % 8 || footer.indexOffset > size - sizeof(footer) || footer.numBlocks > (size - sizeof(footer) - footer.indexOffset) / sizeof(IndexEntry))
+        DoExitWithMsg(std::format("Recording::Reader: {} has a corrupt index", file_.string()));
+
+    _index      = data + footer.indexOffset;
+    _numBlocks  = static_cast<size_t>(footer.numBlocks);
+    _numSamples = static_cast<size_t>(footer.numSamples);
+}
+template <typename DataType>
+Reader<DataType>::~Reader() = default;
+
+template <typename DataType>
+size_t Reader<DataType>::size() const
+{
+    return _numSamples;
+}
+template <typename DataType>
+size_t Reader<DataType>::getNumBlocks() const
+{
+    return _numBlocks;
+}
+
+template <typename DataType>
+std::vector<DataType> Reader<DataType>::readBlock(const size_t block_) const
+{
+    if (block_ >= _numBlocks)
+        DoExitWithMsg(std::format("Recording::Reader::readBlock: block {} requested, but recording only has {} blocks", block_, _numBlocks));
+
+    const auto& entry = static_cast<const IndexEntry*>(_index)[block_];
+    const auto* base  = _file->data();
+    // NB: not as offset + size, which may wrap around for a corrupt entry
+    const auto indexOffset = static_cast<uint64_t>(static_cast<const std::byte*>(_index) - base);
+    if (entry.offset > indexOffset || entry.size > indexOffset - entry.offset)
+        DoExitWithMsg(std::format("Recording::Reader::readBlock: block {} is corrupt", block_));
+
+    std::vector<DataType> out;
+    if (!SampleColumns::decodeBlock<DataType>({reinterpret_cast<const uint8_t*>(base + entry.offset), entry.size}, entry.numSamples, out))
+        DoExitWithMsg(std::format("Recording::Reader::readBlock: block {} is corrupt", block_));
+    return out;
+}
+
+template <typename DataType>
+std::vector<DataType> Reader<DataType>::readTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_) const
+{
+    // deal with default arguments
+    const auto timeStart        = timeStart_      .value_or(defaults::readTimeRangeStart);
+    const auto timeEnd          = timeEnd_        .value_or(defaults::readTimeRangeEnd);
+    const auto timeIsLocalTime  = timeIsLocalTime_.value_or(defaults::timeIsLocalTime);
+    const auto clock            = timeIsLocalTime ? 1 : 0;
+
+    // blocks before first have all timestamps < timeStart, blocks from last on have all timestamps > timeEnd
+    const std::span index(static_cast<const IndexEntry*>(_index), _numBlocks);
+    const auto first = std::ranges::partition_point(index, [&](const IndexEntry& e_) { return e_.maxUpTo[clock] < timeStart; });
+    const auto last  = std::ranges::partition_point(first, index.end(), [&](const IndexEntry& e_) { return e_.minFrom[clock] <= timeEnd; });
+
+    std::vector<DataType> out;
+    for (auto it = first; it != last; ++it)
+    {
+        auto block = readBlock(static_cast<size_t>(it - index.begin()));
+        for (auto& s : block)
+        {
+            const auto t = getTimeStamp(s, timeIsLocalTime);
+            if (t >= timeStart && t <= timeEnd)
+                out.push_back(std::move(s));
+        }
+    }
+    return out;
+}
+
+template <typename DataType>
+std::vector<DataType> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_)
+{
+    return Reader<DataType>(file_).readTimeRange(timeStart_, timeEnd_, timeIsLocalTime_);
+}
+
+
+// explicit instantiations
+template class Writer<LSLTypes::gaze>;
+template class Reader<LSLTypes::gaze>;
+template std::vector<LSLTypes::gaze> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+
+template class Writer<LSLTypes::eyeImage>;
+template class Reader<LSLTypes::eyeImage>;
+template std::vector<LSLTypes::eyeImage> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+
+template class Writer<LSLTypes::extSignal>;
+template class Reader<LSLTypes::extSignal>;
+template std::vector<LSLTypes::extSignal> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+
+template class Writer<LSLTypes::timeSync>;
+template class Reader<LSLTypes::timeSync>;
+template std::vector<LSLTypes::timeSync> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+
+template class Writer<LSLTypes::positioning>;
+template class Reader<LSLTypes::positioning>;
+template std::vector<LSLTypes::positioning> readTimeRange(const std::filesystem::path& file_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<bool> timeIsLocalTime_);
+}
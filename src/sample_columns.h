@@ -0,0 +1,304 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <span>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include "Titta/types.h"
+#include "Titta/Titta.h"
+#include "LSL_streamer/types.h"
+#include "column_codec.h"
+#include "sample_conversion.h"
+
+// Columnar layout of blocks of LSL_streamer samples, used by the recording
+// format and the compressed in-memory tier of inlets. A block starts with the
+// encoded size of each column (uint32_t), followed by the columns, each
+// compressed separately (column_codec.h)
+namespace SampleColumns
+{
+    using columns_t = std::array<std::vector<uint8_t>, 64>;
+
+    // encode the timestamps shared by all types into the first two columns
+    template <typename DataType>
+    void encodeTimeStamps(std::span<const DataType> samples_, columns_t& columns_)
+    {
+        std::vector<int64_t> ts(samples_.size());
+        std::ranges::transform(samples_, ts.begin(), &DataType::remote_system_time_stamp);
+        ColumnCodec::encodeInts(ts, columns_[0]);
+        std::ranges::transform(samples_, ts.begin(), &DataType::local_system_time_stamp);
+        ColumnCodec::encodeInts(ts, columns_[1]);
+    }
+
+    // Columns per type: remote and local timestamp, then the channels of the
+    // stream (as sent by LSL_streamer outlets). Packed gaze samples are stored
+    // as gaze. The device timestamp channel of gaze (in seconds) is stored as
+    // the integer timestamp, so that it gets the codec of the other timestamps.
+    // Eye images have their own layout
+    template <typename DataType>
+    struct Schema
+    {
+        static auto toChannels(const DataType& sample_)
+        {
+            if      constexpr (std::is_same_v<DataType, LSLTypes::gaze>)
+                return SampleConversion::toLSL(sample_.gazeData);
+            else if constexpr (std::is_same_v<DataType, LSLTypes::packedGaze>)
+                return SampleConversion::toLSL(LSLTypes::storage<LSLTypes::gaze>::unpack(sample_).gazeData);
+            else if constexpr (std::is_same_v<DataType, LSLTypes::extSignal>)
+                return SampleConversion::toLSL(sample_.extSignalData);
+            else if constexpr (std::is_same_v<DataType, LSLTypes::timeSync>)
+                return SampleConversion::toLSL(sample_.timeSyncData);
+            else if constexpr (std::is_same_v<DataType, LSLTypes::positioning>)
+                return SampleConversion::toLSL(sample_.positioningData);
+        }
+        using channels_t = decltype(toChannels(std::declval<const DataType&>()));
+        using value_t    = typename channels_t::value_type;
+        static constexpr size_t numChannels = std::tuple_size_v<channels_t>;
+        static constexpr size_t numColumns  = 2 + numChannels;
+        static constexpr bool   hasDeviceTimeChannel = std::is_same_v<DataType, LSLTypes::gaze> || std::is_same_v<DataType, LSLTypes::packedGaze>;
+        static constexpr size_t deviceTimeChannel    = numChannels - 1;
+
+        static DataType fromChannels(const channels_t& channels_, const int64_t remote_, const int64_t local_)
+        {
+            if constexpr (std::is_same_v<DataType, LSLTypes::gaze>)
+                // system timestamp is transmitted as remote time
+                return { SampleConversion::fromLSL(channels_, remote_), remote_, local_ };
+            else if constexpr (std::is_same_v<DataType, LSLTypes::packedGaze>)
+                return LSLTypes::storage<LSLTypes::gaze>::pack({ SampleConversion::fromLSL(channels_, remote_), remote_, local_ });
+            else
+                return { SampleConversion::fromLSL(channels_), remote_, local_ };
+        }
+
+        static void encode(std::span<const DataType> samples_, columns_t& columns_)
+        {
+            encodeTimeStamps(samples_, columns_);
+            std::vector<channels_t> channels(samples_.size());
+            std::ranges::transform(samples_, channels.begin(), &toChannels);
+            std::vector<value_t> column(samples_.size());
+            for (size_t c = 0; c < numChannels; c++)
+            {
+                if (hasDeviceTimeChannel && c == deviceTimeChannel)
+                {
+                    std::vector<int64_t> ts(samples_.size());
+                    std::ranges::transform(samples_, ts.begin(), [](const DataType& s_) { return LSLTypes::getTimeStamp(s_, LSLTypes::TimeClock::Device); });
+                    ColumnCodec::encodeInts(ts, columns_[2 + c]);
+                    continue;
+                }
+                std::ranges::transform(channels, column.begin(), [c](const channels_t& s_) { return s_[c]; });
+                ColumnCodec::encode<value_t>(column, columns_[2 + c]);
+            }
+        }
+        static bool decode(const std::span<const uint8_t>* columns_, const size_t numSamples_, std::vector<DataType>& out_)
+        {
+            std::vector<int64_t> remote(numSamples_), local(numSamples_), device;
+            std::vector<channels_t> channels(numSamples_);
+            std::vector<value_t> column(numSamples_);
+            auto decodeColumn = [&]<typename T>(const size_t c_, std::span<T> dst_)
+            {
+                const auto* in = columns_[c_].data();
+                return ColumnCodec::decode(in, in + columns_[c_].size(), dst_);
+            };
+            if (!decodeColumn(0, std::span(remote)) || !decodeColumn(1, std::span(local)))
+                return false;
+            for (size_t c = 0; c < numChannels; c++)
+            {
+                if (hasDeviceTimeChannel && c == deviceTimeChannel)
+                {
+                    device.resize(numSamples_);
+                    if (!decodeColumn(2 + c, std::span(device)))
+                        return false;
+                    continue;
+                }
+                if (!decodeColumn(2 + c, std::span(column)))
+                    return false;
+                for (size_t i = 0; i < numSamples_; i++)
+                    channels[i][c] = column[i];
+            }
+            out_.reserve(out_.size() + numSamples_);
+            for (size_t i = 0; i < numSamples_; i++)
+            {
+                auto& sample = out_.emplace_back(fromChannels(channels[i], remote[i], local[i]));
+                if constexpr (std::is_same_v<DataType, LSLTypes::gaze>)
+                    sample.gazeData.device_time_stamp = device[i];
+                else if constexpr (std::is_same_v<DataType, LSLTypes::packedGaze>)
+                    sample.device_time_stamp = device[i];
+            }
+            return true;
+        }
+    };
+
+    template <>
+    struct Schema<LSLTypes::eyeImage>
+    {
+        using DataType = LSLTypes::eyeImage;
+        // integer fields, followed by a column holding the image data of all samples back to back
+        static constexpr int64_t Titta::eyeImage::* int64Fields[] = { &Titta::eyeImage::device_time_stamp, &Titta::eyeImage::system_time_stamp };
+        static constexpr int Titta::eyeImage::* intFields[] = {
+            &Titta::eyeImage::bits_per_pixel, &Titta::eyeImage::padding_per_pixel, &Titta::eyeImage::width, &Titta::eyeImage::height,
+            &Titta::eyeImage::region_id, &Titta::eyeImage::region_top, &Titta::eyeImage::region_left, &Titta::eyeImage::camera_id
+        };
+        // + is_gif, type and data_size
+        static constexpr size_t numIntColumns = std::size(int64Fields) + std::size(intFields) + 3;
+        static constexpr size_t numColumns    = 2 + numIntColumns + 1;
+
+        static void encode(std::span<const DataType> samples_, columns_t& columns_)
+        {
+            encodeTimeStamps(samples_, columns_);
+            std::vector<int64_t> column(samples_.size());
+            size_t c = 2;
+            auto encodeColumn = [&](auto getter_)
+            {
+                std::ranges::transform(samples_, column.begin(), [&](const DataType& s_) { return static_cast<int64_t>(getter_(s_.eyeImageData)); });
+                ColumnCodec::encodeInts(column, columns_[c++]);
+            };
+            for (const auto field : int64Fields)
+                encodeColumn([field](const Titta::eyeImage& e_) { return e_.*field; });
+            for (const auto field : intFields)
+                encodeColumn([field](const Titta::eyeImage& e_) { return e_.*field; });
+            encodeColumn([](const Titta::eyeImage& e_) { return e_.is_gif; });
+            encodeColumn([](const Titta::eyeImage& e_) { return e_.type; });
+            encodeColumn([](const Titta::eyeImage& e_) { return e_.data_size; });
+
+            auto& blob = columns_[c];
+            for (const auto& s : samples_)
+            {
+                const auto* data = static_cast<const uint8_t*>(s.eyeImageData.data());
+                if (data)
+                    blob.insert(blob.end(), data, data + s.eyeImageData.data_size);
+            }
+        }
+        static bool decode(const std::span<const uint8_t>* columns_, const size_t numSamples_, std::vector<DataType>& out_)
+        {
+            std::array<std::vector<int64_t>, 2 + numIntColumns> ints;
+            for (size_t c = 0; c < ints.size(); c++)
+            {
+                ints[c].resize(numSamples_);
+                const auto* in = columns_[c].data();
+                if (!ColumnCodec::decodeInts(in, in + columns_[c].size(), std::span(ints[c])))
+                    return false;
+            }
+
+            const auto& blob = columns_[ints.size()];
+            size_t blobPos = 0;
+            out_.reserve(out_.size() + numSamples_);
+            for (size_t i = 0; i < numSamples_; i++)
+            {
+                size_t c = 2;
+                const auto device_time_stamp = ints[c++][i];
+                const auto system_time_stamp = ints[c++][i];
+                std::array<int, std::size(intFields)> intVals;
+                for (auto& v : intVals)
+                    v = static_cast<int>(ints[c++][i]);
+                const bool isGif        = ints[c++][i] != 0;
+                const auto type         = static_cast<TobiiResearchEyeImageType>(ints[c++][i]);
+                const auto dataSize     = static_cast<size_t>(ints[c++][i]);
+                if (dataSize > blob.size() - blobPos)
+                    return false;
+                auto* data = const_cast<uint8_t*>(blob.data() + blobPos);
+                blobPos += dataSize;
+
+                // construct through the SDK types, so that the image data is copied into the sample
+                Titta::eyeImage image;
+                if (isGif)
+                {
+                    TobiiResearchEyeImageGif gif{};
+                    gif.device_time_stamp   = device_time_stamp;
+                    gif.system_time_stamp   = system_time_stamp;
+                    gif.type                = type;
+                    gif.camera_id           = intVals[7];
+                    gif.image_size          = dataSize;
+                    gif.image_data          = data;
+                    image = Titta::eyeImage(&gif);
+                }
+                else
+                {
+                    TobiiResearchEyeImage im{};
+                    im.device_time_stamp    = device_time_stamp;
+                    im.system_time_stamp    = system_time_stamp;
+                    im.bits_per_pixel       = intVals[0];
+                    im.padding_per_pixel    = intVals[1];
+                    im.width                = intVals[2];
+                    im.height               = intVals[3];
+                    im.type                 = type;
+                    im.camera_id            = intVals[7];
+                    im.data_size            = dataSize;
+                    im.data                 = data;
+                    image = Titta::eyeImage(&im);
+                }
+                for (size_t f = 0; f < std::size(intFields); f++)
+                    image.*intFields[f] = intVals[f];
+
+                out_.push_back({ std::move(image), ints[0][i], ints[1][i] });
+            }
+            return true;
+        }
+    };
+
+
+    template <typename DataType>
+    constexpr size_t numColumns_v = Schema<DataType>::numColumns;
+
+    template <typename DataType>
+    void encodeBlock(std::span<const DataType> samples_, std::vector<uint8_t>& out_)
+    {
+        constexpr auto numColumns = numColumns_v<DataType>;
+        static_assert(numColumns <= std::tuple_size_v<columns_t>);
+        columns_t columns;
+        Schema<DataType>::encode(samples_, columns);
+
+        std::array<uint32_t, numColumns> sizes;
+        size_t total = sizeof(sizes);
+        for (size_t c = 0; c < numColumns; c++)
+        {
+            sizes[c] = static_cast<uint32_t>(columns[c].size());
+            total   += columns[c].size();
+        }
+        out_.reserve(out_.size() + total);
+        const auto* sizesBytes = reinterpret_cast<const uint8_t*>(sizes.data());
+        out_.insert(out_.end(), sizesBytes, sizesBytes + sizeof(sizes));
+        for (size_t c = 0; c < numColumns; c++)
+            out_.insert(out_.end(), columns[c].begin(), columns[c].end());
+    }
+
+    // locate the columns of a block. Returns false if the block is corrupt
+    template <typename DataType>
+    bool getColumns(std::span<const uint8_t> block_, std::array<std::span<const uint8_t>, numColumns_v<DataType>>& columns_)
+    {
+        constexpr auto numColumns = numColumns_v<DataType>;
+        std::array<uint32_t, numColumns> sizes;
+        if (block_.size() < sizeof(sizes))
+            return false;
+        std::memcpy(sizes.data(), block_.data(), sizeof(sizes));
+        block_ = block_.subspan(sizeof(sizes));
+        for (size_t c = 0; c < numColumns; c++)
+        {
+            if (sizes[c] > block_.size())
+                return false;
+            columns_[c] = block_.first(sizes[c]);
+            block_      = block_.subspan(sizes[c]);
+        }
+        return true;
+    }
+
+    // decode a block of numSamples_ samples, appending them to out_
+    template <typename DataType>
+    bool decodeBlock(std::span<const uint8_t> block_, const size_t numSamples_, std::vector<DataType>& out_)
+    {
+        std::array<std::span<const uint8_t>, numColumns_v<DataType>> columns;
+        return getColumns<DataType>(block_, columns) && Schema<DataType>::decode(columns.data(), numSamples_, out_);
+    }
+
+    // decode only the remote or local timestamps of a block
+    template <typename DataType>
+    bool decodeTimeStamps(std::span<const uint8_t> block_, const size_t numSamples_, const bool timeIsLocalTime_, std::vector<int64_t>& out_)
+    {
+        std::array<std::span<const uint8_t>, numColumns_v<DataType>> columns;
+        if (!getColumns<DataType>(block_, columns))
+            return false;
+        const auto& column = columns[timeIsLocalTime_ ? 1 : 0];
+        const auto* in = column.data();
+        out_.resize(numSamples_);
+        return ColumnCodec::decodeInts(in, in + column.size(), out_);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <tobii_research.h>
+#include <tobii_research_streams.h>
+
+#include "Titta/types.h"
+
+// Conversion of Titta samples to and from the channel layout of the
+// LSL_streamer outlets. Used when pushing samples, and when writing received
+// samples to file in the layout described by the stream's header (and reading
+// them back)
+namespace SampleConversion
+{
+    inline std::array<double, 43> toLSL(const Titta::gaze& sample_)
+    {
+        using data_t = double;
+        return {
+            sample_.left_eye.gaze_point.position_on_display_area.x, sample_.left_eye.gaze_point.position_on_display_area.y,
+            sample_.left_eye.gaze_point.position_in_user_coordinates.x, sample_.left_eye.gaze_point.position_in_user_coordinates.y, sample_.left_eye.gaze_point.position_in_user_coordinates.z,
+            static_cast<data_t>(sample_.left_eye.gaze_point.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.gaze_point.available),
+            sample_.left_eye.pupil.diameter,
+            static_cast<data_t>(sample_.left_eye.pupil.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.pupil.available),
+            sample_.left_eye.gaze_origin.position_in_user_coordinates.x, sample_.left_eye.gaze_origin.position_in_user_coordinates.y, sample_.left_eye.gaze_origin.position_in_user_coordinates.z,
+            sample_.left_eye.gaze_origin.position_in_track_box_coordinates.x, sample_.left_eye.gaze_origin.position_in_track_box_coordinates.y, sample_.left_eye.gaze_origin.position_in_track_box_coordinates.z,
+            static_cast<data_t>(sample_.left_eye.gaze_origin.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.gaze_origin.available),
+            sample_.left_eye.eye_openness.diameter,
+            static_cast<data_t>(sample_.left_eye.eye_openness.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.left_eye.eye_openness.available),
+
+            sample_.right_eye.gaze_point.position_on_display_area.x, sample_.right_eye.gaze_point.position_on_display_area.y,
+            sample_.right_eye.gaze_point.position_in_user_coordinates.x, sample_.right_eye.gaze_point.position_in_user_coordinates.y, sample_.right_eye.gaze_point.position_in_user_coordinates.z,
+            static_cast<data_t>(sample_.right_eye.gaze_point.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.gaze_point.available),
+            sample_.right_eye.pupil.diameter,
+            static_cast<data_t>(sample_.right_eye.pupil.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.pupil.available),
+            sample_.right_eye.gaze_origin.position_in_user_coordinates.x, sample_.right_eye.gaze_origin.position_in_user_coordinates.y, sample_.right_eye.gaze_origin.position_in_user_coordinates.z,
+            sample_.right_eye.gaze_origin.position_in_track_box_coordinates.x, sample_.right_eye.gaze_origin.position_in_track_box_coordinates.y, sample_.right_eye.gaze_origin.position_in_track_box_coordinates.z,
+            static_cast<data_t>(sample_.right_eye.gaze_origin.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.gaze_origin.available),
+            sample_.right_eye.eye_openness.diameter,
+            static_cast<data_t>(sample_.right_eye.eye_openness.validity == TOBII_RESEARCH_VALIDITY_VALID),static_cast<data_t>(sample_.right_eye.eye_openness.available),
+
+            static_cast<data_t>(sample_.device_time_stamp) / 1'000'000.
+        };
+    }
+
+    inline std::array<int64_t, 4> toLSL(const Titta::extSignal& sample_)
+    {
+        return {
+            sample_.device_time_stamp, sample_.system_time_stamp, sample_.value, sample_.change_type
+        };
+    }
+
+    inline std::array<int64_t, 3> toLSL(const Titta::timeSync& sample_)
+    {
+        return {
+            sample_.system_request_time_stamp, sample_.device_time_stamp, sample_.system_response_time_stamp
+        };
+    }
+
+    inline std::array<float, 8> toLSL(const Titta::positioning& sample_)
+    {
+        return {
+            sample_.left_eye.user_position.x, sample_.left_eye.user_position.y, sample_.left_eye.user_position.z,
+            static_cast<float>(sample_.left_eye.validity == TOBII_RESEARCH_VALIDITY_VALID),
+            sample_.right_eye.user_position.x, sample_.right_eye.user_position.y, sample_.right_eye.user_position.z,
+            static_cast<float>(sample_.right_eye.validity == TOBII_RESEARCH_VALIDITY_VALID)
+        };
+    }
+
+    // inverse of the above. Gaze samples do not carry their system timestamp in
+    // a channel (it is the sample's LSL timestamp), so it has to be provided
+    inline Titta::gaze fromLSL(const std::array<double, 43>& sample_, const int64_t system_time_stamp_)
+    {
+        const double* ptr = sample_.data();
+        auto validity = [](const double v_) { return v_ == 1. ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID; };
+        auto eye = [&]()
+        {
+            decltype(Titta::gaze::left_eye) e{};
+            e.gaze_point.position_on_display_area       = {static_cast<float>(ptr[0]), static_cast<float>(ptr[1])};
+            e.gaze_point.position_in_user_coordinates   = {static_cast<float>(ptr[2]), static_cast<float>(ptr[3]), static_cast<float>(ptr[4])};
+            e.gaze_point.validity                       = validity(ptr[5]);
+            e.gaze_point.available                      = ptr[6] == 1.;
+            e.pupil.diameter                            = static_cast<float>(ptr[7]);
+            e.pupil.validity                            = validity(ptr[8]);
+            e.pupil.available                           = ptr[9] == 1.;
+            e.gaze_origin.position_in_user_coordinates  = {static_cast<float>(ptr[10]), static_cast<float>(ptr[11]), static_cast<float>(ptr[12])};
+            e.gaze_origin.position_in_track_box_coordinates = {static_cast<float>(ptr[13]), static_cast<float>(ptr[14]), static_cast<float>(ptr[15])};
+            e.gaze_origin.validity                      = validity(ptr[16]);
+            e.gaze_origin.available                     = ptr[17] == 1.;
+            e.eye_openness.diameter                     = static_cast<float>(ptr[18]);
+            e.eye_openness.validity                     = validity(ptr[19]);
+            e.eye_openness.available                    = ptr[20] == 1.;
+            ptr += 21;
+            return e;
+        };
+        Titta::gaze out{};
+        out.left_eye            = eye();
+        out.right_eye           = eye();
+        out.device_time_stamp   = std::llround(*ptr * 1'000'000.);
+        out.system_time_stamp   = system_time_stamp_;
+        return out;
+    }
+
+    inline Titta::extSignal fromLSL(const std::array<int64_t, 4>& sample_)
+    {
+        return {
+            sample_[0], sample_[1], static_cast<uint32_t>(sample_[2]), static_cast<TobiiResearchExternalSignalChangeType>(sample_[3])
+        };
+    }
+
+    inline Titta::timeSync fromLSL(const std::array<int64_t, 3>& sample_)
+    {
+        return {
+            sample_[0], sample_[1], sample_[2]
+        };
+    }
+
+    inline Titta::positioning fromLSL(const std::array<float, 8>& sample_)
+    {
+        return {
+            {{sample_[0], sample_[1], sample_[2]}, sample_[3] == 1.f ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID},
+            {{sample_[4], sample_[5], sample_[6]}, sample_[7] == 1.f ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID}
+        };
+    }
+}
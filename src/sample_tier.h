@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <type_traits>
+
+#include "LSL_streamer/types.h"
+
+// only samples that can be stored as raw bytes or columns can be moved out of
+// an inlet's buffer into an older tier. Not numeric samples: their channel
+// values are not stored in the buffer itself
+template <typename DataType>
+constexpr bool hasOlderTier_v = std::is_trivially_copyable_v<DataType> && !std::is_same_v<DataType, LSLTypes::numeric>;
+
+// Storage for the oldest samples of an inlet, moved out of the inlet's buffer
+// when it exceeds its memory budget: on disk (SpillStore, SpillToDisk policy)
+// or compressed in RAM (CompressedStore, Compress policy). Samples in the tier
+// are older than any sample in the inlet's buffer, and like the buffer are
+// ordered by arrival (timestamps are not necessarily sorted, see
+// time_index.h). Indices are into the tier, 0 being the oldest sample.
+// !NB: appropriate locking is responsibility of the caller (the inlet's lock)!
+// Const member functions are safe to call concurrently.
+template <typename DataType>
+class SampleTier
+{
+public:
+    virtual ~SampleTier() = default;
+
+    virtual size_t size() const = 0;
+    bool           empty() const { return !size(); }
+    // bytes the tier's samples take up, and whether those are in RAM
+    virtual size_t bytes() const = 0;
+    virtual bool   isInMemory() const = 0;
+
+    // store samples, which must be newer than those already in the tier.
+    // Returns false if the samples could not be stored
+    virtual bool append(std::span<const DataType> samples_) = 0;
+
+    // index of first sample with timestamp >= time_ (size() if none)
+    virtual size_t firstAtOrAfter(int64_t time_, LSLTypes::TimeClock clock_) const = 0;
+    // one past the index of the last sample with timestamp <= time_ (0 if none)
+    virtual size_t pastLastAtOrBefore(int64_t time_, LSLTypes::TimeClock clock_) const = 0;
+    // smallest and largest timestamp of the tier's samples. Only call when the tier is not empty
+    virtual int64_t minTimeStamp(LSLTypes::TimeClock clock_) const = 0;
+    virtual int64_t maxTimeStamp(LSLTypes::TimeClock clock_) const = 0;
+
+    // copy out samples [start_, end_)
+    virtual std::vector<DataType> read(size_t start_, size_t end_) const = 0;
+    // remove samples [start_, end_)
+    virtual void erase(size_t start_, size_t end_) = 0;
+    virtual void clear() = 0;
+};
@@ -0,0 +1,310 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <span>
+#include <string>
+#include <filesystem>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "mapped_file.h"
+#include "sample_tier.h"
+#include "time_index.h"
+
+// On-disk tier of an inlet's buffer. Older samples are moved out of RAM into
+// segment files, each holding a contiguous run of samples. A per-segment index
+// of the range of timestamps allows finding the segments that hold a time
+// range without touching the others, only those segments are memory-mapped
+// (and only while they are being read). Segment files are deleted when the
+// store is destroyed.
+// Files are written by the store's writer thread, so that appending does not
+// do disk I/O while the caller holds the inlet's lock. Until a batch is
+// written, its samples are read from RAM. Erasing never rewrites a file: a
+// segment is a view of part of a file, erasing shrinks or splits views and a
+// file is deleted once no view refers to it anymore. Erasing does not read
+// files either: a view cut from a segment keeps that segment's timestamp
+// extent and run bounds, which may be looser than its own (time_index.h).
+template <typename DataType>
+class SpillStore : public SampleTier<DataType>
+{
+    static_assert(hasOlderTier_v<DataType>, "SpillStore: only trivially copyable samples can be stored on disk");
+
+    // a segment file, deleted when the last segment referring to it is gone
+    struct File
+    {
+        std::filesystem::path                           path;
+        std::shared_ptr<const std::vector<DataType>>    pending;    // samples not yet written (guarded by _pendingMutex)
+
+        ~File()
+        {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    };
+    struct Segment
+    {
+        std::shared_ptr<File>   file;
+        size_t                  offset;     // index of segment's first sample in the file
+        size_t                  first;      // index of first sample in the whole store
+        size_t                  count;
+        TimeIndex::Extent       extent;
+        TimeIndex::Bounds       bounds;
+        TimeIndex::runs_t       runs;
+        bool                    exact = true;   // false if extent and run bounds are those of the segment this one was cut from
+    };
+    // samples of a segment, kept available (in RAM or mapped) for as long as owner lives
+    struct SegmentData
+    {
+        std::shared_ptr<const void> owner;
+        const DataType*             data;
+    };
+
+public:
+    // a directory for this store's segments is created in directory_
+    explicit SpillStore(const std::filesystem::path& directory_)
+    {
+        static std::atomic<uint64_t> storeCount = 0;
+        const auto now = std::chrono::system_clock::now().time_since_epoch().count();
+        _directory = directory_ / std::format("LSL_streamer_{}_{}", now, storeCount++);
+        std::error_code ec;     // NB: failure shows up as failure to append
+        std::filesystem::create_directories(_directory, ec);
+        _writer = std::thread(&SpillStore::writerThreadFunc, this);
+    }
+    ~SpillStore() override
+    {
+        {
+            std::lock_guard l(_pendingMutex);
+            _writerShouldStop = true;
+        }
+        _writerCv.notify_one();
+        _writer.join();
+        // NB: segments (and with them their files) must be gone before the directory is removed
+        _segments.clear();
+        _writeQueue.clear();
+        std::error_code ec;
+        std::filesystem::remove_all(_directory, ec);
+    }
+    SpillStore(const SpillStore&) = delete;
+    SpillStore& operator=(const SpillStore&) = delete;
+
+    size_t size()  const override { return _segments.empty() ? 0 : _segments.back().first + _segments.back().count; }
+    size_t bytes() const override { return size() * sizeof(DataType); }
+    bool   isInMemory() const override { return false; }
+
+    // hand samples to the writer thread, they go to a new segment file. Returns false
+    // once writing a file has failed
+    bool append(std::span<const DataType> samples_) override
+    {
+        if (samples_.empty())
+            return true;
+        if (_writeFailed)
+            return false;
+        auto file = std::make_shared<File>(newFile(), std::make_shared<const std::vector<DataType>>(samples_.begin(), samples_.end()));
+        {
+            std::lock_guard l(_pendingMutex);
+            _writeQueue.push_back(file);
+        }
+        _writerCv.notify_one();
+        _segments.push_back({std::move(file), 0, size(), samples_.size(), TimeIndex::getExtent(samples_), {}, TimeIndex::makeIndex(samples_)});
+        TimeIndex::boundsAppended(_segments);
+        return true;
+    }
+
+    size_t firstAtOrAfter(const int64_t time_, const LSLTypes::TimeClock clock_) const override
+    {
+        return TimeIndex::firstAtOrAfter(_segments, [this](const Segment& seg_, const LSLTypes::TimeClock clock_) { return getTimeStamps(seg_, clock_); }, time_, clock_);
+    }
+    size_t pastLastAtOrBefore(const int64_t time_, const LSLTypes::TimeClock clock_) const override
+    {
+        return TimeIndex::pastLastAtOrBefore(_segments, [this](const Segment& seg_, const LSLTypes::TimeClock clock_) { return getTimeStamps(seg_, clock_); }, time_, clock_);
+    }
+
+    // the bounds are exact unless segments were cut, those segments' own timestamps are then
+    // looked at where they could hold the smallest or largest one
+    int64_t minTimeStamp(const LSLTypes::TimeClock clock_) const override
+    {
+        if (!_numCut)
+            return _segments.front().bounds.minFrom[clock_];
+        auto out = std::numeric_limits<int64_t>::max();
+        for (const auto& seg : _segments)
+            if (seg.extent.min[clock_] < out)
+                out = seg.exact ? seg.extent.min[clock_] : std::min(out, getExactExtent(seg, clock_).first);
+        return out;
+    }
+    int64_t maxTimeStamp(const LSLTypes::TimeClock clock_) const override
+    {
+        if (!_numCut)
+            return _segments.back().bounds.maxUpTo[clock_];
+        auto out = std::numeric_limits<int64_t>::min();
+        for (const auto& seg : _segments)
+            if (seg.extent.max[clock_] > out)
+                out = seg.exact ? seg.extent.max[clock_] : std::max(out, getExactExtent(seg, clock_).second);
+        return out;
+    }
+
+    std::vector<DataType> read(size_t start_, size_t end_) const override
+    {
+        end_ = std::min(end_, size());
+        std::vector<DataType> out;
+        if (start_ >= end_)
+            return out;
+        out.resize(end_ - start_);
+        auto* dst = out.data();
+        for (const auto& seg : _segments)
+        {
+            const auto s = std::max(start_, seg.first);
+            const auto e = std::min(end_, seg.first + seg.count);
+            if (s >= e)
+                continue;
+            const auto d = getData(seg);
+            std::memcpy(dst, d.data + (s - seg.first), (e - s) * sizeof(DataType));
+            dst += e - s;
+        }
+        return out;
+    }
+
+    // segments are shrunk or split, whole segments are dropped. No file is rewritten
+    void erase(size_t start_, size_t end_) override
+    {
+        end_ = std::min(end_, size());
+        if (start_ >= end_)
+            return;
+        std::vector<Segment> kept;
+        kept.reserve(_segments.size() + 1);
+        for (auto& seg : _segments)
+        {
+            const auto s = std::max(start_, seg.first);
+            const auto e = std::min(end_, seg.first + seg.count);
+            if (s >= e)
+            {
+                // untouched
+                kept.push_back(std::move(seg));
+                continue;
+            }
+
+            // keep what is before and after the removed samples, as views of the same file
+            if (s > seg.first)
+                kept.push_back(cut(seg, 0, s - seg.first));
+            if (e < seg.first + seg.count)
+                kept.push_back(cut(seg, e - seg.first, seg.count));
+        }
+        _segments = std::move(kept);
+        _numCut   = std::ranges::count(_segments, false, &Segment::exact);
+        renumber();
+        TimeIndex::updateBounds(_segments);
+    }
+
+    void clear() override
+    {
+        _segments.clear();
+        _numCut = 0;
+    }
+
+private:
+    std::filesystem::path newFile()
+    {
+        return _directory / std::format("{}.seg", _fileCount++);
+    }
+    void renumber()
+    {
+        size_t first = 0;
+        for (auto& seg : _segments)
+        {
+            seg.first = first;
+            first += seg.count;
+        }
+    }
+    // samples of the segment, from RAM if its file has not been written yet, else mapped
+    SegmentData getData(const Segment& seg_) const
+    {
+        std::shared_ptr<const std::vector<DataType>> pending;
+        {
+            std::lock_guard l(_pendingMutex);
+            pending = seg_.file->pending;
+        }
+        if (pending)
+            return {pending, pending->data() + seg_.offset};
+        auto map = std::make_shared<MappedFile>(seg_.file->path);
+        return {map, reinterpret_cast<const DataType*>(map->data()) + seg_.offset};
+    }
+    // view of samples [start_, end_) of a segment
+    static Segment cut(const Segment& seg_, const size_t start_, const size_t end_)
+    {
+        return {seg_.file, seg_.offset + start_, 0, end_ - start_, seg_.extent, {}, TimeIndex::sliceIndex(seg_.runs, seg_.count, start_, end_), false};
+    }
+    // smallest and largest timestamp of a segment's samples. Within a run of its time
+    // index, the first sample is the earliest and the last the latest
+    std::pair<int64_t, int64_t> getExactExtent(const Segment& seg_, const LSLTypes::TimeClock clock_) const
+    {
+        const auto ts   = getTimeStamps(seg_, clock_);
+        const auto& runs= seg_.runs[clock_];
+        if (runs.empty())
+            return {ts(0), ts(seg_.count - 1)};
+        std::pair out{ts(0), ts(runs[1].start - 1)};
+        for (size_t r = 1; r < runs.size(); r++)
+        {
+            out.first  = std::min(out.first , ts(runs[r].start));
+            out.second = std::max(out.second, ts((r + 1 < runs.size() ? runs[r + 1].start : seg_.count) - 1));
+        }
+        return out;
+    }
+    // access to the timestamps of a segment's samples, keeps them available for as long as the getter lives
+    auto getTimeStamps(const Segment& seg_, const LSLTypes::TimeClock clock_) const
+    {
+        return [d = getData(seg_), clock_](const size_t i_)
+        {
+            return LSLTypes::getTimeStamp(d.data[i_], clock_);
+        };
+    }
+
+    void writerThreadFunc()
+    {
+        std::unique_lock l(_pendingMutex);
+        while (true)
+        {
+            _writerCv.wait(l, [this] { return _writerShouldStop || !_writeQueue.empty(); });
+            if (_writerShouldStop)
+                return;
+
+            // write without holding the lock. NB: the file stays alive while it is written,
+            // even if its segments are erased in the meantime
+            const auto file = std::move(_writeQueue.front());
+            _writeQueue.pop_front();
+            const auto samples = file->pending;
+            l.unlock();
+            const auto ok = MappedFile::write(file->path, samples->data(), samples->size() * sizeof(DataType));
+            l.lock();
+
+            if (ok)
+                file->pending.reset();
+            else
+                // samples stay in RAM, further batches are refused so that the inlet falls
+                // back to dropping samples
+                _writeFailed = true;
+        }
+    }
+
+private:
+    std::filesystem::path   _directory;
+    std::vector<Segment>    _segments;
+    size_t                  _numCut    = 0;     // segments that are not exact
+    size_t                  _fileCount = 0;
+
+    // writer thread, and files waiting for it
+    mutable std::mutex                  _pendingMutex;
+    std::condition_variable             _writerCv;
+    std::deque<std::shared_ptr<File>>   _writeQueue;
+    bool                                _writerShouldStop = false;
+    std::atomic<bool>                   _writeFailed = false;
+    std::thread                         _writer;
+};
@@ -0,0 +1,304 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <span>
+#include <algorithm>
+#include <ranges>
+#include <cstdint>
+
+#include "LSL_streamer/types.h"
+
+// Index for time range searches on each clock of a sequence of samples.
+// Timestamps normally increase, but not necessarily: local timestamps are
+// remote timestamps plus the inlet's time correction, which is re-estimated as
+// samples come in and may step back. The index splits the sequence, per clock,
+// at the positions at which the timestamp decreases into sorted runs. Like the
+// parts of a store (see Bounds below), each run holds the maximum timestamp of
+// all runs up to it and the minimum of all runs from it on, so that the run a
+// time point falls in is found by binary search, and then the sample within it.
+// Bounds may be loose, i.e. wider than the timestamps they cover (see
+// sliceIndex()), the searches then move on to the next run or part if the one
+// found has no matching sample.
+// A time range [t0, t1] is taken to span from the first sample with a
+// timestamp >= t0 to the last sample with a timestamp <= t1. For sorted
+// timestamps, that is the usual lower_bound/upper_bound pair
+namespace TimeIndex
+{
+    using TimeClock = LSLTypes::TimeClock;
+    using Run       = LSLTypes::TimeRun;
+    using runs_t    = std::array<std::vector<Run>, TimeClock::numClocks>;  // per clock: all runs, none if the timestamps are sorted
+
+    namespace detail
+    {
+        // recompute the bounds of the runs of n_ samples
+        template <typename Getter>
+        void updateRunBounds(std::vector<Run>& runs_, const size_t n_, Getter getTime_)
+        {
+            // within a run, the first sample is the earliest and the last the latest
+            for (size_t r = 0; r < runs_.size(); r++)
+            {
+                const auto latest = getTime_((r + 1 < runs_.size() ? runs_[r + 1].start : n_) - 1);
+                runs_[r].maxUpTo  = r ? std::max(runs_[r - 1].maxUpTo, latest) : latest;
+            }
+            for (auto r = runs_.size(); r-- > 0;)
+            {
+                const auto earliest = getTime_(runs_[r].start);
+                runs_[r].minFrom    = r + 1 < runs_.size() ? std::min(runs_[r + 1].minFrom, earliest) : earliest;
+            }
+        }
+        template <typename DataType>
+        auto getTimeStamps(std::span<const DataType> samples_, const TimeClock::Value clock_)
+        {
+            return [samples_, clock_](const size_t i_) { return LSLTypes::getTimeStamp(samples_[i_], clock_); };
+        }
+        // first index in [b_, e_) with a timestamp >= time_, and one past the last with
+        // one <= time_, for sorted timestamps
+        template <typename Getter>
+        size_t lowerBound(size_t b_, size_t e_, Getter& getTime_, const int64_t time_)
+        {
+            while (b_ < e_)
+            {
+                const auto mid = b_ + (e_ - b_) / 2;
+                if (getTime_(mid) < time_)
+                    b_ = mid + 1;
+                else
+                    e_ = mid;
+            }
+            return b_;
+        }
+        template <typename Getter>
+        size_t upperBound(size_t b_, size_t e_, Getter& getTime_, const int64_t time_)
+        {
+            while (b_ < e_)
+            {
+                const auto mid = b_ + (e_ - b_) / 2;
+                if (getTime_(mid) <= time_)
+                    b_ = mid + 1;
+                else
+                    e_ = mid;
+            }
+            return b_;
+        }
+        template <typename DataType>
+        constexpr size_t numClocks = LSLTypes::hasDeviceTimeStamp_v<DataType> ? TimeClock::numClocks : TimeClock::numClocks - 1;
+    }
+
+    // index samples [numIndexed_, size) of samples_, after they were appended
+    template <typename DataType>
+    void indexAppended(std::span<const DataType> samples_, runs_t& runs_, size_t& numIndexed_)
+    {
+        for (size_t c = 0; c < detail::numClocks<DataType>; c++)
+        {
+            auto& runs = runs_[c];
+            const auto getTime = detail::getTimeStamps(samples_, static_cast<TimeClock::Value>(c));
+            for (auto i = std::max<size_t>(numIndexed_, 1); i < samples_.size(); i++)
+            {
+                const auto t = getTime(i);
+                if (t >= getTime(i - 1))
+                {
+                    if (!runs.empty())
+                        runs.back().maxUpTo = std::max(runs.back().maxUpTo, t);
+                    continue;
+                }
+                // a new run. Until now the samples were sorted, if there are no runs yet
+                if (runs.empty())
+                    runs.push_back({0, getTime(i - 1), getTime(0)});
+                runs.push_back({i, runs.back().maxUpTo, t});
+                for (auto r = runs.size() - 1; r-- > 0 && runs[r].minFrom > t;)
+                    runs[r].minFrom = t;
+            }
+        }
+        numIndexed_ = samples_.size();
+    }
+    template <typename DataType>
+    runs_t makeIndex(std::span<const DataType> samples_)
+    {
+        runs_t runs;
+        size_t n = 0;
+        indexAppended(samples_, runs, n);
+        return runs;
+    }
+
+    // update index after samples [start_, end_) were removed, samples_ are the
+    // remaining samples
+    template <typename DataType>
+    void indexErased(std::span<const DataType> samples_, runs_t& runs_, size_t& numIndexed_, const size_t start_, size_t end_)
+    {
+        end_ = std::min(end_, numIndexed_);
+        if (start_ >= end_)
+            return;
+        const auto n = end_ - start_;
+        numIndexed_ -= n;
+        for (size_t c = 0; c < detail::numClocks<DataType>; c++)
+        {
+            auto& runs = runs_[c];
+            if (runs.empty())
+                // sorted samples stay sorted
+                continue;
+            const auto getTime = detail::getTimeStamps(samples_, static_cast<TimeClock::Value>(c));
+
+            // runs starting within [start_, end_] started at removed samples, or at the
+            // sample that now follows the removed ones. Whether a run starts there is
+            // decided by the samples that became neighbors
+            const auto first = std::ranges::lower_bound(runs, start_, {}, &Run::start);
+            const auto last  = std::ranges::upper_bound(runs, end_, {}, &Run::start);
+            for (auto it = last; it != runs.end(); ++it)
+                it->start -= n;
+            const auto pos = runs.erase(first, last);
+            if (start_ > 0 && start_ < numIndexed_ && getTime(start_) < getTime(start_ - 1))
+                runs.insert(pos, Run{start_});
+            // the first run starts at the first sample, a single run means sorted
+            if (!runs.empty() && runs.front().start != 0)
+                runs.insert(runs.begin(), Run{0});
+            if (runs.size() < 2)
+                runs.clear();
+            detail::updateRunBounds(runs, numIndexed_, getTime);
+        }
+    }
+
+    // index of samples [start_, end_) of the n_ indexed ones, without looking at
+    // the samples: the bounds of the runs are kept, so they may be loose
+    inline runs_t sliceIndex(const runs_t& runs_, const size_t n_, const size_t start_, size_t end_)
+    {
+        end_ = std::min(end_, n_);
+        runs_t out;
+        if (start_ >= end_)
+            return out;
+        for (size_t c = 0; c < TimeClock::numClocks; c++)
+        {
+            const auto& runs = runs_[c];
+            if (runs.empty())
+                continue;
+            // the run start_ is in, up to the first run starting at or after end_
+            const auto first = std::prev(std::ranges::upper_bound(runs, start_, {}, &Run::start));
+            const auto last  = std::ranges::lower_bound(runs, end_, {}, &Run::start);
+            if (std::distance(first, last) < 2)
+                continue;
+            auto& sliced = out[c];
+            sliced.assign(first, last);
+            for (auto& r : sliced)
+                r.start = r.start > start_ ? r.start - start_ : 0;
+        }
+        return out;
+    }
+
+    // index of first of n_ samples with timestamp >= time_ (n_ if none).
+    // getTime_(i) returns the timestamp of sample i
+    template <typename Getter>
+    size_t firstAtOrAfter(const size_t n_, std::span<const Run> runs_, Getter getTime_, const int64_t time_)
+    {
+        if (runs_.empty())
+            return detail::lowerBound(0, n_, getTime_, time_);
+        // from the first run with a timestamp >= time_
+        for (auto it = std::ranges::partition_point(runs_, [time_](const Run& r_) { return r_.maxUpTo < time_; }); it != runs_.end(); ++it)
+        {
+            const auto e = std::next(it) != runs_.end() ? std::next(it)->start : n_;
+            if (const auto i = detail::lowerBound(it->start, e, getTime_, time_); i < e)
+                return i;
+        }
+        return n_;
+    }
+    // one past the index of the last of n_ samples with timestamp <= time_ (0 if none)
+    template <typename Getter>
+    size_t pastLastAtOrBefore(const size_t n_, std::span<const Run> runs_, Getter getTime_, const int64_t time_)
+    {
+        if (runs_.empty())
+            return detail::upperBound(0, n_, getTime_, time_);
+        // from the last run with a timestamp <= time_, backwards
+        for (auto it = std::ranges::partition_point(runs_, [time_](const Run& r_) { return r_.minFrom <= time_; }); it != runs_.begin(); --it)
+        {
+            const auto b = std::prev(it)->start;
+            if (const auto i = detail::upperBound(b, it != runs_.end() ? it->start : n_, getTime_, time_); i > b)
+                return i;
+        }
+        return 0;
+    }
+
+    // range of timestamps of a contiguous set of samples, per clock
+    struct Extent
+    {
+        std::array<int64_t, TimeClock::numClocks> min{}, max{};
+    };
+    template <typename DataType>
+    Extent getExtent(std::span<const DataType> samples_)
+    {
+        Extent out;
+        for (size_t c = 0; c < TimeClock::numClocks; c++)
+        {
+            const auto clock = static_cast<TimeClock::Value>(c);
+            const auto [mn, mx] = std::ranges::minmax(samples_ | std::views::transform([clock](const DataType& s_) { return LSLTypes::getTimeStamp(s_, clock); }));
+            out.min[c] = mn;
+            out.max[c] = mx;
+        }
+        return out;
+    }
+
+    // bounds over a store's parts, per clock: the maximum timestamp of all
+    // parts up to and including a part, and the minimum of all parts from it
+    // on. Unlike the parts' extents, these are monotonic over the parts, so
+    // that the parts a time range falls in can be binary searched
+    struct Bounds
+    {
+        std::array<int64_t, TimeClock::numClocks> maxUpTo{}, minFrom{};
+    };
+    // update bounds after a part was appended. Earlier parts only need updating
+    // if the new part has older timestamps than they do
+    template <typename Part>
+    void boundsAppended(std::vector<Part>& parts_)
+    {
+        auto& last = parts_.back();
+        for (size_t c = 0; c < TimeClock::numClocks; c++)
+        {
+            last.bounds.maxUpTo[c] = parts_.size() > 1 ? std::max(parts_[parts_.size() - 2].bounds.maxUpTo[c], last.extent.max[c]) : last.extent.max[c];
+            last.bounds.minFrom[c] = last.extent.min[c];
+            for (auto i = parts_.size() - 1; i-- > 0 && parts_[i].bounds.minFrom[c] > last.extent.min[c];)
+                parts_[i].bounds.minFrom[c] = last.extent.min[c];
+        }
+    }
+    // recompute the bounds of all parts, e.g. after parts were removed or changed
+    template <typename Part>
+    void updateBounds(std::vector<Part>& parts_)
+    {
+        for (size_t c = 0; c < TimeClock::numClocks; c++)
+        {
+            for (size_t i = 0; i < parts_.size(); i++)
+                parts_[i].bounds.maxUpTo[c] = i ? std::max(parts_[i - 1].bounds.maxUpTo[c], parts_[i].extent.max[c]) : parts_[i].extent.max[c];
+            for (auto i = parts_.size(); i-- > 0;)
+                parts_[i].bounds.minFrom[c] = i + 1 < parts_.size() ? std::min(parts_[i + 1].bounds.minFrom[c], parts_[i].extent.min[c]) : parts_[i].extent.min[c];
+        }
+    }
+
+    // Searches over a store made up of parts (segments, blocks) that each have
+    // members first (index of its first sample in the store), count, extent,
+    // bounds (kept up to date with boundsAppended() and updateBounds()) and
+    // runs. getterOf_(part_, clock_) returns a getter of the timestamps of a
+    // part's samples, it is only called for the part the result falls in (and,
+    // if extents are loose, the parts before it that turn out not to match)
+    template <typename Part, typename GetterOf>
+    size_t firstAtOrAfter(const std::vector<Part>& parts_, GetterOf getterOf_, const int64_t time_, const TimeClock clock_)
+    {
+        // from the first part with a timestamp >= time_
+        for (auto it = std::ranges::partition_point(parts_, [&](const Part& p_) { return p_.bounds.maxUpTo[clock_] < time_; }); it != parts_.end(); ++it)
+        {
+            if (it->extent.min[clock_] >= time_)
+                return it->first;
+            if (const auto i = firstAtOrAfter(it->count, it->runs[clock_], getterOf_(*it, clock_), time_); i < it->count)
+                return it->first + i;
+        }
+        return parts_.empty() ? 0 : parts_.back().first + parts_.back().count;
+    }
+    template <typename Part, typename GetterOf>
+    size_t pastLastAtOrBefore(const std::vector<Part>& parts_, GetterOf getterOf_, const int64_t time_, const TimeClock clock_)
+    {
+        // from the last part with a timestamp <= time_, backwards
+        for (auto it = std::ranges::partition_point(parts_, [&](const Part& p_) { return p_.bounds.minFrom[clock_] <= time_; }); it != parts_.begin(); --it)
+        {
+            const auto& part = *std::prev(it);
+            if (part.extent.max[clock_] <= time_)
+                return part.first + part.count;
+            if (const auto i = pastLastAtOrBefore(part.count, part.runs[clock_], getterOf_(part, clock_), time_); i > 0)
+                return part.first + i;
+        }
+        return 0;
+    }
+}
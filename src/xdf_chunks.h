@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <limits>
+
+// Encoding of XDF chunks (https://github.com/sccn/xdf/wiki/Specifications), as
+// written by XdfRecorder. A chunk is its length (a variable length integer),
+// its tag and its content; stream chunks start their content with the
+// stream's id
+namespace XdfChunks
+{
+    // XDF chunk tags
+    enum class Tag : uint16_t
+    {
+        FileHeader      = 1,
+        StreamHeader    = 2,
+        Samples         = 3,
+        ClockOffset     = 4,
+        Boundary        = 5,
+        StreamFooter    = 6
+    };
+
+    // NB: XDF is little endian, as are all platforms LSL_streamer is built for
+    template <typename T>
+    void put(std::string& buf_, const T& val_)
+    {
+        buf_.append(reinterpret_cast<const char*>(&val_), sizeof(T));
+    }
+
+    // variable length integer: number of bytes (1, 4 or 8), followed by value
+    inline void putVarLen(std::string& buf_, const uint64_t val_)
+    {
+        if (val_ <= std::numeric_limits<uint8_t>::max())
+        {
+            put<uint8_t>(buf_, 1);
+            put(buf_, static_cast<uint8_t>(val_));
+        }
+        else if (val_ <= std::numeric_limits<uint32_t>::max())
+        {
+            put<uint8_t>(buf_, 4);
+            put(buf_, static_cast<uint32_t>(val_));
+        }
+        else
+        {
+            put<uint8_t>(buf_, 8);
+            put(buf_, val_);
+        }
+    }
+
+    inline std::string makeChunk(const Tag tag_, const std::string_view content_)
+    {
+        std::string chunk;
+        chunk.reserve(content_.size() + 11);
+        putVarLen(chunk, content_.size() + sizeof(Tag));
+        put(chunk, tag_);
+        chunk.append(content_);
+        return chunk;
+    }
+
+    inline std::string makeStreamChunk(const Tag tag_, const uint32_t xdfId_, const std::string_view content_)
+    {
+        std::string content;
+        content.reserve(content_.size() + sizeof(xdfId_));
+        put(content, xdfId_);
+        content.append(content_);
+        return makeChunk(tag_, content);
+    }
+
+    // fixed sequence that marks a boundary chunk
+    constexpr uint8_t boundaryUUID[] = { 0x43, 0xA5, 0x46, 0xDC, 0xCB, 0xF5, 0x41, 0x0F, 0xB3, 0x0E, 0xD5, 0x46, 0x73, 0x83, 0xCB, 0xE4 };
+}
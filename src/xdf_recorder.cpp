@@ -0,0 +1,377 @@
+#include "LSL_streamer/xdf_recorder.h"
+#include "LSL_streamer/LSL_streamer.h"
+
+#include <algorithm>
+#include <format>
+#include <string_view>
+#include <limits>
+
+#include "Titta/utils.h"
+#include "sample_conversion.h"
+#include "xdf_chunks.h"
+
+namespace
+{
+    using namespace XdfChunks;
+
+    namespace defaults
+    {
+        constexpr bool                  fromStart               = true;
+        constexpr auto                  pollInterval            = std::chrono::milliseconds(100);
+        constexpr auto                  clockOffsetInterval     = std::chrono::seconds(5);
+        constexpr auto                  boundaryInterval        = std::chrono::seconds(10);
+        constexpr size_t                fileBufferSize          = 1<<20;
+    }
+
+    template <typename DataType>
+    const auto& getData(const DataType& sample_)
+    {
+        if      constexpr (std::is_same_v<DataType, LSL_streamer::gaze>)
+            return sample_.gazeData;
+        else if constexpr (std::is_same_v<DataType, LSL_streamer::extSignal>)
+            return sample_.extSignalData;
+        else if constexpr (std::is_same_v<DataType, LSL_streamer::timeSync>)
+            return sample_.timeSyncData;
+        else if constexpr (std::is_same_v<DataType, LSL_streamer::positioning>)
+            return sample_.positioningData;
+    }
+}
+
+
+XdfRecorder::XdfRecorder(LSL_streamer& streamer_, const std::filesystem::path& file_, const std::vector<uint32_t>& inletIds_) :
+    _streamer(streamer_),
+    _fileBuffer(std::make_unique<char[]>(defaults::fileBufferSize)),
+    _startTime(std::chrono::steady_clock::now())
+{
+    _file.rdbuf()->pubsetbuf(_fileBuffer.get(), defaults::fileBufferSize);
+    _file.open(file_, std::ios::binary | std::ios::trunc);
+    if (!_file)
+        DoExitWithMsg(std::format("XdfRecorder: cannot open {} for writing", file_.string()));
+
+    enqueue("XDF:");
+    enqueue(makeChunk(Tag::FileHeader, R"(<?xml version="1.0"?><info><version>1.0</version></info>)"));
+
+    // add the inlets before the threads are started, so that if one cannot be
+    // recorded, no running threads are left behind when the exception leaves the
+    // constructor (the destructor does not run then). Undo the inlets added so far
+    try
+    {
+        for (const auto id : inletIds_)
+            addInlet(id);
+    }
+    catch (...)
+    {
+        for (const auto& stream : _streams)
+        {
+            try
+            {
+                _streamer.removeCursor(stream.inletId, stream.cursor);
+            }
+            catch (...)
+            {
+                // inlet is gone, and with it the cursor
+            }
+        }
+        throw;
+    }
+
+    _collector = std::thread(&XdfRecorder::collectorThreadFunc, this);
+    _writer    = std::thread(&XdfRecorder::writerThreadFunc, this);
+}
+XdfRecorder::~XdfRecorder()
+{
+    stop();
+}
+
+void XdfRecorder::addInlet(const uint32_t id_, std::optional<bool> fromStart_)
+{
+    if (!_isRecording)
+        DoExitWithMsg("XdfRecorder::addInlet: recorder is stopped");
+
+    const auto type = _streamer.getInletType(id_);
+    if (type == Titta::Stream::EyeImage)
+        DoExitWithMsg(std::format("XdfRecorder::addInlet: inlet with id {} is an {} stream, which cannot be recorded", id_, Titta::streamToString(type)));
+    if (type == Titta::Stream::Unknown)
+        DoExitWithMsg(std::format("XdfRecorder::addInlet: inlet with id {} is a generic numeric or marker inlet, which cannot be recorded", id_));
+    const auto header = _streamer.getInletInfo(id_).as_xml();
+
+    std::lock_guard l(_streamsMutex);
+    if (std::ranges::any_of(_streams, [id_](const Stream& s_) { return s_.inletId == id_; }))
+        DoExitWithMsg(std::format("XdfRecorder::addInlet: inlet with id {} is already being recorded", id_));
+
+    // NB: cursor first, so that the stream is not added if that fails
+    auto cursor = std::format("XdfRecorder@{}", static_cast<const void*>(this));
+    _streamer.addCursor(id_, cursor, fromStart_.value_or(defaults::fromStart));
+    auto& stream = _streams.emplace_back(Stream{
+        .inletId = id_,
+        .xdfId   = _nextXdfId++,
+        .type    = type,
+        .cursor  = std::move(cursor)
+    });
+    enqueue(makeStreamChunk(Tag::StreamHeader, stream.xdfId, header));
+    collect(stream, true);
+}
+
+void XdfRecorder::removeInlet(const uint32_t id_)
+{
+    std::lock_guard l(_streamsMutex);
+    const auto it = std::ranges::find_if(_streams, [id_](const Stream& s_) { return s_.inletId == id_; });
+    if (it == _streams.end())
+        DoExitWithMsg(std::format("XdfRecorder::removeInlet: inlet with id {} is not being recorded", id_));
+
+    finishStream(*it);
+    _streams.erase(it);
+}
+
+std::vector<uint32_t> XdfRecorder::getInlets() const
+{
+    std::lock_guard l(_streamsMutex);
+    std::vector<uint32_t> out;
+    out.reserve(_streams.size());
+    for (const auto& stream : _streams)
+        out.push_back(stream.inletId);
+    return out;
+}
+
+void XdfRecorder::stop()
+{
+    if (!_isRecording.exchange(false))
+        return;
+
+    // collector records what remains and writes the footers, then the writer drains the queue
+    {
+        std::lock_guard l(_collectorMutex);
+        _stopCollector = true;
+    }
+    _collectorCv.notify_one();
+    if (_collector.joinable())
+        _collector.join();
+
+    {
+        std::lock_guard l(_queueMutex);
+        _stopWriter = true;
+    }
+    _queueCv.notify_one();
+    if (_writer.joinable())
+        _writer.join();
+
+    _file.close();
+    if (_file.fail())
+        _writeFailed = true;
+}
+
+XdfRecorder::Stats XdfRecorder::getStats() const
+{
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _startTime).count();
+    Stats stats;
+    stats.samplesWritten    = _samplesWritten;
+    stats.bytesWritten      = _bytesWritten;
+    stats.throughput        = elapsed > 0. ? static_cast<double>(stats.bytesWritten) / elapsed : 0.;
+    stats.recentThroughput  = _recentThroughput;
+    stats.backlogChunks     = _backlogChunks;
+    stats.backlogBytes      = _backlogBytes;
+    stats.streamsDropped    = _streamsDropped;
+    stats.writeFailed       = _writeFailed;
+    return stats;
+}
+
+void XdfRecorder::collect(Stream& stream_, const bool force_clock_offset_)
+{
+    if (stream_.failed)
+        return;
+    try
+    {
+        switch (stream_.type)
+        {
+        case Titta::Stream::Gaze:
+        case Titta::Stream::EyeOpenness:
+            collectSamples<LSL_streamer::gaze>(stream_);
+            break;
+        case Titta::Stream::ExtSignal:
+            collectSamples<LSL_streamer::extSignal>(stream_);
+            break;
+        case Titta::Stream::TimeSync:
+            collectSamples<LSL_streamer::timeSync>(stream_);
+            break;
+        case Titta::Stream::Positioning:
+            collectSamples<LSL_streamer::positioning>(stream_);
+            break;
+        default:
+            break;
+        }
+    }
+    catch (...)
+    {
+        // inlet or our cursor on it is gone (NB: error may be of any type, depending on
+        // how DoExitWithMsg is implemented). Nothing more can be recorded for this stream
+        stream_.failed = true;
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!force_clock_offset_ && now - stream_.lastClockOffset < defaults::clockOffsetInterval)
+        return;
+    try
+    {
+        // don't wait, the inlet's recorder thread keeps the estimate up to date
+        const double offset = _streamer.getInletTimeCorrection(stream_.inletId, 0.);
+        // collection time is expressed in the remote clock, as offset is subtracted
+        std::string content;
+        put(content, lsl::local_clock() - offset);
+        put(content, offset);
+        enqueue(makeStreamChunk(Tag::ClockOffset, stream_.xdfId, content));
+        stream_.lastClockOffset = now;
+    }
+    catch (...)
+    {
+        // no estimate available (yet), try again next time
+    }
+}
+
+template <typename DataType>
+void XdfRecorder::collectSamples(Stream& stream_)
+{
+    auto samples = _streamer.consumeN<DataType>(stream_.inletId, stream_.cursor);
+    if (samples.empty())
+        return;
+
+    using value_t = decltype(SampleConversion::toLSL(getData(samples.front())));
+    std::string content;
+    content.reserve(sizeof(uint32_t) + 9 + samples.size() * (1 + sizeof(double) + sizeof(value_t)));
+    put(content, stream_.xdfId);
+    putVarLen(content, samples.size());
+    for (const auto& sample : samples)
+    {
+        const double timeStamp = static_cast<double>(sample.remote_system_time_stamp) / 1'000'000.;
+        // each sample has its timestamp (8 bytes), followed by the values of all channels
+        put<uint8_t>(content, sizeof(double));
+        put(content, timeStamp);
+        put(content, SampleConversion::toLSL(getData(sample)));
+    }
+
+    if (!stream_.sampleCount)
+        stream_.firstTimeStamp = static_cast<double>(samples.front().remote_system_time_stamp) / 1'000'000.;
+    stream_.lastTimeStamp = static_cast<double>(samples.back().remote_system_time_stamp) / 1'000'000.;
+    stream_.sampleCount  += samples.size();
+
+    enqueue(makeChunk(Tag::Samples, content), samples.size());
+}
+
+void XdfRecorder::finishStream(Stream& stream_)
+{
+    collect(stream_, true);
+    if (!stream_.failed)
+    {
+        try
+        {
+            _streamer.removeCursor(stream_.inletId, stream_.cursor);
+        }
+        catch (...)
+        {
+            // inlet is gone, and with it the cursor
+        }
+    }
+    enqueue(makeStreamChunk(Tag::StreamFooter, stream_.xdfId, std::format(
+        R"(<?xml version="1.0"?><info><first_timestamp>{}</first_timestamp><last_timestamp>{}</last_timestamp><sample_count>{}</sample_count></info>)",
+        stream_.firstTimeStamp, stream_.lastTimeStamp, stream_.sampleCount)));
+}
+
+void XdfRecorder::enqueue(std::string&& data_, const size_t numSamples_)
+{
+    _backlogChunks++;
+    _backlogBytes += data_.size();
+    {
+        std::lock_guard l(_queueMutex);
+        _queue.push_back({std::move(data_), numSamples_});
+    }
+    _queueCv.notify_one();
+}
+
+void XdfRecorder::collectorThreadFunc()
+{
+    auto lastBoundary = std::chrono::steady_clock::now();
+    std::unique_lock l(_collectorMutex);
+    while (true)
+    {
+        const bool shouldStop = _collectorCv.wait_for(l, defaults::pollInterval, [this] { return _stopCollector; });
+
+        std::lock_guard sl(_streamsMutex);
+        if (shouldStop)
+        {
+            for (auto& stream : _streams)
+                finishStream(stream);
+            _streams.clear();
+            return;
+        }
+
+        for (auto& stream : _streams)
+            collect(stream, false);
+        // streams whose inlet can no longer be read are finished with what was recorded so far
+        const auto nDropped = std::erase_if(_streams, [this](Stream& s_)
+        {
+            if (!s_.failed)
+                return false;
+            finishStream(s_);
+            return true;
+        });
+        _streamsDropped += nDropped;
+
+        // boundary chunks allow a reader to resync after a corrupted part of the file
+        if (const auto now = std::chrono::steady_clock::now(); now - lastBoundary >= defaults::boundaryInterval)
+        {
+            enqueue(makeChunk(Tag::Boundary, std::string_view(reinterpret_cast<const char*>(boundaryUUID), sizeof(boundaryUUID))));
+            lastBoundary = now;
+        }
+    }
+}
+
+void XdfRecorder::writerThreadFunc()
+{
+    auto windowStart = std::chrono::steady_clock::now();
+    uint64_t windowBytes = 0;
+
+    std::deque<Chunk> batch;
+    std::unique_lock l(_queueMutex);
+    while (true)
+    {
+        _queueCv.wait(l, [this] { return _stopWriter || !_queue.empty(); });
+        if (_queue.empty())
+        {
+            // should stop and nothing left to do
+            if (!_writeFailed && !_file.flush())
+                _writeFailed = true;
+            return;
+        }
+
+        // take all queued chunks, write them without holding the lock
+        batch.swap(_queue);
+        l.unlock();
+        for (auto& chunk : batch)
+        {
+            // once writing failed, the file is unusable: discard instead of letting the backlog grow
+            if (!_writeFailed)
+            {
+                _file.write(chunk.data.data(), static_cast<std::streamsize>(chunk.data.size()));
+                if (_file)
+                {
+                    _bytesWritten   += chunk.data.size();
+                    _samplesWritten += chunk.numSamples;
+                }
+                else
+                    _writeFailed = true;
+            }
+            _backlogBytes   -= chunk.data.size();
+            _backlogChunks--;
+            windowBytes     += chunk.data.size();
+        }
+        batch.clear();
+
+        if (const auto now = std::chrono::steady_clock::now(); now - windowStart >= std::chrono::seconds(1))
+        {
+            _recentThroughput = static_cast<double>(windowBytes) / std::chrono::duration<double>(now - windowStart).count();
+            windowStart = now;
+            windowBytes = 0;
+        }
+        l.lock();
+    }
+}
@@ -0,0 +1,695 @@
+// End-to-end tests of inlets, fed over localhost LSL by outlets in the same
+// process: gaze, external signal and time synchronization outlets of an
+// LSL_streamer connected to the Tobii SDK mock (tobii_research_mock/), and
+// numeric and marker outlets. Samples are checked against what the outlets
+// sent or against what a plain peek of the same inlet returns. Each test makes
+// its own LSL_streamer for its inlets, the outlets are shared.
+// Needs the Tobii SDK mock (LSL_STREAMER_TOBII_MOCK), and takes a few seconds
+// per test, as samples are collected in real time.
+//
+// usage: inletTests [<test name>...]    (default: all tests)
+// Exits with 0 if all tests passed, 1 otherwise.
+#include "LSL_streamer/LSL_streamer.h"
+#include "tobii_research_mock/tobii_research_mock.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <span>
+#include <map>
+#include <filesystem>
+#include <limits>
+#include <variant>
+#include <cstdlib>
+#include <type_traits>
+#include <cmath>
+#include <tuple>
+#include <format>
+
+
+void DoExitWithMsg(std::string errMsg_);
+void RelayMsg(std::string msg_);
+
+namespace
+{
+    using TimeClock = LSLTypes::TimeClock;
+    constexpr size_t allSamples = std::numeric_limits<size_t>::max();
+
+    int numFailed = 0;
+    void check(const bool ok_, const std::string_view what_, const int line_)
+    {
+        if (ok_)
+            return;
+        std::cerr << std::format("  line {}: failed: {}\n", line_, what_);
+        numFailed++;
+    }
+#define CHECK(cond_) check((cond_), #cond_, __LINE__)
+
+    // a directory in the system's temporary directory, removed with its content when done
+    struct TempDir
+    {
+        TempDir()
+        {
+            static int count = 0;
+            path = std::filesystem::temp_directory_path() / std::format("LSL_streamer_tests_{}_{}", std::chrono::system_clock::now().time_since_epoch().count(), count++);
+            std::filesystem::create_directories(path);
+        }
+        ~TempDir()
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+        std::filesystem::path path;
+    };
+
+    // poll until pred_ holds, returns false if it did not within timeout_
+    bool waitFor(const std::function<bool()>& pred_, const std::chrono::milliseconds timeout_ = std::chrono::seconds(10))
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout_;
+        while (!pred_())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+    // the LSL_streamer whose outlets feed the inlets, connected to a mock eye tracker
+    // with fixed seed. External signal and time synchronization run faster than the
+    // mock's defaults, so that tests get a few of them per second
+    constexpr float gazeFrequency = 600.f;
+    LSL_streamer& source()
+    {
+        static auto streamer = []()
+        {
+            TobiiMock::EyeTrackerConfig config;
+            config.address              = "tobii-prp://MOCK-inletTests";
+            config.seed                 = 1;
+            config.gaze.frequency       = gazeFrequency;
+            config.extSignal.frequency  = 20.f;
+            config.timeSync.frequency   = 10.f;
+            auto s = std::make_unique<LSL_streamer>(TobiiMock::addEyeTracker(std::move(config)));
+            for (const auto stream : {Titta::Stream::Gaze, Titta::Stream::ExtSignal, Titta::Stream::TimeSync})
+                if (!s->startOutlet(stream))
+                    DoExitWithMsg(std::format("could not start {} outlet", Titta::streamToString(stream)));
+            return s;
+        }();
+        return *streamer;
+    }
+    std::string sourceID(const Titta::Stream stream_)
+    {
+        return std::format("LSL_streamer:Tobii_{}@{}", Titta::streamToString(stream_), source().getSerialNumber());
+    }
+
+    // whether fun_ reports an error (DoExitWithMsg throws in this program)
+    bool throws(const std::function<void()>& fun_)
+    {
+        try
+        {
+            fun_();
+        }
+        catch (const std::string&)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    // listen to one of the source's outlets until the inlet has at least n_ samples, then stop
+    template <typename DataType>
+    uint32_t collect(LSL_streamer& streamer_, const Titta::Stream stream_, const size_t n_)
+    {
+        const auto id = streamer_.createListener(sourceID(stream_), std::nullopt, true);
+        CHECK(waitFor([&]() { return streamer_.peekN<DataType>(id, n_).size() >= n_; }));
+        streamer_.stopListening(id);
+        return id;
+    }
+
+    bool sameGaze(const LSLTypes::gaze& a_, const LSLTypes::gaze& b_)
+    {
+        return a_.remote_system_time_stamp == b_.remote_system_time_stamp &&
+               a_.local_system_time_stamp  == b_.local_system_time_stamp  &&
+               a_.gazeData.device_time_stamp == b_.gazeData.device_time_stamp &&
+               a_.gazeData.left_eye .gaze_point.position_on_display_area.x == b_.gazeData.left_eye .gaze_point.position_on_display_area.x &&
+               a_.gazeData.right_eye.pupil.diameter                        == b_.gazeData.right_eye.pupil.diameter;
+    }
+    // View: a BufferView or anything else that holds samples
+    template <typename View>
+    bool sameGaze(const View& view_, std::span<const LSLTypes::gaze> samples_)
+    {
+        if (view_.size() != samples_.size())
+            return false;
+        for (size_t i = 0; i < samples_.size(); i++)
+            if (!sameGaze(view_[i], samples_[i]))
+                return false;
+        return true;
+    }
+
+    // views give the same samples as peeks, and keep the inlet alive
+    void testViews()
+    {
+        LSL_streamer s;
+        const auto id  = collect<LSLTypes::gaze>(s, Titta::Stream::Gaze, 200);
+        const auto all = s.peekN<LSLTypes::gaze>(id, allSamples, Titta::BufferSide::Start);
+        CHECK(all.size() >= 200);
+
+        {
+            const auto view = s.peekNView<LSLTypes::gaze>(id, allSamples, Titta::BufferSide::Start);
+            CHECK(view.span().size() == all.size());
+            CHECK(sameGaze(view, all));
+        }
+        {
+            const auto view = s.peekNView<LSLTypes::gaze>(id, 10);
+            CHECK(sameGaze(view, std::span(all).last(10)));
+        }
+        {
+            const auto t0 = all[50].local_system_time_stamp, t1 = all[100].local_system_time_stamp;
+            const auto view = s.peekTimeRangeView<LSLTypes::gaze>(id, t0, t1);
+            CHECK(sameGaze(view, s.peekTimeRange<LSLTypes::gaze>(id, t0, t1)));
+            const auto viewRemote = s.peekTimeRangeView<LSLTypes::gaze>(id, all[50].remote_system_time_stamp, all[100].remote_system_time_stamp, TimeClock::Remote);
+            CHECK(sameGaze(viewRemote, std::span(all).subspan(50, 51)));
+        }
+
+        // after release(), the inlet can be consumed from on this thread
+        auto view = s.peekNView<LSLTypes::gaze>(id, allSamples, Titta::BufferSide::Start);
+        view.release();
+        CHECK(view.empty());
+        CHECK(s.consumeN<LSLTypes::gaze>(id, 10).size() == 10);
+
+        // a view outlives the deletion of its inlet
+        view = s.peekNView<LSLTypes::gaze>(id, allSamples, Titta::BufferSide::Start);
+        s.deleteListener(id);
+        CHECK(sameGaze(view, std::span(all).subspan(10)));
+    }
+
+    // cursors each read all samples once, across partial reads, and the buffer is
+    // reclaimed when all of them are done
+    void testCursors()
+    {
+        LSL_streamer s;
+        const auto id = s.createListener(sourceID(Titta::Stream::Gaze));
+        s.addCursor(id, "a");
+        s.addCursor(id, "b");
+        CHECK((s.getCursors(id) == std::vector<std::string>{"a", "b"}));
+        s.startListening(id);
+        CHECK(waitFor([&]() { return s.peekN<LSLTypes::gaze>(id, 200).size() >= 200; }));
+        s.stopListening(id);
+        const auto all = s.peekN<LSLTypes::gaze>(id, allSamples, Titta::BufferSide::Start);
+
+        const auto a1 = s.consumeN<LSLTypes::gaze>(id, "a", 10);
+        CHECK(sameGaze(a1, std::span(all).first(10)));
+        const auto b  = s.consumeN<LSLTypes::gaze>(id, "b");
+        CHECK(sameGaze(b, all));
+        CHECK(s.consumeN<LSLTypes::gaze>(id, "b").empty());
+        // cursor a still holds back reclamation
+        CHECK(s.peekN<LSLTypes::gaze>(id, allSamples).size() == all.size());
+        // a cursor that does not start from the oldest sample only sees new samples
+        s.addCursor(id, "late", false);
+        CHECK(s.consumeN<LSLTypes::gaze>(id, "late").empty());
+        const auto a2 = s.consumeN<LSLTypes::gaze>(id, "a");
+        CHECK(sameGaze(a2, std::span(all).subspan(10)));
+        CHECK(s.peekN<LSLTypes::gaze>(id, allSamples).empty());
+
+        s.startListening(id);
+        CHECK(waitFor([&]() { return s.peekN<LSLTypes::gaze>(id, 100).size() >= 100; }));
+        s.stopListening(id);
+        const auto late = s.consumeN<LSLTypes::gaze>(id, "late");
+        CHECK(!late.empty() && late.front().remote_system_time_stamp > all.back().remote_system_time_stamp);
+        CHECK(s.consumeN<LSLTypes::gaze>(id, "a").size() == late.size());
+
+        s.removeCursor(id, "late");
+        CHECK((s.getCursors(id) == std::vector<std::string>{"a", "b"}));
+        CHECK(throws([&]() { s.removeCursor(id, "late"); }));
+        CHECK(throws([&]() { s.addCursor(id, "a"); }));
+    }
+
+    // a policy that keeps all samples: cursor reads give what peeks give, without gaps, and
+    // the same as an inlet without budget on the same stream
+    void checkPolicyKeepsSamples(const LSL_streamer::MemoryPolicy policy_)
+    {
+        constexpr size_t budgetSamples = 1000;
+        const TempDir dir;
+        LSL_streamer s;
+        s.setSpillDirectory(dir.path);
+        const auto id  = s.createListener(sourceID(Titta::Stream::Gaze));
+        const auto ref = s.createListener(sourceID(Titta::Stream::Gaze));
+        s.setMemoryBudget(id, budgetSamples * sizeof(LSLTypes::packedGaze), policy_);
+        s.addCursor(id, "c");
+        s.startListening(ref);
+        s.startListening(id);
+        const auto moved = [&]()
+        {
+            const auto stats = s.getMemoryStats(id);
+            return policy_ == LSL_streamer::MemoryPolicy::SpillToDisk ? stats.bytesSpilled : stats.bytesCompressed;
+        };
+        CHECK(waitFor([&]() { return moved() > 0; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        s.stopListening(id);
+        s.stopListening(ref);
+
+        const auto all = s.peekN<LSLTypes::gaze>(id, allSamples, Titta::BufferSide::Start);
+        CHECK(all.size() > budgetSamples);
+        CHECK(s.getMemoryStats(id).bytesUsed <= budgetSamples * sizeof(LSLTypes::packedGaze));
+        CHECK(sameGaze(s.consumeN<LSLTypes::gaze>(id, "c"), all));
+        const auto period = static_cast<int64_t>(1'000'000 / gazeFrequency);
+        bool gapless = true;
+        for (size_t i = 1; i < all.size(); i++)
+            gapless &= all[i].gazeData.device_time_stamp - all[i - 1].gazeData.device_time_stamp < period * 3 / 2;
+        CHECK(gapless);
+
+        std::map<int64_t, LSLTypes::gaze> refSamples;
+        for (const auto& r : s.peekN<LSLTypes::gaze>(ref, allSamples, Titta::BufferSide::Start))
+            refSamples.emplace(r.remote_system_time_stamp, r);
+        size_t matched = 0, mismatched = 0;
+        for (const auto& a : all)
+            if (const auto it = refSamples.find(a.remote_system_time_stamp); it != refSamples.end())
+            {
+                const auto& r = it->second;
+                matched++;
+                // NB: the inlets' local timestamps differ by their own time correction
+                mismatched += r.gazeData.device_time_stamp != a.gazeData.device_time_stamp ||
+                              r.gazeData.left_eye .gaze_point.position_on_display_area.x != a.gazeData.left_eye .gaze_point.position_on_display_area.x ||
+                              r.gazeData.right_eye.pupil.diameter                        != a.gazeData.right_eye.pupil.diameter;
+            }
+        CHECK(matched > all.size() / 2);
+        CHECK(mismatched == 0);
+    }
+
+    // memory budgets per inlet and for all inlets together, and each of their policies
+    void testBudgets()
+    {
+        constexpr size_t budget = 200 * sizeof(LSLTypes::packedGaze);
+        {
+            LSL_streamer s;
+            const auto id = s.createListener(sourceID(Titta::Stream::Gaze));
+            s.setMemoryBudget(id, budget, LSL_streamer::MemoryPolicy::DropOldest);
+            s.startListening(id);
+            CHECK(waitFor([&]() { return s.getMemoryStats(id).samplesDropped > 0; }));
+            s.stopListening(id);
+            const auto stats = s.getMemoryStats(id);
+            CHECK(stats.bytesUsed <= budget);
+            CHECK(stats.highWaterMark <= budget);
+            CHECK(!stats.ingestStopped);
+        }
+        {
+            LSL_streamer s;
+            const auto id = s.createListener(sourceID(Titta::Stream::Gaze));
+            s.setMemoryBudget(id, budget, LSL_streamer::MemoryPolicy::StopIngest);
+            s.startListening(id);
+            CHECK(waitFor([&]() { return s.getMemoryStats(id).ingestStopped; }));
+            CHECK(s.getMemoryStats(id).bytesUsed <= budget);
+            CHECK(s.getMemoryStats(id).samplesDropped > 0);
+            // once there is room again, samples are stored again
+            const auto oldest = s.consumeN<LSLTypes::gaze>(id);
+            CHECK(waitFor([&]() { const auto n = s.peekN<LSLTypes::gaze>(id); return !n.empty() && n.back().remote_system_time_stamp > oldest.back().remote_system_time_stamp; }));
+            s.stopListening(id);
+        }
+        checkPolicyKeepsSamples(LSL_streamer::MemoryPolicy::SpillToDisk);
+        checkPolicyKeepsSamples(LSL_streamer::MemoryPolicy::Compress);
+        {
+            LSL_streamer s;
+            s.setGlobalMemoryBudget(budget, LSL_streamer::MemoryPolicy::DropOldest);
+            const auto gazeId = s.createListener(sourceID(Titta::Stream::Gaze), std::nullopt, true);
+            const auto extId  = s.createListener(sourceID(Titta::Stream::ExtSignal), std::nullopt, true);
+            CHECK(waitFor([&]() { return s.getGlobalMemoryStats().samplesDropped > 0; }));
+            s.stopListening(gazeId);
+            s.stopListening(extId);
+            const auto stats = s.getGlobalMemoryStats();
+            CHECK(stats.bytesUsed <= budget);
+            CHECK(stats.bytesUsed == s.getMemoryStats(gazeId).bytesUsed + s.getMemoryStats(extId).bytesUsed);
+        }
+    }
+
+    // numeric outlets and inlets: values and timestamps arrive as pushed
+    void testNumeric()
+    {
+        constexpr size_t N = 100;
+        LSL_streamer s;
+        const auto now = Titta::getSystemTimestamp();
+        std::vector<int64_t> ts(N);
+        for (size_t i = 0; i < N; i++)
+            ts[i] = now - 200'000 + static_cast<int64_t>(i) * 1000;
+        const auto sameTimes = [](std::span<const int64_t> got_, std::span<const int64_t> sent_)
+        {
+            // timestamps are sent in seconds (double), allow for rounding
+            return got_.size() == sent_.size() && std::ranges::equal(got_, sent_, [](const int64_t a_, const int64_t b_) { return std::abs(a_ - b_) <= 1; });
+        };
+
+        {
+            constexpr size_t nCh = 3;
+            const auto out = s.createNumericOutlet("inletTests_float", "Test", nCh, lsl::cf_float32, 1000., "LSL_streamer:inletTests_float");
+            const auto id  = s.createListener("LSL_streamer:inletTests_float", std::nullopt, true);
+            CHECK(s.getInletType(id) == Titta::Stream::Unknown);
+            CHECK(!s.isMarkerInlet(id));
+            std::vector<float> data(N * nCh);
+            for (size_t i = 0; i < data.size(); i++)
+                data[i] = static_cast<float>(i / nCh) + static_cast<float>(i % nCh) * .25f;
+            s.pushNumericChunk<float>(out, data, ts);
+            CHECK(waitFor([&]() { return s.peekNumericN(id, N).size() == N; }));
+            s.stopListening(id);
+
+            const auto got = s.consumeNumericN(id);
+            CHECK(got.numChannels == nCh);
+            CHECK(sameTimes(got.remoteTimeStamps, ts));
+            CHECK(got.localTimeStamps.size() == N);
+            CHECK(std::holds_alternative<std::vector<float>>(got.values) && std::get<std::vector<float>>(got.values) == data);
+            CHECK(s.peekNumericN(id).empty());
+
+            // pushes must have whole samples, and a timestamp for each
+            CHECK(throws([&]() { s.pushNumericChunk<float>(out, std::span(data).first(nCh + 1)); }));
+            CHECK(throws([&]() { s.pushNumericChunk<float>(out, std::span(data).first(2 * nCh), std::span(ts).first(1)); }));
+            CHECK(throws([&]() { s.addCursor(id, "c"); }));
+            s.deleteOutlet(out);
+        }
+        {
+            constexpr size_t nCh = 2;
+            const auto out = s.createNumericOutlet("inletTests_int", "Test", nCh, lsl::cf_int32, 1000., "LSL_streamer:inletTests_int");
+            const auto id  = s.createListener("LSL_streamer:inletTests_int", std::nullopt, true);
+            std::vector<int32_t> data(N * nCh);
+            for (size_t i = 0; i < data.size(); i++)
+                data[i] = static_cast<int32_t>(i / nCh) * 7 - static_cast<int32_t>(i % nCh);
+            s.pushNumericChunk<int32_t>(out, data, ts);
+            CHECK(waitFor([&]() { return s.peekNumericN(id, N).size() == N; }));
+            s.stopListening(id);
+
+            // samples 10 up to and including 19, by their remote timestamps
+            const auto range = s.peekNumericTimeRange(id, ts[10] - 100, ts[19] + 100, TimeClock::Remote);
+            CHECK(sameTimes(range.remoteTimeStamps, std::span(ts).subspan(10, 10)));
+            CHECK(std::holds_alternative<std::vector<int32_t>>(range.values) &&
+                  std::ranges::equal(std::get<std::vector<int32_t>>(range.values), std::span(data).subspan(10 * nCh, 10 * nCh)));
+            const auto got = s.consumeNumericN(id);
+            CHECK(sameTimes(got.remoteTimeStamps, ts));
+            CHECK(std::holds_alternative<std::vector<int32_t>>(got.values) && std::get<std::vector<int32_t>>(got.values) == data);
+            s.deleteOutlet(out);
+        }
+    }
+
+    // marker outlets and inlets: strings and timestamps arrive as pushed
+    void testMarkers()
+    {
+        LSL_streamer s;
+        const auto out = s.createMarkerOutlet("inletTests_markers", std::nullopt, "LSL_streamer:inletTests_markers");
+        const auto id  = s.createListener("LSL_streamer:inletTests_markers", std::nullopt, true);
+        CHECK(s.isMarkerInlet(id));
+        CHECK(s.getInletType(id) == Titta::Stream::Unknown);
+
+        std::vector<std::string> values;
+        std::vector<int64_t> ts;
+        for (int i = 0; i < 20; i++)
+        {
+            values.push_back(i % 2 ? std::format("trial {} start", i) : "");
+            ts.push_back(s.pushMarker(out, values.back()));
+            // so that each marker has its own timestamp
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        // an explicit timestamp is passed on unchanged
+        values.push_back("explicit");
+        ts.push_back(s.pushMarker(out, values.back(), ts.back() + 1000));
+        CHECK(ts.back() == ts[ts.size() - 2] + 1000);
+        CHECK(waitFor([&]() { return s.peekN<LSLTypes::marker>(id, values.size()).size() == values.size(); }));
+        s.stopListening(id);
+
+        const auto got = s.peekN<LSLTypes::marker>(id, allSamples, Titta::BufferSide::Start);
+        CHECK(got.size() == values.size());
+        bool same = got.size() == values.size();
+        for (size_t i = 0; same && i < got.size(); i++)
+            same = got[i].value == values[i] && std::abs(got[i].remote_system_time_stamp - ts[i]) <= 1;
+        CHECK(same);
+        const auto range = s.peekTimeRange<LSLTypes::marker>(id, ts[5] - 1, ts[9] + 1, TimeClock::Remote);
+        CHECK(range.size() == 5 && range.front().value == values[5]);
+
+        // markers have no device timestamps, and cannot be spilled or compressed
+        CHECK(throws([&]() { (void)s.peekTimeRange<LSLTypes::marker>(id, 0, ts.back(), TimeClock::Device); }));
+        CHECK(throws([&]() { s.setMemoryBudget(id, 1 << 20, LSL_streamer::MemoryPolicy::SpillToDisk); }));
+        CHECK(throws([&]() { s.setMemoryBudget(id, 1 << 20, LSL_streamer::MemoryPolicy::Compress); }));
+        s.setMemoryBudget(id, 1 << 20, LSL_streamer::MemoryPolicy::DropOldest);
+
+        CHECK(s.consumeN<LSLTypes::marker>(id).size() == values.size());
+        CHECK(s.getMemoryStats(id).bytesUsed == 0);
+    }
+
+    // time ranges of multiple inlets taken together, up to their watermark
+    void testMulti()
+    {
+        using gazes = std::vector<LSLTypes::gaze>;
+        {
+            // an external signal stream that has gone quiet does not hold back the watermark
+            LSL_streamer s;
+            const std::vector ids{s.createListener(sourceID(Titta::Stream::Gaze), std::nullopt, true), s.createListener(sourceID(Titta::Stream::ExtSignal), std::nullopt, true)};
+            CHECK(waitFor([&]() { return !s.peekN<LSLTypes::extSignal>(ids[1]).empty(); }));
+            s.stopListening(ids[1]);
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            s.stopListening(ids[0]);
+            const auto gazeNewest = s.peekN<LSLTypes::gaze>(ids[0]).back().local_system_time_stamp;
+            CHECK(s.peekN<LSLTypes::extSignal>(ids[1]).back().local_system_time_stamp < gazeNewest);
+
+            const auto bundle = s.peekTimeRangeMulti(ids);
+            CHECK(bundle.timeEnd == gazeNewest);
+            CHECK(bundle.samples.size() == 2);
+            CHECK(std::get<gazes>(bundle.samples[0]).size() == s.peekN<LSLTypes::gaze>(ids[0], allSamples).size());
+            CHECK(std::get<std::vector<LSLTypes::extSignal>>(bundle.samples[1]).size() == s.peekN<LSLTypes::extSignal>(ids[1], allSamples).size());
+        }
+        {
+            // a regular rate numeric stream that lags behind the gaze does
+            LSL_streamer s;
+            const auto out = s.createNumericOutlet("inletTests_multi", "Test", 1, lsl::cf_double64, 100., "LSL_streamer:inletTests_multi");
+            const std::vector ids{s.createListener(sourceID(Titta::Stream::Gaze), std::nullopt, true), s.createListener("LSL_streamer:inletTests_multi", std::nullopt, true)};
+            constexpr size_t N = 50;
+            const auto now = Titta::getSystemTimestamp();
+            std::vector<int64_t> ts(N);
+            std::vector<double>  data(N);
+            for (size_t i = 0; i < N; i++)
+            {
+                ts[i]   = now - 500'000 + static_cast<int64_t>(i) * 10'000;
+                data[i] = static_cast<double>(i);
+            }
+            s.pushNumericChunk<double>(out, data, ts);
+            CHECK(waitFor([&]() { return s.peekNumericN(ids[1], N).size() == N; }));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            s.stopListening(ids[0]);
+            s.stopListening(ids[1]);
+            const auto numNewest = s.peekNumericN(ids[1]).localTimeStamps.back();
+            CHECK(numNewest < s.peekN<LSLTypes::gaze>(ids[0]).back().local_system_time_stamp);
+
+            const auto bundle = s.consumeTimeRangeMulti(ids);
+            CHECK(bundle.timeEnd == numNewest);
+            const auto& g = std::get<gazes>(bundle.samples[0]);
+            CHECK(!g.empty() && std::ranges::all_of(g, [&](const auto& s_) { return s_.local_system_time_stamp <= numNewest; }));
+            CHECK(std::get<LSL_streamer::NumericSamples>(bundle.samples[1]).size() == N);
+
+            // the next call continues where this one stopped
+            const auto again = s.consumeTimeRangeMulti(ids);
+            CHECK(again.timeEnd == numNewest);
+            CHECK(std::get<gazes>(again.samples[0]).empty());
+            CHECK(std::get<LSL_streamer::NumericSamples>(again.samples[1]).empty());
+
+            // without watermark, the gaze after it is taken too
+            const auto snapshot = s.peekTimeRangeMulti(ids, std::nullopt, std::nullopt, std::nullopt, false);
+            CHECK(snapshot.timeEnd == std::numeric_limits<int64_t>::max());
+            const auto& rest = std::get<gazes>(snapshot.samples[0]);
+            CHECK(!rest.empty() && rest.front().local_system_time_stamp > numNewest);
+            CHECK(rest.size() == s.peekN<LSLTypes::gaze>(ids[0], allSamples).size());
+
+            // each inlet may only be given once
+            CHECK(throws([&]() { (void)s.peekTimeRangeMulti(std::vector{ids[0], ids[0]}); }));
+            s.deleteOutlet(out);
+        }
+    }
+
+    // gaze joined with the most recent external signal and time synchronization, against a brute-force join
+    void testAsOf()
+    {
+        LSL_streamer s;
+        const auto gazeId = s.createListener(sourceID(Titta::Stream::Gaze), std::nullopt, true);
+        const auto extId  = s.createListener(sourceID(Titta::Stream::ExtSignal), std::nullopt, true);
+        const auto tsId   = s.createListener(sourceID(Titta::Stream::TimeSync), std::nullopt, true);
+        CHECK(waitFor([&]() { return s.peekN<LSLTypes::extSignal>(extId, 5).size() >= 5 && s.peekN<LSLTypes::timeSync>(tsId, 3).size() >= 3; }));
+        for (const auto id : {extId, tsId, gazeId})
+            s.stopListening(id);
+        const auto gaze       = s.peekN<LSLTypes::gaze>     (gazeId, allSamples, Titta::BufferSide::Start);
+        const auto extSignals = s.peekN<LSLTypes::extSignal>(extId , allSamples, Titta::BufferSide::Start);
+        const auto timeSyncs  = s.peekN<LSLTypes::timeSync> (tsId  , allSamples, Titta::BufferSide::Start);
+        CHECK(gaze.size() > 200);
+
+        // newest of signals_ at or before t_, if any
+        const auto latest = [](const auto& signals_, const int64_t t_, const TimeClock clock_)
+        {
+            const std::remove_cvref_t<decltype(signals_[0])>* out = nullptr;
+            for (const auto& sig : signals_)
+                if (LSLTypes::getTimeStamp(sig, clock_) <= t_ && (!out || LSLTypes::getTimeStamp(sig, clock_) >= LSLTypes::getTimeStamp(*out, clock_)))
+                    out = &sig;
+            return out;
+        };
+        const auto checkJoin = [&](const int64_t t0_, const int64_t t1_, const TimeClock clock_)
+        {
+            const auto got = s.peekGazeWithSignals(gazeId, extId, tsId, t0_, t1_, clock_);
+            const auto expected = s.peekTimeRange<LSLTypes::gaze>(gazeId, t0_, t1_, clock_);
+            CHECK(sameGaze(got.samples, expected));
+            CHECK(got.extSignalValue.size() == expected.size() && got.extSignalTimeStamp.size() == expected.size() && got.timeSyncRoundTrip.size() == expected.size());
+            size_t numWrong = 0, numJoined = 0;
+            for (size_t i = 0; i < std::min(got.samples.size(), got.timeSyncRoundTrip.size()); i++)
+            {
+                const auto t   = LSLTypes::getTimeStamp(got.samples[i], clock_);
+                const auto ext = latest(extSignals, t, clock_);
+                const auto ts  = latest(timeSyncs , t, clock_);
+                numJoined += ext && ts;
+                numWrong  += got.extSignalValue[i]     != (ext ? ext->extSignalData.value : 0u) ||
+                             got.extSignalTimeStamp[i] != (ext ? LSLTypes::getTimeStamp(*ext, clock_) : -1) ||
+                             got.timeSyncRoundTrip[i]  != (ts  ? ts->timeSyncData.system_response_time_stamp - ts->timeSyncData.system_request_time_stamp : -1);
+            }
+            CHECK(numJoined > 0);
+            CHECK(numWrong == 0);
+        };
+        checkJoin(0, std::numeric_limits<int64_t>::max(), TimeClock::Local);
+        checkJoin(gaze[gaze.size() / 2].local_system_time_stamp , gaze.back().local_system_time_stamp , TimeClock::Local);
+        checkJoin(gaze[gaze.size() / 2].remote_system_time_stamp, gaze.back().remote_system_time_stamp, TimeClock::Remote);
+
+        // without time sync inlet
+        const auto noTimeSync = s.peekGazeWithSignals(gazeId, extId);
+        CHECK(noTimeSync.samples.size() == gaze.size());
+        CHECK(noTimeSync.timeSyncRoundTrip.empty());
+    }
+
+    // gaze and numeric inlets resampled onto a common grid, against interpolating by hand
+    void testResample()
+    {
+        LSL_streamer s;
+        const auto out = s.createNumericOutlet("inletTests_ramp", "Test", 1, lsl::cf_float32, 100., "LSL_streamer:inletTests_ramp");
+        const std::vector ids{s.createListener(sourceID(Titta::Stream::Gaze), std::nullopt, true), s.createListener("LSL_streamer:inletTests_ramp", std::nullopt, true)};
+        constexpr size_t N = 100;
+        const auto now = Titta::getSystemTimestamp();
+        std::vector<int64_t> ts(N);
+        std::vector<float>   ramp(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            ts[i]   = now - 1'000'000 + static_cast<int64_t>(i) * 10'000;
+            ramp[i] = static_cast<float>(i) * .5f;
+        }
+        s.pushNumericChunk<float>(out, ramp, ts);
+        CHECK(waitFor([&]() { return s.peekNumericN(ids[1], N).size() == N && s.peekN<LSLTypes::gaze>(ids[0], 300).size() == 300; }));
+        s.stopListening(ids[0]);
+        s.stopListening(ids[1]);
+        const auto gaze = s.peekN<LSLTypes::gaze>(ids[0], allSamples, Titta::BufferSide::Start);
+        const auto num  = s.peekNumericN(ids[1], allSamples, Titta::BufferSide::Start);
+        const auto& numTimes = num.localTimeStamps;
+
+        constexpr double rate = 200.;
+        const auto t0 = numTimes.front() - 500'000, t1 = gaze.back().local_system_time_stamp + 100'000;
+        const auto r  = s.resample(ids, rate, t0, t1);
+        const auto n  = r.timeStamps.size();
+        CHECK(n > 0);
+        if (!n)
+            return;
+        // the grid only covers the extent of the samples
+        CHECK(r.timeStamps.front() >= std::min(numTimes.front(), gaze.front().local_system_time_stamp));
+        CHECK(r.timeStamps.back()  <= std::max(numTimes.back() , gaze.back() .local_system_time_stamp));
+        // grid points are whole periods from t0, rounded to us
+        constexpr auto period = static_cast<int64_t>(1'000'000. / rate);
+        bool regular = (r.timeStamps.front() - t0) % period == 0;
+        for (size_t k = 1; k < n; k++)
+            regular &= r.timeStamps[k] - r.timeStamps[k - 1] == period;
+        CHECK(regular);
+
+        CHECK(r.streams.size() == 2);
+        if (r.streams.size() != 2)
+            return;
+        const auto& g = r.streams[0];
+        const auto& v = r.streams[1];
+        constexpr auto numGazeChannels = std::tuple_size_v<decltype(LSLTypes::packedGaze::values)>;
+        CHECK(g.numChannels == numGazeChannels);
+        CHECK(g.values.size() == numGazeChannels * n && g.flags.size() == n);
+        CHECK(v.numChannels == 1);
+        CHECK(v.values.size() == n && v.flags.empty());
+        if (g.values.size() != numGazeChannels * n || g.flags.size() != n || v.values.size() != n)
+            return;
+
+        size_t numWrong = 0, numInside = 0;
+        for (size_t k = 0; k < n; k++)
+        {
+            const auto t = r.timeStamps[k];
+            // numeric: linear between the ramp's samples, NaN outside them
+            if (t < numTimes.front() || t > numTimes.back())
+                numWrong += !std::isnan(v.values[k]);
+            else
+            {
+                numInside++;
+                const auto j = static_cast<size_t>(std::ranges::upper_bound(numTimes, t) - numTimes.begin()) - 1;
+                const auto expected = j + 1 == N ? static_cast<double>(ramp[j]) :
+                    ramp[j] + (static_cast<double>(ramp[j + 1]) - ramp[j]) * static_cast<double>(t - numTimes[j]) / static_cast<double>(numTimes[j + 1] - numTimes[j]);
+                numWrong += !(std::abs(v.values[k] - expected) < 1e-4);
+            }
+            // gaze: all samples are valid, values and flags within the samples, NaN and 0 outside
+            const auto inGaze = t >= gaze.front().local_system_time_stamp && t <= gaze.back().local_system_time_stamp;
+            const auto x = g.values[k * numGazeChannels + LSLTypes::packedGaze::gazePointOnDisplayArea];
+            numWrong += inGaze ? std::isnan(x) || !g.flags[k] : !std::isnan(x) || g.flags[k];
+        }
+        CHECK(numInside > 150);
+        CHECK(numWrong == 0);
+
+        CHECK(throws([&]() { (void)s.resample(ids, 0., t0, t1); }));
+        CHECK(throws([&]() { (void)s.resample(ids, rate, t1, t0); }));
+        s.deleteOutlet(out);
+    }
+
+    const std::vector<std::pair<std::string_view, std::function<void()>>> tests = {
+        {"views",           testViews},
+        {"cursors",         testCursors},
+        {"budgets",         testBudgets},
+        {"numeric",         testNumeric},
+        {"markers",         testMarkers},
+        {"multi",           testMulti},
+        {"asOf",            testAsOf},
+        {"resample",        testResample},
+    };
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const std::vector<std::string_view> selected(argv + 1, argv + argc);
+        int numTestsFailed = 0;
+        for (const auto& [name, test] : tests)
+        {
+            if (!selected.empty() && std::ranges::find(selected, name) == selected.end())
+                continue;
+            const auto before = numFailed;
+            test();
+            const auto ok = numFailed == before;
+            numTestsFailed += !ok;
+            std::cout << std::format("{:<16} {}", name, ok ? "ok" : "FAILED") << std::endl;
+        }
+        return numTestsFailed ? 1 : 0;
+    }
+    catch (const std::string& e)
+    {
+        std::cerr << "Error: " << e << std::endl;
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Error: Some exception occurred" << std::endl;
+        return 1;
+    }
+}
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw errMsg_;
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
@@ -0,0 +1,850 @@
+// Round-trip and edge-case tests for the storage code behind inlets and
+// recordings: the column codecs (src/column_codec.h), the columnar block
+// layout (src/sample_columns.h), the native recording format
+// (LSL_streamer/recording.h), XDF chunk encoding (src/xdf_chunks.h), the time
+// index (src/time_index.h), the older tiers of the Compress and SpillToDisk
+// memory policies (src/compressed_store.h, src/spill_store.h) and the inlet
+// registry (LSL_streamer/inlet_registry.h). Time range searches are checked
+// against a linear scan, also for timestamps that step back.
+// Needs no eye tracker or LSL network. Files are written to the system's
+// temporary directory and removed afterwards.
+//
+// usage: storageTests [<test name>...]    (default: all tests)
+// Exits with 0 if all tests passed, 1 otherwise.
+#include "LSL_streamer/LSL_streamer.h"
+#include "LSL_streamer/recording.h"
+#include "LSL_streamer/inlet_registry.h"
+#include "src/column_codec.h"
+#include "src/sample_columns.h"
+#include "src/xdf_chunks.h"
+#include "src/time_index.h"
+#include "src/compressed_store.h"
+#include "src/spill_store.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <format>
+
+
+void DoExitWithMsg(std::string errMsg_);
+void RelayMsg(std::string msg_);
+
+namespace
+{
+    using TimeClock = LSLTypes::TimeClock;
+
+    int numFailed = 0;
+    void check(const bool ok_, const std::string_view what_, const int line_)
+    {
+        if (ok_)
+            return;
+        std::cerr << std::format("  line {}: failed: {}\n", line_, what_);
+        numFailed++;
+    }
+#define CHECK(cond_) check((cond_), #cond_, __LINE__)
+
+    // a directory in the system's temporary directory, removed with its content when done
+    struct TempDir
+    {
+        TempDir()
+        {
+            static int count = 0;
+            path = std::filesystem::temp_directory_path() / std::format("LSL_streamer_tests_{}_{}", std::chrono::system_clock::now().time_since_epoch().count(), count++);
+            std::filesystem::create_directories(path);
+        }
+        ~TempDir()
+        {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+        std::filesystem::path path;
+    };
+
+    int64_t localOf(const int64_t remote_) { return 10'000'000 - remote_; }
+    // samples with the given remote timestamps. Local timestamps run backward,
+    // and device timestamps are offset, so that the clocks cannot be mixed up
+    std::vector<LSLTypes::extSignal> makeSamples(std::span<const int64_t> times_)
+    {
+        std::vector<LSLTypes::extSignal> out(times_.size());
+        for (size_t i = 0; i < times_.size(); i++)
+        {
+            std::memset(&out[i], 0, sizeof(out[i]));
+            out[i].extSignalData.device_time_stamp = times_[i] + 1'000'000;
+            out[i].extSignalData.system_time_stamp = times_[i];
+            out[i].extSignalData.value             = static_cast<uint32_t>(i % 7);
+            out[i].remote_system_time_stamp        = times_[i];
+            out[i].local_system_time_stamp         = localOf(times_[i]);
+        }
+        return out;
+    }
+    // mostly increasing timestamps that now and then step back
+    std::vector<int64_t> makeTimes(std::mt19937& rng_, const size_t n_, int64_t& t_)
+    {
+        std::vector<int64_t> out(n_);
+        for (auto& t : out)
+        {
+            t_ += rng_() % 10 == 0 ? -static_cast<int64_t>(rng_() % 50) : static_cast<int64_t>(rng_() % 7);
+            t   = t_;
+        }
+        return out;
+    }
+    bool sameSamples(std::span<const LSLTypes::extSignal> a_, std::span<const LSLTypes::extSignal> b_)
+    {
+        return std::ranges::equal(a_, b_, [](const LSLTypes::extSignal& x_, const LSLTypes::extSignal& y_)
+        {
+            return x_.remote_system_time_stamp == y_.remote_system_time_stamp &&
+                   x_.local_system_time_stamp  == y_.local_system_time_stamp &&
+                   x_.extSignalData.device_time_stamp == y_.extSignalData.device_time_stamp &&
+                   x_.extSignalData.value             == y_.extSignalData.value;
+        });
+    }
+
+    // reference semantics of a time range search (see src/time_index.h)
+    template <typename DataType>
+    size_t firstAtOrAfterScan(std::span<const DataType> samples_, const int64_t time_, const TimeClock clock_)
+    {
+        const auto it = std::ranges::find_if(samples_, [&](const DataType& s_) { return LSLTypes::getTimeStamp(s_, clock_) >= time_; });
+        return it - samples_.begin();
+    }
+    template <typename DataType>
+    size_t pastLastAtOrBeforeScan(std::span<const DataType> samples_, const int64_t time_, const TimeClock clock_)
+    {
+        for (auto i = samples_.size(); i-- > 0;)
+            if (LSLTypes::getTimeStamp(samples_[i], clock_) <= time_)
+                return i + 1;
+        return 0;
+    }
+
+
+    // ColumnCodec
+    std::vector<int64_t> intsRoundTrip(std::span<const int64_t> values_, bool& ok_)
+    {
+        std::vector<uint8_t> enc;
+        ColumnCodec::encodeInts(values_, enc);
+        std::vector<int64_t> out(values_.size());
+        const auto* in = enc.data();
+        ok_ = ColumnCodec::decodeInts(in, enc.data() + enc.size(), out) && in == enc.data() + enc.size();
+        return out;
+    }
+    void testInts()
+    {
+        constexpr auto mn = std::numeric_limits<int64_t>::min(), mx = std::numeric_limits<int64_t>::max();
+        const std::vector<std::vector<int64_t>> cases = {
+            {},
+            {42},
+            {-1},
+            {100, 90, 80, 85, -1000, -2000},                // decreasing
+            {mn, mx, mn, 0, mx, mx, -1, 1},                 // extremes, deltas that wrap around
+            {0, 1'000'000'000'000, 0, 1'000'000'000'000},
+        };
+        for (const auto& c : cases)
+        {
+            bool ok;
+            const auto out = intsRoundTrip(c, ok);
+            CHECK(ok);
+            CHECK(out == c);
+        }
+
+        // a regular clock costs one byte per sample after the first two
+        std::vector<int64_t> regular(1000);
+        for (size_t i = 0; i < regular.size(); i++)
+            regular[i] = 1'700'000'000'000'000 + static_cast<int64_t>(i) * 8333;
+        std::vector<uint8_t> enc;
+        ColumnCodec::encodeInts(regular, enc);
+        std::vector<uint8_t> firstTwo;
+        ColumnCodec::encodeInts(std::span(regular).first(2), firstTwo);
+        CHECK(enc.size() == firstTwo.size() + regular.size() - 2);
+
+        // truncated input is refused, without reading past its end
+        std::vector<int64_t> out(regular.size());
+        for (const auto n : {size_t{0}, size_t{1}, enc.size() - 1})
+        {
+            const auto* in = enc.data();
+            CHECK(!ColumnCodec::decodeInts(in, enc.data() + n, out));
+            CHECK(in <= enc.data() + n);
+        }
+        // no values needs no input
+        const uint8_t* in = nullptr;
+        CHECK(ColumnCodec::decodeInts(in, nullptr, std::span<int64_t>()));
+    }
+
+    void testBits()
+    {
+        // fields of every width, not aligned to bytes
+        std::mt19937_64 rng(2);
+        std::vector<std::pair<uint64_t, int>> fields;
+        for (int rep = 0; rep < 3; rep++)
+            for (int w = 1; w <= 64; w++)
+                fields.emplace_back(w == 64 ? rng() : rng() & ((uint64_t{1} << w) - 1), w);
+        std::vector<uint8_t> buf;
+        size_t numBits = 0;
+        {
+            ColumnCodec::BitWriter bw(buf);
+            for (const auto& [v, w] : fields)
+            {
+                bw.put(v | (w < 64 ? ~uint64_t{0} << w : 0), w);     // NB: bits above the width must be ignored
+                numBits += w;
+            }
+        }
+        CHECK(buf.size() == (numBits + 7) / 8);
+
+        const auto* in = buf.data();
+        ColumnCodec::BitReader br(in, buf.data() + buf.size());
+        bool allOk = true;
+        for (const auto& [v, w] : fields)
+        {
+            uint64_t got;
+            allOk = allOk && br.get(got, w) && got == v;
+        }
+        CHECK(allOk);
+        // only padding is left
+        uint64_t got;
+        CHECK(!br.get(got, 8));
+
+        // empty input
+        std::vector<uint8_t> empty;
+        {
+            ColumnCodec::BitWriter bw(empty);
+        }
+        CHECK(empty.empty());
+        const auto* e = empty.data();
+        ColumnCodec::BitReader er(e, e);
+        CHECK(!er.get(got, 1));
+    }
+
+    template <typename T>
+    void testFloatsOf()
+    {
+        constexpr auto inf = std::numeric_limits<T>::infinity();
+        const std::vector<std::vector<T>> cases = {
+            {},
+            {T(1.5)},
+            {T(0), T(-0.0), T(0), T(-0.0)},
+            {std::numeric_limits<T>::quiet_NaN(), inf, -inf, std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()},
+            {T(3.25), T(3.25), T(3.25), T(3.5), T(3.25), T(-3.25)},     // repeats
+            {T(1e-30), T(1e30), T(-1e-30), T(123.456), T(0.1)},
+        };
+        for (const auto& c : cases)
+        {
+            std::vector<uint8_t> enc;
+            ColumnCodec::encodeFloats<T>(c, enc);
+            std::vector<T> out(c.size());
+            const auto* in = enc.data();
+            CHECK(ColumnCodec::decodeFloats<T>(in, enc.data() + enc.size(), out));
+            // bitwise, so that NaN and the sign of zero are checked too
+            const auto bits = [](const T v_) { return std::bit_cast<ColumnCodec::bits_t<T>>(v_); };
+            CHECK(std::ranges::equal(out, c, {}, bits, bits));
+        }
+
+        // repeats cost a bit each
+        std::vector<T> constant(800, T(2.75));
+        std::vector<uint8_t> enc;
+        ColumnCodec::encodeFloats<T>(constant, enc);
+        CHECK(enc.size() <= sizeof(T) + 2 + constant.size() / 8);
+
+        // truncated input is refused
+        std::vector<T> varied(100);
+        for (size_t i = 0; i < varied.size(); i++)
+            varied[i] = std::sin(static_cast<T>(i));
+        enc.clear();
+        ColumnCodec::encodeFloats<T>(varied, enc);
+        const auto* in = enc.data();
+        CHECK(!ColumnCodec::decodeFloats<T>(in, enc.data() + enc.size() / 2, std::span(varied)));
+    }
+    void testFloats()
+    {
+        testFloatsOf<float>();
+        testFloatsOf<double>();
+    }
+
+
+    // SampleColumns
+    template <typename DataType, typename Fill, typename Equal>
+    void checkBlockRoundTrip(const size_t n_, Fill fill_, Equal equal_)
+    {
+        std::vector<DataType> in(n_);
+        for (size_t i = 0; i < n_; i++)
+        {
+            std::memset(&in[i], 0, sizeof(in[i]));
+            fill_(in[i], i);
+        }
+        std::vector<uint8_t> block;
+        SampleColumns::encodeBlock<DataType>(in, block);
+        std::vector<DataType> out;
+        CHECK(SampleColumns::decodeBlock<DataType>(block, n_, out));
+        CHECK(out.size() == n_);
+        CHECK(std::ranges::equal(in, out, equal_));
+
+        for (const auto clock : {TimeClock::Remote, TimeClock::Local})
+        {
+            std::vector<int64_t> ts;
+            CHECK(SampleColumns::decodeTimeStamps<DataType>(block, n_, clock == TimeClock::Local, ts));
+            CHECK(std::ranges::equal(ts, in, {}, {}, [clock](const DataType& s_) { return LSLTypes::getTimeStamp(s_, clock); }));
+        }
+
+        // a block cut short is refused
+        if (!block.empty())
+        {
+            std::vector<DataType> bad;
+            CHECK(!SampleColumns::decodeBlock<DataType>(std::span(block).first(block.size() - 1), n_, bad));
+        }
+    }
+    void testSampleColumns()
+    {
+        auto stamp = [](auto& s_, const size_t i_)
+        {
+            // decreasing now and then
+            const auto t = 1'000'000 + static_cast<int64_t>(i_) * 8333 - (i_ % 5 == 4 ? 20'000 : 0);
+            s_.remote_system_time_stamp = t;
+            s_.local_system_time_stamp  = t + 17 - static_cast<int64_t>(i_ % 3);
+            return t;
+        };
+        for (const size_t n : {0, 1, 2, 100})
+        {
+            checkBlockRoundTrip<LSLTypes::gaze>(n, [&](LSLTypes::gaze& s_, const size_t i_)
+                {
+                    const auto t = stamp(s_, i_);
+                    s_.gazeData.system_time_stamp                            = t;
+                    s_.gazeData.device_time_stamp                            = 5'000'000'123 + static_cast<int64_t>(i_) * 8333;
+                    s_.gazeData.left_eye.pupil.diameter                      = 3.f + static_cast<float>(i_) * 0.01f;
+                    s_.gazeData.right_eye.gaze_point.position_on_display_area.x = 0.5f - static_cast<float>(i_) * 0.001f;
+                },
+                [](const LSLTypes::gaze& a_, const LSLTypes::gaze& b_)
+                {
+                    return a_.remote_system_time_stamp == b_.remote_system_time_stamp && a_.local_system_time_stamp == b_.local_system_time_stamp &&
+                           a_.gazeData.system_time_stamp == b_.gazeData.system_time_stamp && a_.gazeData.device_time_stamp == b_.gazeData.device_time_stamp &&
+                           a_.gazeData.left_eye.pupil.diameter == b_.gazeData.left_eye.pupil.diameter &&
+                           a_.gazeData.right_eye.gaze_point.position_on_display_area.x == b_.gazeData.right_eye.gaze_point.position_on_display_area.x;
+                });
+            checkBlockRoundTrip<LSLTypes::packedGaze>(n, [&](LSLTypes::packedGaze& s_, const size_t i_)
+                {
+                    stamp(s_, i_);
+                    s_.device_time_stamp = 5'000'000'123 + static_cast<int64_t>(i_) * 8333;
+                    s_.values[LSLTypes::packedGaze::pupilDiameter] = 3.f + static_cast<float>(i_) * 0.01f;
+                },
+                [](const LSLTypes::packedGaze& a_, const LSLTypes::packedGaze& b_)
+                {
+                    return a_.remote_system_time_stamp == b_.remote_system_time_stamp && a_.local_system_time_stamp == b_.local_system_time_stamp &&
+                           a_.device_time_stamp == b_.device_time_stamp &&
+                           a_.values[LSLTypes::packedGaze::pupilDiameter] == b_.values[LSLTypes::packedGaze::pupilDiameter];
+                });
+            checkBlockRoundTrip<LSLTypes::extSignal>(n, [&](LSLTypes::extSignal& s_, const size_t i_)
+                {
+                    const auto t = stamp(s_, i_);
+                    s_.extSignalData.system_time_stamp = t;
+                    s_.extSignalData.device_time_stamp = t + 123;
+                    s_.extSignalData.value             = static_cast<uint32_t>(i_ * 31);
+                },
+                [](const LSLTypes::extSignal& a_, const LSLTypes::extSignal& b_)
+                {
+                    return a_.remote_system_time_stamp == b_.remote_system_time_stamp && a_.local_system_time_stamp == b_.local_system_time_stamp &&
+                           a_.extSignalData.device_time_stamp == b_.extSignalData.device_time_stamp && a_.extSignalData.value == b_.extSignalData.value;
+                });
+            checkBlockRoundTrip<LSLTypes::timeSync>(n, [&](LSLTypes::timeSync& s_, const size_t i_)
+                {
+                    const auto t = stamp(s_, i_);
+                    s_.timeSyncData.system_request_time_stamp  = t;
+                    s_.timeSyncData.device_time_stamp          = t + 200;
+                    s_.timeSyncData.system_response_time_stamp = t + 400;
+                },
+                [](const LSLTypes::timeSync& a_, const LSLTypes::timeSync& b_)
+                {
+                    return a_.remote_system_time_stamp == b_.remote_system_time_stamp && a_.local_system_time_stamp == b_.local_system_time_stamp &&
+                           a_.timeSyncData.device_time_stamp == b_.timeSyncData.device_time_stamp &&
+                           a_.timeSyncData.system_response_time_stamp == b_.timeSyncData.system_response_time_stamp;
+                });
+            checkBlockRoundTrip<LSLTypes::positioning>(n, [&](LSLTypes::positioning& s_, const size_t i_)
+                {
+                    stamp(s_, i_);
+                    s_.positioningData.left_eye.user_position.x = 0.25f + static_cast<float>(i_) * 0.001f;
+                },
+                [](const LSLTypes::positioning& a_, const LSLTypes::positioning& b_)
+                {
+                    return a_.remote_system_time_stamp == b_.remote_system_time_stamp && a_.local_system_time_stamp == b_.local_system_time_stamp &&
+                           a_.positioningData.left_eye.user_position.x == b_.positioningData.left_eye.user_position.x;
+                });
+        }
+    }
+
+
+    // Recording
+    void testRecording()
+    {
+        TempDir dir;
+
+        // empty recording
+        {
+            const auto file = dir.path / "empty.rec";
+            {
+                Recording::Writer<LSLTypes::extSignal> w(file);
+            }
+            Recording::Reader<LSLTypes::extSignal> r(file);
+            CHECK(r.size() == 0);
+            CHECK(r.getNumBlocks() == 0);
+            CHECK(r.readTimeRange().empty());
+            CHECK(r.readTimeRange(0, 100).empty());
+        }
+
+        // single sample
+        {
+            const auto file = dir.path / "single.rec";
+            const std::vector<int64_t> t = {1234};
+            const auto in = makeSamples(t);
+            {
+                Recording::Writer<LSLTypes::extSignal> w(file);
+                w.append(in);
+                CHECK(w.size() == 1);
+            }
+            Recording::Reader<LSLTypes::extSignal> r(file);
+            CHECK(r.size() == 1);
+            CHECK(sameSamples(r.readTimeRange(), in));
+            CHECK(sameSamples(r.readTimeRange(1234, 1234, false), in));
+            CHECK(r.readTimeRange(1235, std::nullopt, false).empty());
+            CHECK(r.readTimeRange(std::nullopt, 1233, false).empty());
+            CHECK(sameSamples(r.readTimeRange(localOf(1234), localOf(1234), true), in));
+        }
+
+        // index entry of a block that extends past the index, also if its end wraps around
+        {
+            const auto file = dir.path / "corrupt.rec";
+            {
+                Recording::Writer<LSLTypes::extSignal> w(file);
+                w.append(makeSamples(std::vector<int64_t>{1, 2, 3}));
+            }
+            for (const auto offset : {uint64_t{1} << 20, std::numeric_limits<uint64_t>::max() - 8})
+            {
+                std::fstream f(file, std::ios::binary | std::ios::in | std::ios::out);
+                uint64_t indexOffset = 0;
+                f.seekg(-32, std::ios::end);     // footer: index offset, number of blocks and samples, magic
+                f.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+                f.seekp(static_cast<std::streamoff>(indexOffset));
+                f.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+                f.close();
+
+                Recording::Reader<LSLTypes::extSignal> r(file);
+                bool refused = false;
+                try
+                {
+                    r.readBlock(0);
+                }
+                catch (const std::string&)
+                {
+                    refused = true;
+                }
+                CHECK(refused);
+            }
+        }
+
+        // many blocks, timestamps that step back, appended in batches that do not line up with blocks
+        {
+            const auto file = dir.path / "many.rec";
+            std::mt19937 rng(3);
+            int64_t t = 1000;
+            const auto times = makeTimes(rng, 1000, t);
+            const auto in    = makeSamples(times);
+            {
+                Recording::Writer<LSLTypes::extSignal> w(file, 64);
+                for (size_t i = 0; i < in.size();)
+                {
+                    const auto n = std::min<size_t>(1 + rng() % 150, in.size() - i);
+                    w.append(std::span(in).subspan(i, n));
+                    i += n;
+                }
+                w.close();
+                w.close();      // NB: closing again must be harmless
+            }
+            Recording::Reader<LSLTypes::extSignal> r(file);
+            CHECK(r.size() == in.size());
+            CHECK(r.getNumBlocks() == (in.size() + 63) / 64);
+            CHECK(sameSamples(r.readTimeRange(), in));
+
+            std::vector<LSLTypes::extSignal> blocks;
+            for (size_t b = 0; b < r.getNumBlocks(); b++)
+            {
+                const auto s = r.readBlock(b);
+                blocks.insert(blocks.end(), s.begin(), s.end());
+            }
+            CHECK(sameSamples(blocks, in));
+
+            bool allOk = true;
+            for (int q = 0; q < 200; q++)
+            {
+                auto t0 = static_cast<int64_t>(rng() % (t + 100)) - 50;
+                auto t1 = t0 + static_cast<int64_t>(rng() % 200);
+                for (const auto clock : {TimeClock::Remote, TimeClock::Local})
+                {
+                    if (clock == TimeClock::Local)
+                        std::tie(t0, t1) = std::pair(localOf(t1), localOf(t0));
+                    std::vector<LSLTypes::extSignal> expected;
+                    std::ranges::copy_if(in, std::back_inserter(expected), [&](const LSLTypes::extSignal& s_) { const auto ts = LSLTypes::getTimeStamp(s_, clock); return ts >= t0 && ts <= t1; });
+                    allOk = allOk && sameSamples(r.readTimeRange(t0, t1, clock == TimeClock::Local), expected);
+                }
+            }
+            CHECK(allOk);
+
+            // free function
+            CHECK(sameSamples(Recording::readTimeRange<LSLTypes::extSignal>(file), in));
+        }
+    }
+
+
+    // XdfChunks
+    void testXdfChunks()
+    {
+        using namespace XdfChunks;
+        const std::vector<std::pair<uint64_t, std::string>> cases = {
+            {0,                     std::string("\x01\x00", 2)},
+            {255,                   std::string("\x01\xFF", 2)},
+            {256,                   std::string("\x04\x00\x01\x00\x00", 5)},
+            {0xFFFF'FFFF,           std::string("\x04\xFF\xFF\xFF\xFF", 5)},
+            {0x1'0000'0000,         std::string("\x08\x00\x00\x00\x00\x01\x00\x00\x00", 9)},
+        };
+        for (const auto& [v, expected] : cases)
+        {
+            std::string buf;
+            putVarLen(buf, v);
+            CHECK(buf == expected);
+        }
+
+        // length counts the tag, not the length field itself
+        const auto chunk = makeChunk(Tag::FileHeader, "abc");
+        CHECK(chunk == std::string("\x01\x05\x01\x00" "abc", 7));
+        CHECK(makeChunk(Tag::Boundary, "") == std::string("\x01\x02\x05\x00", 4));
+
+        // stream chunks start with the stream id
+        const auto stream = makeStreamChunk(Tag::Samples, 0x04030201, "xy");
+        CHECK(stream == std::string("\x01\x08\x03\x00\x01\x02\x03\x04" "xy", 10));
+
+        // content that needs a 4 byte length
+        const std::string big(300, 'z');
+        const auto bigChunk = makeChunk(Tag::StreamHeader, big);
+        CHECK(bigChunk.size() == 5 + 2 + big.size());
+        CHECK(bigChunk.substr(0, 7) == std::string("\x04\x2E\x01\x00\x00\x02\x00", 7));
+    }
+
+
+    // TimeIndex
+    void testTimeIndex()
+    {
+        // runs start where a timestamp decreases, equal timestamps do not start one
+        {
+            const auto in     = makeSamples(std::vector<int64_t>{5, 5, 6, 3, 3, 4, 1, 10});
+            const auto runs   = TimeIndex::makeIndex<LSLTypes::extSignal>(in);
+            const auto starts = [](const std::vector<TimeIndex::Run>& runs_)
+            {
+                std::vector<size_t> out;
+                for (const auto& r : runs_)
+                    out.push_back(r.start);
+                return out;
+            };
+            CHECK(starts(runs[TimeClock::Remote]) == (std::vector<size_t>{0, 3, 6}));
+            CHECK(starts(runs[TimeClock::Local]) == (std::vector<size_t>{0, 2, 5, 7}));
+            CHECK(starts(runs[TimeClock::Device]) == (std::vector<size_t>{0, 3, 6}));
+            // bounds: largest timestamp up to a run, smallest from it on
+            CHECK(runs[TimeClock::Remote] == (std::vector<TimeIndex::Run>{{0, 6, 1}, {3, 6, 1}, {6, 10, 1}}));
+        }
+        // sorted timestamps need no runs
+        {
+            const auto runs = TimeIndex::makeIndex<LSLTypes::extSignal>(makeSamples(std::vector<int64_t>{1, 2, 2, 7}));
+            CHECK(runs[TimeClock::Remote].empty());
+        }
+        // empty and single sample
+        {
+            const auto none = TimeIndex::makeIndex<LSLTypes::extSignal>({});
+            const auto one  = TimeIndex::makeIndex<LSLTypes::extSignal>(makeSamples(std::vector<int64_t>{7}));
+            CHECK(std::ranges::all_of(none, [](const auto& r_) { return r_.empty(); }));
+            CHECK(std::ranges::all_of(one,  [](const auto& r_) { return r_.empty(); }));
+            auto getTime = [](size_t) -> int64_t { return 0; };
+            CHECK(TimeIndex::firstAtOrAfter(0, std::span<const TimeIndex::Run>(), getTime, 5) == 0);
+            CHECK(TimeIndex::pastLastAtOrBefore(0, std::span<const TimeIndex::Run>(), getTime, 5) == 0);
+        }
+        // incremental indexing matches indexing all at once
+        {
+            std::mt19937 rng(4);
+            int64_t t = 1000;
+            const auto in = makeSamples(makeTimes(rng, 500, t));
+            TimeIndex::runs_t runs;
+            size_t numIndexed = 0;
+            for (size_t n = 0; n < in.size(); n += 1 + rng() % 40)
+                TimeIndex::indexAppended<LSLTypes::extSignal>(std::span(in).first(n), runs, numIndexed);
+            TimeIndex::indexAppended<LSLTypes::extSignal>(in, runs, numIndexed);
+            CHECK(numIndexed == in.size());
+            CHECK(runs == TimeIndex::makeIndex<LSLTypes::extSignal>(in));
+        }
+        // searches and erases, against a linear scan
+        {
+            std::mt19937 rng(5);
+            int64_t t = 1000;
+            auto in = makeSamples(makeTimes(rng, 2000, t));
+            TimeIndex::runs_t runs;
+            size_t numIndexed = 0;
+            TimeIndex::indexAppended<LSLTypes::extSignal>(in, runs, numIndexed);
+            bool allOk = true;
+            for (int round = 0; round < 30 && !in.empty(); round++)
+            {
+                for (int q = 0; q < 50; q++)
+                    for (const auto clock : {TimeClock::Remote, TimeClock::Local, TimeClock::Device})
+                    {
+                        const auto tq = LSLTypes::getTimeStamp(in[rng() % in.size()], clock) + static_cast<int64_t>(rng() % 5) - 2;
+                        auto getTime  = [&](const size_t i_) { return LSLTypes::getTimeStamp(in[i_], clock); };
+                        allOk = allOk && TimeIndex::firstAtOrAfter(in.size(), runs[clock], getTime, tq) == firstAtOrAfterScan<LSLTypes::extSignal>(in, tq, clock);
+                        allOk = allOk && TimeIndex::pastLastAtOrBefore(in.size(), runs[clock], getTime, tq) == pastLastAtOrBeforeScan<LSLTypes::extSignal>(in, tq, clock);
+                    }
+
+                // erase from the front, the back or the middle (joining two samples)
+                const auto start = round % 3 == 0 ? 0 : rng() % in.size();
+                const auto end   = round % 3 == 1 ? in.size() + 10 : std::min(in.size(), start + rng() % 100);
+                in.erase(in.begin() + start, in.begin() + std::min(end, in.size()));
+                TimeIndex::indexErased<LSLTypes::extSignal>(in, runs, numIndexed, start, end);
+                allOk = allOk && numIndexed == in.size();
+                // the index is exact, runs do not pile up at joins
+                allOk = allOk && runs == TimeIndex::makeIndex<LSLTypes::extSignal>(in);
+            }
+            CHECK(allOk);
+        }
+    }
+
+
+    // older tiers
+    template <typename Store>
+    void checkStore(Store& store_)
+    {
+        using T = LSLTypes::extSignal;
+
+        // empty
+        CHECK(store_.size() == 0);
+        CHECK(store_.read(0, 10).empty());
+        for (const auto clock : {TimeClock::Remote, TimeClock::Local})
+        {
+            CHECK(store_.firstAtOrAfter(5, clock) == 0);
+            CHECK(store_.pastLastAtOrBefore(5, clock) == 0);
+        }
+        store_.erase(0, 10);
+        CHECK(store_.append(std::span<const T>()));
+        CHECK(store_.size() == 0);
+
+        // single sample
+        const auto one = makeSamples(std::vector<int64_t>{100});
+        CHECK(store_.append(one));
+        CHECK(store_.size() == 1);
+        CHECK(sameSamples(store_.read(0, 1), one));
+        CHECK(store_.firstAtOrAfter(100, TimeClock::Remote) == 0);
+        CHECK(store_.firstAtOrAfter(101, TimeClock::Remote) == 1);
+        CHECK(store_.pastLastAtOrBefore(99, TimeClock::Remote) == 0);
+        CHECK(store_.pastLastAtOrBefore(100, TimeClock::Remote) == 1);
+        CHECK(store_.minTimeStamp(TimeClock::Local) == localOf(100));
+        CHECK(store_.maxTimeStamp(TimeClock::Device) == 1'000'100);
+        store_.erase(0, 1);
+        CHECK(store_.size() == 0);
+
+        // batches that step back in time, erases within and across parts, against a reference
+        std::mt19937 rng(6);
+        std::vector<T> ref;
+        int64_t t = 1000;
+        bool allOk = true;
+        for (int b = 0; b < 60; b++)
+        {
+            const auto batch = makeSamples(makeTimes(rng, 1 + rng() % 30, t));
+            allOk = allOk && store_.append(batch);
+            ref.insert(ref.end(), batch.begin(), batch.end());
+            if (b % 5 == 4)
+            {
+                const auto start = rng() % ref.size();
+                const auto end   = std::min(ref.size(), start + rng() % 60);
+                store_.erase(start, end);
+                ref.erase(ref.begin() + start, ref.begin() + end);
+            }
+            if (ref.empty())
+                continue;
+
+            allOk = allOk && store_.size() == ref.size();
+            for (int q = 0; q < 20; q++)
+                for (const auto clock : {TimeClock::Remote, TimeClock::Local, TimeClock::Device})
+                {
+                    const auto tq = LSLTypes::getTimeStamp(ref[rng() % ref.size()], clock) + static_cast<int64_t>(rng() % 5) - 2;
+                    allOk = allOk && store_.firstAtOrAfter(tq, clock) == firstAtOrAfterScan<T>(ref, tq, clock);
+                    allOk = allOk && store_.pastLastAtOrBefore(tq, clock) == pastLastAtOrBeforeScan<T>(ref, tq, clock);
+                }
+            for (const auto clock : {TimeClock::Remote, TimeClock::Local, TimeClock::Device})
+            {
+                const auto [mn, mx] = std::ranges::minmax(ref | std::views::transform([clock](const T& s_) { return LSLTypes::getTimeStamp(s_, clock); }));
+                allOk = allOk && store_.minTimeStamp(clock) == mn && store_.maxTimeStamp(clock) == mx;
+            }
+            const auto start = rng() % ref.size();
+            const auto end   = start + rng() % 80;     // NB: may be past the end
+            allOk = allOk && sameSamples(store_.read(start, end), std::span(ref).subspan(start, std::min(end, ref.size()) - start));
+        }
+        CHECK(allOk);
+        CHECK(sameSamples(store_.read(0, store_.size()), ref));
+
+        // erase all but the first and last sample, across all parts
+        store_.erase(1, ref.size() - 1);
+        ref.erase(ref.begin() + 1, ref.end() - 1);
+        CHECK(sameSamples(store_.read(0, store_.size()), ref));
+        CHECK(store_.minTimeStamp(TimeClock::Remote) == std::min(ref[0].remote_system_time_stamp, ref[1].remote_system_time_stamp));
+
+        store_.clear();
+        CHECK(store_.size() == 0);
+        CHECK(store_.firstAtOrAfter(0, TimeClock::Remote) == 0);
+    }
+    void testCompressedStore()
+    {
+        CompressedStore<LSLTypes::extSignal> store(8);
+        checkStore(store);
+        CompressedStore<LSLTypes::extSignal> oneSamplePerBlock(1);
+        checkStore(oneSamplePerBlock);
+    }
+    void testSpillStore()
+    {
+        TempDir dir;
+        {
+            SpillStore<LSLTypes::extSignal> store(dir.path);
+            checkStore(store);
+        }
+        // segment files are removed with the store
+        CHECK(std::filesystem::is_empty(dir.path));
+
+        // erasing the samples holding a segment's extremes leaves the kept views with
+        // loose bounds, searches and extremes are still exact
+        {
+            SpillStore<LSLTypes::extSignal> store(dir.path);
+            const auto in = makeSamples(std::vector<int64_t>{10, 20, 30, 90, 5, 40, 50});
+            CHECK(store.append(in));
+            store.erase(3, 5);
+            CHECK(store.size() == 5);
+            CHECK(store.firstAtOrAfter(60, TimeClock::Remote) == 5);
+            CHECK(store.firstAtOrAfter(35, TimeClock::Remote) == 3);
+            CHECK(store.pastLastAtOrBefore(7, TimeClock::Remote) == 0);
+            CHECK(store.pastLastAtOrBefore(45, TimeClock::Remote) == 4);
+            CHECK(store.minTimeStamp(TimeClock::Remote) == 10);
+            CHECK(store.maxTimeStamp(TimeClock::Remote) == 50);
+            store.erase(0, 1);
+            CHECK(store.minTimeStamp(TimeClock::Remote) == 20);
+        }
+        CHECK(std::filesystem::is_empty(dir.path));
+    }
+
+
+    // InletRegistry
+    void testInletRegistry()
+    {
+        InletRegistry<int, 4> reg;
+        CHECK(reg.find(1) == nullptr);
+        CHECK(!reg.contains(1));
+        CHECK(reg.remove(1) == nullptr);
+        CHECK(reg.getAll().empty());
+        CHECK(reg.removeAll().empty());
+
+        CHECK(reg.insert(1, std::make_shared<int>(10)));
+        CHECK(!reg.insert(1, std::make_shared<int>(11)));      // duplicate is refused, first entry kept
+        CHECK(*reg.find(1) == 10);
+        CHECK(reg.insert(5, std::make_shared<int>(50)));       // same shard as 1
+        CHECK(reg.getAll().size() == 2);
+
+        // a removed entry stays alive for whoever holds it
+        const auto held = reg.find(1);
+        const auto removed = reg.remove(1);
+        CHECK(removed == held);
+        CHECK(!reg.contains(1));
+        CHECK(*held == 10);
+        CHECK(reg.contains(5));
+
+        // concurrent inserts, lookups and removes of disjoint ids
+        constexpr uint32_t numThreads = 8, numIds = 500;
+        std::vector<std::thread> threads;
+        std::atomic<int> errors = 0;
+        for (uint32_t th = 0; th < numThreads; th++)
+            threads.emplace_back([&, th]
+            {
+                for (uint32_t i = 0; i < numIds; i++)
+                {
+                    const auto id = 100 + th * numIds + i;
+                    if (!reg.insert(id, std::make_shared<int>(static_cast<int>(id))))
+                        errors++;
+                    const auto e = reg.find(id);
+                    if (!e || *e != static_cast<int>(id))
+                        errors++;
+                    if (i % 2 && reg.remove(id) == nullptr)
+                        errors++;
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+        CHECK(errors == 0);
+        CHECK(reg.getAll().size() == 1 + numThreads * numIds / 2);
+
+        const auto all = reg.removeAll();
+        CHECK(all.size() == 1 + numThreads * numIds / 2);
+        CHECK(reg.getAll().empty());
+        CHECK(!reg.contains(5));
+    }
+
+
+    const std::vector<std::pair<std::string_view, std::function<void()>>> tests = {
+        {"ints",            testInts},
+        {"bits",            testBits},
+        {"floats",          testFloats},
+        {"sampleColumns",   testSampleColumns},
+        {"recording",       testRecording},
+        {"xdfChunks",       testXdfChunks},
+        {"timeIndex",       testTimeIndex},
+        {"compressedStore", testCompressedStore},
+        {"spillStore",      testSpillStore},
+        {"inletRegistry",   testInletRegistry},
+    };
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const std::vector<std::string_view> selected(argv + 1, argv + argc);
+        int numTestsFailed = 0;
+        for (const auto& [name, test] : tests)
+        {
+            if (!selected.empty() && std::ranges::find(selected, name) == selected.end())
+                continue;
+            const auto before = numFailed;
+            test();
+            const auto ok = numFailed == before;
+            numTestsFailed += !ok;
+            std::cout << std::format("{:<16} {}", name, ok ? "ok" : "FAILED") << std::endl;
+        }
+        return numTestsFailed ? 1 : 0;
+    }
+    catch (const std::string& e)
+    {
+        std::cerr << "Error: " << e << std::endl;
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Error: Some exception occurred" << std::endl;
+        return 1;
+    }
+}
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw errMsg_;
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
@@ -0,0 +1,892 @@
+#include "tobii_research_mock/tobii_research_mock.h"
+
+#include <tobii_research.h>
+#include <tobii_research_eyetracker.h>
+#include <tobii_research_streams.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <numbers>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <ranges>
+
+
+namespace
+{
+    // the various data generators of an eye tracker. Gaze and eye openness
+    // share one, as do eye images and eye images as gif
+    enum class Generator
+    {
+        Gaze,
+        EyeImage,
+        ExtSignal,
+        TimeSync,
+        Positioning,
+        Count
+    };
+    // subscriber lists of an eye tracker
+    enum class Subscription
+    {
+        Gaze,
+        EyeOpenness,
+        EyeImage,
+        EyeImageGif,
+        ExtSignal,
+        TimeSync,
+        Positioning,
+        Count
+    };
+    constexpr Generator subscriptionToGenerator(const Subscription sub_)
+    {
+        switch (sub_)
+        {
+            case Subscription::Gaze:
+            case Subscription::EyeOpenness:
+                return Generator::Gaze;
+            case Subscription::EyeImage:
+            case Subscription::EyeImageGif:
+                return Generator::EyeImage;
+            case Subscription::ExtSignal:
+                return Generator::ExtSignal;
+            case Subscription::TimeSync:
+                return Generator::TimeSync;
+            case Subscription::Positioning:
+            default:
+                return Generator::Positioning;
+        }
+    }
+    constexpr TobiiMock::Stream subscriptionToStream(const Subscription sub_)
+    {
+        switch (sub_)
+        {
+            case Subscription::Gaze:
+                return TobiiMock::Stream::Gaze;
+            case Subscription::EyeOpenness:
+                return TobiiMock::Stream::EyeOpenness;
+            case Subscription::EyeImage:
+            case Subscription::EyeImageGif:
+                return TobiiMock::Stream::EyeImage;
+            case Subscription::ExtSignal:
+                return TobiiMock::Stream::ExtSignal;
+            case Subscription::TimeSync:
+                return TobiiMock::Stream::TimeSync;
+            case Subscription::Positioning:
+            default:
+                return TobiiMock::Stream::Positioning;
+        }
+    }
+    template <typename E>
+    constexpr size_t idx(const E e_) { return static_cast<size_t>(e_); }
+
+    // smallest valid gif (1x1 pixel), sent to eye image as gif subscribers
+    constexpr std::array<uint8_t, 43> mockGif = {
+        0x47, 0x49, 0x46, 0x38, 0x39, 0x61, 0x01, 0x00, 0x01, 0x00, 0x80, 0x00, 0x00, 0xFF, 0xFF,
+        0xFF, 0x00, 0x00, 0x00, 0x21, 0xF9, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00,
+        0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x02, 0x02, 0x44, 0x01, 0x00, 0x3B
+    };
+
+    int64_t getSystemTimestamp()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // sleep until given system timestamp. Sleeps in short slices so a stop
+    // request is noticed quickly, and spins for the last bit for accuracy
+    // at high sampling rates. Returns false if stopped
+    bool waitUntil(const int64_t deadline_, const std::atomic<bool>& stop_)
+    {
+        constexpr int64_t spinTime  = 200;      // us
+        constexpr int64_t maxSlice  = 10'000;   // us
+        while (!stop_.load(std::memory_order_relaxed))
+        {
+            const auto remaining = deadline_ - getSystemTimestamp();
+            if (remaining <= 0)
+                return true;
+            if (remaining > spinTime)
+                std::this_thread::sleep_for(std::chrono::microseconds(std::min(remaining - spinTime, maxSlice)));
+            else
+                std::this_thread::yield();
+        }
+        return false;
+    }
+
+    char* allocString(const std::string& str_)
+    {
+        auto out = static_cast<char*>(std::malloc(str_.size() + 1));
+        std::memcpy(out, str_.c_str(), str_.size() + 1);
+        return out;
+    }
+
+    double getEnvOr(const char* name_, const double default_)
+    {
+        const char* val = std::getenv(name_);
+        if (!val || !*val)
+            return default_;
+        char* end;
+        const double out = std::strtod(val, &end);
+        return end == val ? default_ : out;
+    }
+
+    std::string serialFromAddress(const std::string& address_)
+    {
+        const auto pos = address_.find("://");
+        return pos == std::string::npos ? address_ : address_.substr(pos + 3);
+    }
+
+    TobiiMock::EyeTrackerConfig getDefaultConfig(std::string address_)
+    {
+        TobiiMock::EyeTrackerConfig config;
+        config.address                  = std::move(address_);
+        config.gaze.frequency           = static_cast<float>(getEnvOr("TOBII_MOCK_GAZE_FREQUENCY", config.gaze.frequency));
+        config.eyeOpenness.frequency    = config.gaze.frequency;
+        const auto jitter               = getEnvOr("TOBII_MOCK_JITTER", 0.);
+        const auto dropProbability      = getEnvOr("TOBII_MOCK_DROP_PROBABILITY", 0.);
+        for (auto* stream : {&config.gaze, &config.eyeOpenness, &config.eyeImage, &config.extSignal, &config.timeSync, &config.positioning})
+        {
+            stream->jitter              = jitter;
+            stream->drop.probability    = dropProbability;
+        }
+        return config;
+    }
+}
+
+// definition of the type that is opaque in the Tobii headers
+struct TobiiResearchEyeTracker
+{
+    struct Subscriber
+    {
+        void(*callback)();      // type-erased, cast back to the correct callback type when invoked
+        void* userData;
+    };
+    struct GeneratorState
+    {
+        std::mutex                          lifecycleMutex;     // serializes starting and stopping of the thread
+        std::thread                         thread;
+        std::shared_ptr<std::atomic<bool>>  shouldStop;         // per thread, so a stopping thread and its replacement don't interfere
+        std::mutex                          callbackMutex;      // held while delivering a sample, see unsubscribe()
+        std::vector<Subscriber>             deliveryList;       // reused copy of subscriber list, protected by callbackMutex
+    };
+    struct Counts
+    {
+        std::atomic<uint64_t>   generated = 0;
+        std::atomic<uint64_t>   delivered = 0;
+        std::atomic<uint64_t>   dropped   = 0;
+    };
+
+    TobiiResearchEyeTracker(TobiiMock::EyeTrackerConfig config_) : config(std::move(config_)) {}
+    ~TobiiResearchEyeTracker()
+    {
+        for (auto& gen : generators)
+            stopGenerator(gen);
+    }
+
+    TobiiMock::EyeTrackerConfig getConfig()
+    {
+        std::lock_guard l(mutex);
+        return config;
+    }
+    void setConfig(TobiiMock::EyeTrackerConfig config_)
+    {
+        std::lock_guard l(mutex);
+        config = std::move(config_);
+        ++configVersion;
+    }
+
+    template <typename CallbackType>
+    TobiiResearchStatus subscribe(const Subscription sub_, CallbackType callback_, void* userData_)
+    {
+        if (!callback_)
+            return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+
+        const auto gen = subscriptionToGenerator(sub_);
+        auto& state = generators[idx(gen)];
+        std::lock_guard l(state.lifecycleMutex);
+        {
+            std::lock_guard l2(mutex);
+            subscribers[idx(sub_)].push_back({reinterpret_cast<void(*)()>(callback_), userData_});
+        }
+        if (!state.thread.joinable())
+        {
+            state.shouldStop = std::make_shared<std::atomic<bool>>(false);
+            state.thread = std::thread(&TobiiResearchEyeTracker::runGenerator, this, gen, state.shouldStop);
+        }
+        return TOBII_RESEARCH_STATUS_OK;
+    }
+    template <typename CallbackType>
+    TobiiResearchStatus unsubscribe(const Subscription sub_, CallbackType callback_)
+    {
+        const auto gen = subscriptionToGenerator(sub_);
+        auto& state = generators[idx(gen)];
+        std::thread toStop;
+        {
+            std::lock_guard l(state.lifecycleMutex);
+            bool genHasSubscribers = false;
+            {
+                std::lock_guard l2(mutex);
+                std::erase_if(subscribers[idx(sub_)], [callback_](const Subscriber& s_) { return s_.callback == reinterpret_cast<void(*)()>(callback_); });
+                for (size_t s = 0; s < idx(Subscription::Count); s++)
+                    genHasSubscribers = genHasSubscribers || (subscriptionToGenerator(static_cast<Subscription>(s)) == gen && !subscribers[s].empty());
+            }
+            if (!genHasSubscribers && state.thread.joinable())
+            {
+                state.shouldStop->store(true);
+                toStop = std::move(state.thread);
+            }
+        }
+        // ensure callback is not invoked anymore once this function returns:
+        // wait for a delivery that may be in progress to finish. Not possible
+        // (and not needed) when called from a callback
+        const bool fromCallback = toStop.joinable() ? toStop.get_id() == std::this_thread::get_id() : isGeneratorThread(state);
+        if (toStop.joinable())
+        {
+            if (fromCallback)
+                toStop.detach();
+            else
+                toStop.join();
+        }
+        else if (!fromCallback)
+        {
+            std::lock_guard l(state.callbackMutex);
+        }
+        return TOBII_RESEARCH_STATUS_OK;
+    }
+    void unsubscribeAll()
+    {
+        for (auto& subs : subscribers)
+        {
+            std::lock_guard l(mutex);
+            subs.clear();
+        }
+        for (auto& gen : generators)
+            stopGenerator(gen);
+    }
+
+    void resetCounts()
+    {
+        for (auto& c : counts)
+        {
+            c.generated = 0;
+            c.delivered = 0;
+            c.dropped   = 0;
+        }
+    }
+
+
+    TobiiMock::EyeTrackerConfig                                     config;
+    std::atomic<uint32_t>                                           configVersion = 0;
+    std::mutex                                                      mutex;      // protects config and subscribers
+    std::array<std::vector<Subscriber>, idx(Subscription::Count)>   subscribers;
+    std::array<GeneratorState, idx(Generator::Count)>               generators;
+    std::array<Counts, idx(TobiiMock::Stream::Positioning) + 1>     counts;
+    std::atomic<bool>                                               discoverable = true;
+
+private:
+    static bool isGeneratorThread(GeneratorState& state_)
+    {
+        std::lock_guard l(state_.lifecycleMutex);
+        return state_.thread.joinable() && state_.thread.get_id() == std::this_thread::get_id();
+    }
+    void stopGenerator(GeneratorState& state_)
+    {
+        std::thread toStop;
+        {
+            std::lock_guard l(state_.lifecycleMutex);
+            if (!state_.thread.joinable())
+                return;
+            state_.shouldStop->store(true);
+            toStop = std::move(state_.thread);
+        }
+        if (toStop.get_id() == std::this_thread::get_id())
+            toStop.detach();
+        else
+            toStop.join();
+    }
+
+    static bool shouldDrop(const TobiiMock::DropPattern& drop_, const uint64_t sampleIdx_, std::mt19937_64& rng_)
+    {
+        if (drop_.period && sampleIdx_ % drop_.period < drop_.burstLength)
+            return true;
+        return drop_.probability > 0. && std::uniform_real_distribution<double>()(rng_) < drop_.probability;
+    }
+    static int64_t getNoise(const double sd_, std::mt19937_64& rng_)
+    {
+        return sd_ > 0. ? std::llround(std::normal_distribution<double>(0., sd_)(rng_)) : 0;
+    }
+
+    // deliver sample to the subscribers of the given list that are registered
+    // at the time of delivery
+    template <typename CallbackType, typename DataType>
+    void deliver(GeneratorState& state_, const Subscription sub_, DataType* data_)
+    {
+        {
+            std::lock_guard l(mutex);
+            state_.deliveryList = subscribers[idx(sub_)];
+        }
+        for (const auto& s : state_.deliveryList)
+            reinterpret_cast<CallbackType>(s.callback)(data_, s.userData);
+        if (!state_.deliveryList.empty())
+            counts[idx(subscriptionToStream(sub_))].delivered++;
+    }
+
+    void runGenerator(const Generator gen_, std::shared_ptr<std::atomic<bool>> shouldStop_)
+    {
+        auto& state = generators[idx(gen_)];
+        const auto& stop = *shouldStop_;
+
+        TobiiMock::EyeTrackerConfig cfg;
+        uint32_t cfgVersion = 0;
+        std::mt19937_64 rng;
+        const TobiiMock::StreamConfig* streamCfg = nullptr;
+        int64_t t0 = 0;
+        uint64_t sampleIdx = 0;
+        std::vector<uint8_t> eyeImageBuffer;
+        uint32_t extSignalValue = 0;
+
+        auto loadConfig = [&](const int64_t start_)
+        {
+            {
+                std::lock_guard l(mutex);
+                cfg = config;
+                cfgVersion = configVersion;
+            }
+            rng.seed(cfg.seed * idx(Generator::Count) + idx(gen_));
+            switch (gen_)
+            {
+                case Generator::Gaze:           streamCfg = &cfg.gaze;          break;
+                case Generator::EyeImage:       streamCfg = &cfg.eyeImage;      break;
+                case Generator::ExtSignal:      streamCfg = &cfg.extSignal;     break;
+                case Generator::TimeSync:       streamCfg = &cfg.timeSync;      break;
+                case Generator::Positioning:    streamCfg = &cfg.positioning;   break;
+                default: break;
+            }
+            t0 = start_;
+            sampleIdx = 0;
+            if (gen_ == Generator::EyeImage)
+                eyeImageBuffer.resize(static_cast<size_t>(std::max(cfg.eyeImageWidth, 0)) * std::max(cfg.eyeImageHeight, 0));
+        };
+        loadConfig(getSystemTimestamp());
+
+        if (gen_ == Generator::ExtSignal && !stop)
+        {
+            // as with real hardware, subscribers first receive the current value
+            std::lock_guard l(state.callbackMutex);
+            const auto ts = getSystemTimestamp();
+            TobiiResearchExternalSignalData sample;
+            sample.system_time_stamp    = ts;
+            sample.device_time_stamp    = ts + cfg.deviceClockOffset;
+            sample.value                = extSignalValue;
+            sample.change_type          = TOBII_RESEARCH_EXTERNAL_SIGNAL_INITIAL_VALUE;
+            counts[idx(TobiiMock::Stream::ExtSignal)].generated++;
+            deliver<tobii_research_external_signal_callback>(state, Subscription::ExtSignal, &sample);
+        }
+
+        while (!stop)
+        {
+            if (configVersion != cfgVersion)
+                loadConfig(getSystemTimestamp());
+            if (streamCfg->frequency <= 0.f)
+            {
+                // nothing to generate, idle until config changes or stopped
+                waitUntil(getSystemTimestamp() + 10'000, stop);
+                continue;
+            }
+
+            // nominal time of this sample, jitter and when to deliver it
+            const auto tick     = t0 + std::llround(static_cast<double>(sampleIdx) * 1'000'000. / streamCfg->frequency);
+            const auto noise    = getNoise(streamCfg->jitter, rng);
+            const auto sysTs    = tick + noise;
+            const auto deliverT = tick + std::llround(cfg.latency) + std::abs(noise);
+            const auto devTs    = tick + cfg.deviceClockOffset;
+            const auto t        = static_cast<double>(tick - t0) / 1'000'000.;
+            const auto thisIdx  = sampleIdx++;
+
+            if (!waitUntil(deliverT, stop))
+                break;
+            if (configVersion != cfgVersion)
+                // config changed while waiting, don't produce a sample with the old config
+                continue;
+
+            std::lock_guard l(state.callbackMutex);
+            switch (gen_)
+            {
+                case Generator::Gaze:
+                {
+                    counts[idx(TobiiMock::Stream::Gaze)].generated++;
+                    if (shouldDrop(cfg.gaze.drop, thisIdx, rng))
+                        counts[idx(TobiiMock::Stream::Gaze)].dropped++;
+                    else
+                    {
+                        // smooth Lissajous-like scanpath over a 527x296 mm display
+                        constexpr float displayW = 527.f, displayH = 296.f;
+                        const auto x = static_cast<float>(.5 + .3 * std::sin(2. * std::numbers::pi * .25 * t));
+                        const auto y = static_cast<float>(.5 + .25 * std::sin(2. * std::numbers::pi * .17 * t + 1.));
+                        const auto sway = static_cast<float>(10. * std::sin(2. * std::numbers::pi * .05 * t));
+                        const auto pupil = static_cast<float>(3. + .2 * std::sin(2. * std::numbers::pi * .1 * t));
+                        std::normal_distribution<float> gazeNoise(0.f, .002f);
+
+                        TobiiResearchGazeData sample;
+                        sample.device_time_stamp = devTs;
+                        sample.system_time_stamp = sysTs;
+                        for (const auto eye : {-1, 1})
+                        {
+                            auto& e = eye < 0 ? sample.left_eye : sample.right_eye;
+                            e.gaze_point.position_on_display_area.x         = x + gazeNoise(rng);
+                            e.gaze_point.position_on_display_area.y         = y + gazeNoise(rng);
+                            e.gaze_point.position_in_user_coordinates.x     = (e.gaze_point.position_on_display_area.x - .5f) * displayW;
+                            e.gaze_point.position_in_user_coordinates.y     = (.5f - e.gaze_point.position_on_display_area.y) * displayH + displayH / 2.f;
+                            e.gaze_point.position_in_user_coordinates.z     = 0.f;
+                            e.gaze_point.validity                           = TOBII_RESEARCH_VALIDITY_VALID;
+                            e.pupil_data.diameter                           = pupil + gazeNoise(rng);
+                            e.pupil_data.validity                           = TOBII_RESEARCH_VALIDITY_VALID;
+                            e.gaze_origin.position_in_user_coordinates.x    = static_cast<float>(eye) * 31.f + sway;
+                            e.gaze_origin.position_in_user_coordinates.y    = 0.f;
+                            e.gaze_origin.position_in_user_coordinates.z    = 650.f;
+                            e.gaze_origin.position_in_track_box_coordinates.x = .5f - e.gaze_origin.position_in_user_coordinates.x / 400.f;
+                            e.gaze_origin.position_in_track_box_coordinates.y = .5f;
+                            e.gaze_origin.position_in_track_box_coordinates.z = .5f;
+                            e.gaze_origin.validity                          = TOBII_RESEARCH_VALIDITY_VALID;
+                        }
+                        deliver<tobii_research_gaze_data_callback>(state, Subscription::Gaze, &sample);
+                    }
+
+                    // eye openness for the same instant
+                    counts[idx(TobiiMock::Stream::EyeOpenness)].generated++;
+                    if (shouldDrop(cfg.eyeOpenness.drop, thisIdx, rng))
+                        counts[idx(TobiiMock::Stream::EyeOpenness)].dropped++;
+                    else
+                    {
+                        std::normal_distribution<float> opennessNoise(11.f, .1f);
+                        TobiiResearchEyeOpennessData sample;
+                        sample.device_time_stamp        = devTs;
+                        sample.system_time_stamp        = sysTs;
+                        sample.left_eye_openness_value  = opennessNoise(rng);
+                        sample.left_eye_validity        = TOBII_RESEARCH_VALIDITY_VALID;
+                        sample.right_eye_openness_value = opennessNoise(rng);
+                        sample.right_eye_validity       = TOBII_RESEARCH_VALIDITY_VALID;
+                        deliver<tobii_research_eye_openness_data_callback>(state, Subscription::EyeOpenness, &sample);
+                    }
+                    break;
+                }
+                case Generator::EyeImage:
+                {
+                    counts[idx(TobiiMock::Stream::EyeImage)].generated++;
+                    if (shouldDrop(cfg.eyeImage.drop, thisIdx, rng))
+                    {
+                        counts[idx(TobiiMock::Stream::EyeImage)].dropped++;
+                        break;
+                    }
+                    // moving gradient
+                    for (int r = 0; r < cfg.eyeImageHeight; r++)
+                        for (int c = 0; c < cfg.eyeImageWidth; c++)
+                            eyeImageBuffer[static_cast<size_t>(r) * cfg.eyeImageWidth + c] = static_cast<uint8_t>(r + c + thisIdx);
+
+                    TobiiResearchEyeImage sample;
+                    sample.device_time_stamp    = devTs;
+                    sample.system_time_stamp    = sysTs;
+                    sample.bits_per_pixel       = 8;
+                    sample.padding_per_pixel    = 0;
+                    sample.width                = cfg.eyeImageWidth;
+                    sample.height               = cfg.eyeImageHeight;
+                    sample.type                 = TOBII_RESEARCH_EYE_IMAGE_TYPE_CROPPED;
+                    sample.camera_id            = static_cast<int>(thisIdx % 2);
+                    sample.data_size            = eyeImageBuffer.size();
+                    sample.data                 = eyeImageBuffer.data();
+                    deliver<tobii_research_eye_image_callback>(state, Subscription::EyeImage, &sample);
+
+                    TobiiResearchEyeImageGif gif;
+                    gif.device_time_stamp       = devTs;
+                    gif.system_time_stamp       = sysTs;
+                    gif.type                    = TOBII_RESEARCH_EYE_IMAGE_TYPE_CROPPED;
+                    gif.camera_id               = sample.camera_id;
+                    gif.image_size              = mockGif.size();
+                    gif.image_data              = const_cast<uint8_t*>(mockGif.data());
+                    deliver<tobii_research_eye_image_as_gif_callback>(state, Subscription::EyeImageGif, &gif);
+                    break;
+                }
+                case Generator::ExtSignal:
+                {
+                    counts[idx(TobiiMock::Stream::ExtSignal)].generated++;
+                    extSignalValue ^= 1u;
+                    if (shouldDrop(cfg.extSignal.drop, thisIdx, rng))
+                    {
+                        counts[idx(TobiiMock::Stream::ExtSignal)].dropped++;
+                        break;
+                    }
+                    TobiiResearchExternalSignalData sample;
+                    sample.device_time_stamp    = devTs;
+                    sample.system_time_stamp    = sysTs;
+                    sample.value                = extSignalValue;
+                    sample.change_type          = TOBII_RESEARCH_EXTERNAL_SIGNAL_VALUE_CHANGED;
+                    deliver<tobii_research_external_signal_callback>(state, Subscription::ExtSignal, &sample);
+                    break;
+                }
+                case Generator::TimeSync:
+                {
+                    counts[idx(TobiiMock::Stream::TimeSync)].generated++;
+                    if (shouldDrop(cfg.timeSync.drop, thisIdx, rng))
+                    {
+                        counts[idx(TobiiMock::Stream::TimeSync)].dropped++;
+                        break;
+                    }
+                    // request was sent one round trip before the nominal (response) time
+                    const auto rtt = std::llround(cfg.timeSyncRoundTrip) + std::abs(getNoise(cfg.timeSync.jitter, rng));
+                    TobiiResearchTimeSynchronizationData sample;
+                    sample.system_request_time_stamp    = sysTs - rtt;
+                    sample.device_time_stamp            = sysTs - rtt / 2 + cfg.deviceClockOffset;
+                    sample.system_response_time_stamp   = sysTs;
+                    deliver<tobii_research_time_synchronization_data_callback>(state, Subscription::TimeSync, &sample);
+                    break;
+                }
+                case Generator::Positioning:
+                {
+                    counts[idx(TobiiMock::Stream::Positioning)].generated++;
+                    if (shouldDrop(cfg.positioning.drop, thisIdx, rng))
+                    {
+                        counts[idx(TobiiMock::Stream::Positioning)].dropped++;
+                        break;
+                    }
+                    const auto sway = static_cast<float>(.02 * std::sin(2. * std::numbers::pi * .05 * t));
+                    TobiiResearchUserPositionGuide sample;
+                    sample.left_eye.user_position   = {.45f + sway, .5f, .5f};
+                    sample.left_eye.validity        = TOBII_RESEARCH_VALIDITY_VALID;
+                    sample.right_eye.user_position  = {.55f + sway, .5f, .5f};
+                    sample.right_eye.validity       = TOBII_RESEARCH_VALIDITY_VALID;
+                    deliver<tobii_research_user_position_guide_callback>(state, Subscription::Positioning, &sample);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+};
+
+namespace
+{
+    // all known eye trackers. Eye trackers are never destroyed before program
+    // exit, so handles given out remain valid
+    class Registry
+    {
+    public:
+        Registry()
+        {
+            const auto nEyeTracker = static_cast<int>(getEnvOr("TOBII_MOCK_EYETRACKERS", 1.));
+            for (int i = 0; i < nEyeTracker; i++)
+                add(getDefaultConfig("tobii-prp://MOCK-" + std::to_string(i)));
+        }
+
+        TobiiResearchEyeTracker* add(TobiiMock::EyeTrackerConfig config_)
+        {
+            if (config_.serialNumber.empty())
+                config_.serialNumber = serialFromAddress(config_.address);
+            if (!config_.frequencies.empty() && std::ranges::find(config_.frequencies, config_.gaze.frequency) == config_.frequencies.end())
+                config_.frequencies.push_back(config_.gaze.frequency);
+            config_.eyeOpenness.frequency = config_.gaze.frequency;
+
+            std::lock_guard l(_mutex);
+            if (auto it = _eyeTrackers.find(config_.address); it != _eyeTrackers.end())
+            {
+                it->second->setConfig(std::move(config_));
+                it->second->discoverable = true;
+                return it->second.get();
+            }
+            auto address = config_.address;
+            return _eyeTrackers.emplace(std::move(address), std::make_unique<TobiiResearchEyeTracker>(std::move(config_))).first->second.get();
+        }
+        TobiiResearchEyeTracker* get(const std::string& address_, const bool create_)
+        {
+            {
+                std::lock_guard l(_mutex);
+                if (auto it = _eyeTrackers.find(address_); it != _eyeTrackers.end())
+                    return it->second.get();
+            }
+            return create_ ? add(getDefaultConfig(address_)) : nullptr;
+        }
+        std::vector<TobiiResearchEyeTracker*> getDiscoverable()
+        {
+            std::lock_guard l(_mutex);
+            std::vector<TobiiResearchEyeTracker*> out;
+            for (const auto& et : _eyeTrackers | std::views::values)
+                if (et->discoverable)
+                    out.push_back(et.get());
+            return out;
+        }
+        std::vector<TobiiResearchEyeTracker*> getAll()
+        {
+            std::lock_guard l(_mutex);
+            std::vector<TobiiResearchEyeTracker*> out;
+            for (const auto& et : _eyeTrackers | std::views::values)
+                out.push_back(et.get());
+            return out;
+        }
+
+    private:
+        std::mutex                                                          _mutex;
+        std::map<std::string, std::unique_ptr<TobiiResearchEyeTracker>>     _eyeTrackers;
+    };
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    TobiiResearchEyeTracker& getKnownEyeTracker(const std::string& address_)
+    {
+        auto* et = getRegistry().get(address_, true);
+        return *et;
+    }
+
+    template <typename Getter>
+    TobiiResearchStatus getString(TobiiResearchEyeTracker* eyetracker_, char** out_, Getter getter_)
+    {
+        if (!eyetracker_ || !out_)
+            return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+        std::lock_guard l(eyetracker_->mutex);
+        *out_ = allocString(getter_(eyetracker_->config));
+        return TOBII_RESEARCH_STATUS_OK;
+    }
+}
+
+
+//// mock configuration
+namespace TobiiMock
+{
+    std::string addEyeTracker(EyeTrackerConfig config_)
+    {
+        if (config_.address.empty())
+            config_.address = "tobii-prp://MOCK-" + std::to_string(getRegistry().getAll().size());
+        auto address = config_.address;
+        getRegistry().add(std::move(config_));
+        return address;
+    }
+    void removeEyeTracker(const std::string& address_)
+    {
+        if (auto* et = getRegistry().get(address_, false))
+        {
+            et->discoverable = false;
+            et->unsubscribeAll();
+        }
+    }
+    void removeAllEyeTrackers()
+    {
+        for (auto* et : getRegistry().getAll())
+        {
+            et->discoverable = false;
+            et->unsubscribeAll();
+        }
+    }
+    EyeTrackerConfig getEyeTrackerConfig(const std::string& address_)
+    {
+        return getKnownEyeTracker(address_).getConfig();
+    }
+
+    StreamCounts getStreamCounts(const std::string& address_, const Stream stream_)
+    {
+        const auto& c = getKnownEyeTracker(address_).counts[idx(stream_)];
+        return {c.generated, c.delivered, c.dropped};
+    }
+    void resetStreamCounts(const std::string& address_)
+    {
+        getKnownEyeTracker(address_).resetCounts();
+    }
+}
+
+
+//// core
+TobiiResearchStatus tobii_research_find_all_eyetrackers(TobiiResearchEyeTrackers** eyetrackers)
+{
+    if (!eyetrackers)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    const auto ets = getRegistry().getDiscoverable();
+    auto* out = new TobiiResearchEyeTrackers;
+    out->count = ets.size();
+    out->eyetrackers = new TobiiResearchEyeTracker*[std::max<size_t>(ets.size(), 1)];
+    std::ranges::copy(ets, out->eyetrackers);
+    *eyetrackers = out;
+    return TOBII_RESEARCH_STATUS_OK;
+}
+void tobii_research_free_eyetrackers(TobiiResearchEyeTrackers* eyetrackers)
+{
+    if (!eyetrackers)
+        return;
+    delete[] eyetrackers->eyetrackers;
+    delete eyetrackers;
+}
+TobiiResearchStatus tobii_research_get_eyetracker(const char* address, TobiiResearchEyeTracker** eyetracker)
+{
+    if (!address || !eyetracker)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    *eyetracker = getRegistry().get(address, true);
+    return TOBII_RESEARCH_STATUS_OK;
+}
+TobiiResearchStatus tobii_research_get_sdk_version(TobiiResearchSDKVersion* sdk_version)
+{
+    if (!sdk_version)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    sdk_version->major      = 0;
+    sdk_version->minor      = 0;
+    sdk_version->revision   = 0;
+    sdk_version->build      = 0;
+    return TOBII_RESEARCH_STATUS_OK;
+}
+TobiiResearchStatus tobii_research_get_system_time_stamp(int64_t* time_stamp_us)
+{
+    if (!time_stamp_us)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    *time_stamp_us = getSystemTimestamp();
+    return TOBII_RESEARCH_STATUS_OK;
+}
+void tobii_research_free_string(char* str)
+{
+    std::free(str);
+}
+
+
+//// eye tracker information and settings
+TobiiResearchStatus tobii_research_get_address(TobiiResearchEyeTracker* eyetracker, char** address)
+{
+    return getString(eyetracker, address, [](const auto& c_) { return c_.address; });
+}
+TobiiResearchStatus tobii_research_get_serial_number(TobiiResearchEyeTracker* eyetracker, char** serial_number)
+{
+    return getString(eyetracker, serial_number, [](const auto& c_) { return c_.serialNumber; });
+}
+TobiiResearchStatus tobii_research_get_device_name(TobiiResearchEyeTracker* eyetracker, char** device_name)
+{
+    return getString(eyetracker, device_name, [](const auto& c_) { return c_.deviceName; });
+}
+TobiiResearchStatus tobii_research_get_model(TobiiResearchEyeTracker* eyetracker, char** model)
+{
+    return getString(eyetracker, model, [](const auto& c_) { return c_.model; });
+}
+TobiiResearchStatus tobii_research_get_firmware_version(TobiiResearchEyeTracker* eyetracker, char** firmware_version)
+{
+    return getString(eyetracker, firmware_version, [](const auto& c_) { return c_.firmwareVersion; });
+}
+TobiiResearchStatus tobii_research_get_runtime_version(TobiiResearchEyeTracker* eyetracker, char** runtime_version)
+{
+    return getString(eyetracker, runtime_version, [](const auto& c_) { return c_.runtimeVersion; });
+}
+TobiiResearchStatus tobii_research_get_capabilities(TobiiResearchEyeTracker* eyetracker, TobiiResearchCapabilities* capabilities)
+{
+    if (!eyetracker || !capabilities)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    *capabilities = static_cast<TobiiResearchCapabilities>(
+        TOBII_RESEARCH_CAPABILITIES_HAS_GAZE_DATA |
+        TOBII_RESEARCH_CAPABILITIES_HAS_EYE_OPENNESS_DATA |
+        TOBII_RESEARCH_CAPABILITIES_HAS_EYE_IMAGES |
+        TOBII_RESEARCH_CAPABILITIES_HAS_EXTERNAL_SIGNAL);
+    return TOBII_RESEARCH_STATUS_OK;
+}
+TobiiResearchStatus tobii_research_get_all_gaze_output_frequencies(TobiiResearchEyeTracker* eyetracker, TobiiResearchGazeOutputFrequencies** frequencies)
+{
+    if (!eyetracker || !frequencies)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    std::lock_guard l(eyetracker->mutex);
+    const auto& freqs = eyetracker->config.frequencies;
+    auto* out = new TobiiResearchGazeOutputFrequencies;
+    out->frequency_count = freqs.size();
+    out->frequencies = new float[std::max<size_t>(freqs.size(), 1)];
+    std::ranges::copy(freqs, out->frequencies);
+    *frequencies = out;
+    return TOBII_RESEARCH_STATUS_OK;
+}
+void tobii_research_free_gaze_output_frequencies(TobiiResearchGazeOutputFrequencies* frequencies)
+{
+    if (!frequencies)
+        return;
+    delete[] frequencies->frequencies;
+    delete frequencies;
+}
+TobiiResearchStatus tobii_research_get_gaze_output_frequency(TobiiResearchEyeTracker* eyetracker, float* gaze_output_frequency)
+{
+    if (!eyetracker || !gaze_output_frequency)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    std::lock_guard l(eyetracker->mutex);
+    *gaze_output_frequency = eyetracker->config.gaze.frequency;
+    return TOBII_RESEARCH_STATUS_OK;
+}
+TobiiResearchStatus tobii_research_set_gaze_output_frequency(TobiiResearchEyeTracker* eyetracker, float gaze_output_frequency)
+{
+    if (!eyetracker)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    auto config = eyetracker->getConfig();
+    if (std::ranges::find(config.frequencies, gaze_output_frequency) == config.frequencies.end())
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    config.gaze.frequency           = gaze_output_frequency;
+    config.eyeOpenness.frequency    = gaze_output_frequency;
+    eyetracker->setConfig(std::move(config));
+    return TOBII_RESEARCH_STATUS_OK;
+}
+TobiiResearchStatus tobii_research_get_all_eye_tracking_modes(TobiiResearchEyeTracker* eyetracker, TobiiResearchEyeTrackingModes** eye_tracking_modes)
+{
+    if (!eyetracker || !eye_tracking_modes)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    std::lock_guard l(eyetracker->mutex);
+    const auto& modes = eyetracker->config.trackingModes;
+    auto* out = new TobiiResearchEyeTrackingModes;
+    out->mode_count = modes.size();
+    out->modes = new char*[std::max<size_t>(modes.size(), 1)];
+    for (size_t i = 0; i < modes.size(); i++)
+        out->modes[i] = allocString(modes[i]);
+    *eye_tracking_modes = out;
+    return TOBII_RESEARCH_STATUS_OK;
+}
+void tobii_research_free_eye_tracking_modes(TobiiResearchEyeTrackingModes* eye_tracking_modes)
+{
+    if (!eye_tracking_modes)
+        return;
+    for (size_t i = 0; i < eye_tracking_modes->mode_count; i++)
+        std::free(eye_tracking_modes->modes[i]);
+    delete[] eye_tracking_modes->modes;
+    delete eye_tracking_modes;
+}
+TobiiResearchStatus tobii_research_get_eye_tracking_mode(TobiiResearchEyeTracker* eyetracker, char** eye_tracking_mode)
+{
+    return getString(eyetracker, eye_tracking_mode, [](const auto& c_) { return c_.trackingMode; });
+}
+TobiiResearchStatus tobii_research_set_eye_tracking_mode(TobiiResearchEyeTracker* eyetracker, const char* eye_tracking_mode)
+{
+    if (!eyetracker || !eye_tracking_mode)
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    auto config = eyetracker->getConfig();
+    if (std::ranges::find(config.trackingModes, eye_tracking_mode) == config.trackingModes.end())
+        return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+    config.trackingMode = eye_tracking_mode;
+    eyetracker->setConfig(std::move(config));
+    return TOBII_RESEARCH_STATUS_OK;
+}
+
+
+//// streams
+#define MOCK_STREAM_FUNCTIONS(subscribeName, unsubscribeName, callbackType, subscription)           \
+    TobiiResearchStatus subscribeName(TobiiResearchEyeTracker* eyetracker, callbackType callback, void* user_data) \
+    {                                                                                               \
+        if (!eyetracker)                                                                            \
+            return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;                                      \
+        return eyetracker->subscribe(subscription, callback, user_data);                            \
+    }                                                                                               \
+    TobiiResearchStatus unsubscribeName(TobiiResearchEyeTracker* eyetracker, callbackType callback) \
+    {                                                                                               \
+        if (!eyetracker)                                                                            \
+            return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;                                      \
+        return eyetracker->unsubscribe(subscription, callback);                                     \
+    }
+
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_gaze_data,                tobii_research_unsubscribe_from_gaze_data,                  tobii_research_gaze_data_callback,                  Subscription::Gaze)
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_eye_openness,             tobii_research_unsubscribe_from_eye_openness,               tobii_research_eye_openness_data_callback,          Subscription::EyeOpenness)
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_eye_image,                tobii_research_unsubscribe_from_eye_image,                  tobii_research_eye_image_callback,                  Subscription::EyeImage)
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_eye_image_as_gif,         tobii_research_unsubscribe_from_eye_image_as_gif,           tobii_research_eye_image_as_gif_callback,           Subscription::EyeImageGif)
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_external_signal_data,     tobii_research_unsubscribe_from_external_signal_data,       tobii_research_external_signal_callback,            Subscription::ExtSignal)
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_time_synchronization_data,tobii_research_unsubscribe_from_time_synchronization_data,   tobii_research_time_synchronization_data_callback,  Subscription::TimeSync)
+MOCK_STREAM_FUNCTIONS(tobii_research_subscribe_to_user_position_guide,      tobii_research_unsubscribe_from_user_position_guide,        tobii_research_user_position_guide_callback,        Subscription::Positioning)
+#undef MOCK_STREAM_FUNCTIONS
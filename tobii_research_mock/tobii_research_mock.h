@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+
+// Mock of the Tobii Pro SDK, for running LSL_streamer without eye tracker
+// hardware (e.g. for throughput benchmarks and regression tests on build
+// servers). Link tobii_research_mock.cpp instead of the tobii_research library.
+// It implements the core, eye tracker information and stream subscription
+// functions of the SDK: every subscribed stream is served by a background
+// thread that generates synthetic data at the configured rate. Calibration,
+// license and other functionality that only has meaning with real hardware is
+// not provided.
+//
+// The mock's system clock is std::chrono::steady_clock, which is the clock
+// that LSL uses on all platforms, so LSL_streamer's clock check passes.
+//
+// Without any configuration, TOBII_MOCK_EYETRACKERS (default 1) eye trackers
+// with addresses tobii-prp://MOCK-<n> are available through
+// tobii_research_find_all_eyetrackers(), with the defaults below. The defaults
+// for gaze frequency, jitter and drop probability can be overridden with the
+// TOBII_MOCK_GAZE_FREQUENCY, TOBII_MOCK_JITTER and TOBII_MOCK_DROP_PROBABILITY
+// environment variables. tobii_research_get_eyetracker() creates an eye
+// tracker with the default configuration for addresses that are not known.
+namespace TobiiMock
+{
+    enum class Stream
+    {
+        Gaze,
+        EyeOpenness,
+        EyeImage,       // also counts eye images delivered as gif
+        ExtSignal,
+        TimeSync,
+        Positioning
+    };
+
+    struct DropPattern
+    {
+        double      probability     = 0.;   // probability that a sample is dropped at random
+        uint32_t    period          = 0;    // if non-zero, a burst of samples is dropped every period samples...
+        uint32_t    burstLength     = 1;    // ...of this length
+    };
+
+    struct StreamConfig
+    {
+        float       frequency       = 0.f;  // Hz. 0: no samples are generated
+        double      jitter          = 0.;   // standard deviation (us) of gaussian noise added to system timestamps and delivery times
+        DropPattern drop            = {};
+    };
+
+    struct EyeTrackerConfig
+    {
+        std::string address;                // e.g. tobii-prp://MOCK-0
+        std::string serialNumber;           // if empty, derived from address
+        std::string deviceName          = "Mock eye tracker";
+        std::string model               = "Mock";
+        std::string firmwareVersion     = "0.0.0";
+        std::string runtimeVersion      = "0.0.0";
+        std::vector<float> frequencies  = {60.f, 120.f, 250.f, 300.f, 600.f, 1200.f, 2400.f};
+        std::vector<std::string> trackingModes = {"Default"};
+        std::string trackingMode        = "Default";
+        uint64_t    seed                = 0;        // seed for random generation of data, jitter and drops
+
+        double      latency             = 0.;       // us between sample's system timestamp and its delivery
+        int64_t     deviceClockOffset   = 1'000'000'000;    // us, device clock = system clock + this offset
+
+        // gaze and eye openness are generated for the same instants (as with
+        // real hardware, they can be merged on device timestamp). Set the
+        // frequency of both with gaze.frequency, eyeOpenness.frequency is ignored
+        StreamConfig gaze               = {600.f};
+        StreamConfig eyeOpenness        = {600.f};
+        StreamConfig eyeImage           = {60.f};
+        int         eyeImageWidth       = 160;
+        int         eyeImageHeight      = 160;
+        StreamConfig extSignal          = {1.f};    // frequency of value changes, initial value is always sent on subscription
+        StreamConfig timeSync           = {1.f};
+        double      timeSyncRoundTrip   = 300.;     // us
+        StreamConfig positioning        = {60.f};
+    };
+
+    struct StreamCounts
+    {
+        uint64_t    generated   = 0;
+        uint64_t    delivered   = 0;    // number of samples handed to (each of the) subscriber(s)
+        uint64_t    dropped     = 0;
+    };
+
+    // Register an eye tracker. If one with the same address already exists,
+    // its configuration is replaced, which takes effect immediately for
+    // running streams. Returns the address
+    std::string         addEyeTracker(EyeTrackerConfig config_);
+    // Make eye tracker undiscoverable and stop its streams. Eye tracker
+    // handles stay valid, so this is safe to call while the eye tracker is in use
+    void                removeEyeTracker(const std::string& address_);
+    void                removeAllEyeTrackers();
+    EyeTrackerConfig    getEyeTrackerConfig(const std::string& address_);
+
+    StreamCounts        getStreamCounts(const std::string& address_, Stream stream_);
+    void                resetStreamCounts(const std::string& address_);
+}